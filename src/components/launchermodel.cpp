@@ -24,6 +24,7 @@
 
 #include "launcheritem.h"
 #include "launchermodel.h"
+#include "tracing.h"
 
 
 #define LAUNCHER_APPS_PATH "/usr/share/applications/"
@@ -112,6 +113,7 @@ LauncherModel::LauncherModel(InitializationMode, QObject *parent) :
 
 void LauncherModel::initialize()
 {
+    LIPSTICK_TRACE_SCOPE("launcher", "initialize");
     if (m_initialized)
         return;
     m_initialized = true;
@@ -155,6 +157,7 @@ LauncherModel::~LauncherModel()
 void LauncherModel::onFilesUpdated(const QStringList &added,
         const QStringList &modified, const QStringList &removed)
 {
+    LIPSTICK_TRACE_SCOPE("launcher", "onFilesUpdated");
     QStringList modifiedAndNeedUpdating = modified;
 
     // First, remove all removed launcher items before adding new ones
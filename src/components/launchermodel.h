@@ -144,6 +144,7 @@ private:
     bool m_initialized;
 
     friend class Ut_LauncherModel;
+    friend class Bench_Launcher;
 };
 
 #endif // LAUNCHERMODEL_H
@@ -12,10 +12,18 @@ PUBLICHEADERS += \
     $$PWD/lipstickkeymap.h \
     $$PWD/windowmodel.h \
     $$PWD/lipsticksurfaceinterface.h \
+    $$PWD/setupdatesenabledbatch.h \
 
 HEADERS += \
+    $$PWD/framestatistics.h \
+    $$PWD/keygrabtable.h \
+    $$PWD/orientationmonitor.h \
+    $$PWD/processterminator.h \
+    $$PWD/snapshotcapture.h \
+    $$PWD/snapshotstore.h \
     $$PWD/windowpixmapitem.h \
-    $$PWD/windowproperty.h
+    $$PWD/windowproperty.h \
+    $$PWD/windowpropertycache.h
 
 SOURCES += \
     $$PWD/lipstickcompositor.cpp \
@@ -23,7 +31,13 @@ SOURCES += \
     $$PWD/lipstickcompositorprocwindow.cpp \
     $$PWD/lipstickcompositoradaptor.cpp \
     $$PWD/fileserviceadaptor.cpp \
+    $$PWD/framestatistics.cpp \
     $$PWD/lipstickkeymap.cpp \
+    $$PWD/orientationmonitor.cpp \
+    $$PWD/processterminator.cpp \
+    $$PWD/setupdatesenabledbatch.cpp \
+    $$PWD/snapshotcapture.cpp \
+    $$PWD/snapshotstore.cpp \
     $$PWD/windowmodel.cpp \
     $$PWD/windowpixmapitem.cpp \
     $$PWD/windowproperty.cpp \
@@ -0,0 +1,106 @@
+/***************************************************************************
+**
+** Copyright (c) 2021 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#include "framestatistics.h"
+
+namespace {
+
+// The commit rate is measured over the last second
+const qint64 RateInterval = 1000000;
+
+}
+
+FrameStatistics::FrameStatistics()
+    : m_commitCount(0)
+    , m_pendingFrameCallbacks(0)
+    , m_bufferType(NoBuffer)
+{
+}
+
+void FrameStatistics::commit(qint64 time, qint64 damagedArea, const QSize &bufferSize, BufferType bufferType)
+{
+    Commit &commit = m_commits[m_commitCount % Capacity];
+    commit.time = time;
+    commit.damagedArea = damagedArea;
+    commit.frameCallbackLatency = -1;
+    ++m_commitCount;
+
+    m_bufferSize = bufferSize;
+    m_bufferType = bufferType;
+}
+
+void FrameStatistics::frameCallbacksSent(qint64 time)
+{
+    for (quint64 i = qMax(m_pendingFrameCallbacks, firstKept()); i < m_commitCount; ++i) {
+        Commit &commit = m_commits[i % Capacity];
+        commit.frameCallbackLatency = time - commit.time;
+    }
+    m_pendingFrameCallbacks = m_commitCount;
+}
+
+qreal FrameStatistics::commitRate(qint64 time) const
+{
+    const quint64 first = firstKept();
+
+    quint64 i = m_commitCount;
+    while (i > first && m_commits[(i - 1) % Capacity].time > time - RateInterval)
+        --i;
+
+    const quint64 count = m_commitCount - i;
+    if (i == first && count == quint64(Capacity)) {
+        // All kept commits are from the last second, the rate is higher than what fits
+        const qint64 interval = time - m_commits[first % Capacity].time;
+        return interval > 0 ? qreal(count) * RateInterval / interval : qreal(count);
+    }
+    return qreal(count);
+}
+
+qint64 FrameStatistics::averageDamagedArea() const
+{
+    const quint64 first = firstKept();
+    if (first == m_commitCount)
+        return 0;
+
+    qint64 damagedArea = 0;
+    for (quint64 i = first; i < m_commitCount; ++i)
+        damagedArea += m_commits[i % Capacity].damagedArea;
+    return damagedArea / qint64(m_commitCount - first);
+}
+
+qint64 FrameStatistics::averageFrameCallbackLatency() const
+{
+    qint64 latency = 0;
+    int count = 0;
+    for (quint64 i = firstKept(); i < m_commitCount; ++i) {
+        const Commit &commit = m_commits[i % Capacity];
+        if (commit.frameCallbackLatency >= 0) {
+            latency += commit.frameCallbackLatency;
+            ++count;
+        }
+    }
+    return count > 0 ? latency / count : -1;
+}
+
+qint64 FrameStatistics::maximumFrameCallbackLatency() const
+{
+    qint64 latency = -1;
+    for (quint64 i = firstKept(); i < m_commitCount; ++i)
+        latency = qMax(latency, m_commits[i % Capacity].frameCallbackLatency);
+    return latency;
+}
+
+quint64 FrameStatistics::firstKept() const
+{
+    return m_commitCount > quint64(Capacity) ? m_commitCount - Capacity : 0;
+}
@@ -0,0 +1,79 @@
+/***************************************************************************
+**
+** Copyright (c) 2021 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#ifndef FRAMESTATISTICS_H
+#define FRAMESTATISTICS_H
+
+#include <QSize>
+
+/*
+ * Keeps track of the frames committed by a client window.
+ *
+ * The most recent commits are kept in a fixed size ring buffer, so
+ * recording a commit neither allocates nor grows with the lifetime of the
+ * window. Rates and averages are computed from the kept commits only when
+ * they are read. Times are microseconds of a monotonic clock.
+ */
+class FrameStatistics
+{
+public:
+    enum BufferType {
+        NoBuffer,
+        ShmBuffer,
+        EglBuffer
+    };
+
+    // Number of the most recent commits kept
+    static const int Capacity = 128;
+
+    FrameStatistics();
+
+    //! Records a commit of a \a bufferSize buffer that damaged \a damagedArea pixels at \a time
+    void commit(qint64 time, qint64 damagedArea, const QSize &bufferSize, BufferType bufferType);
+    //! Records that the frame callbacks requested by the commits so far were sent at \a time
+    void frameCallbacksSent(qint64 time);
+
+    //! Returns the number of commits per second during the second before \a time
+    qreal commitRate(qint64 time) const;
+    //! Returns the average number of pixels damaged by the kept commits
+    qint64 averageDamagedArea() const;
+    //! Returns the average time from a kept commit until its frame callbacks were sent, -1 if unknown
+    qint64 averageFrameCallbackLatency() const;
+    //! Returns the longest time from a kept commit until its frame callbacks were sent, -1 if unknown
+    qint64 maximumFrameCallbackLatency() const;
+
+    quint64 commitCount() const { return m_commitCount; }
+    QSize bufferSize() const { return m_bufferSize; }
+    BufferType bufferType() const { return m_bufferType; }
+
+private:
+    struct Commit
+    {
+        qint64 time;
+        qint64 damagedArea;
+        // -1 until the frame callbacks have been sent
+        qint64 frameCallbackLatency;
+    };
+
+    quint64 firstKept() const;
+
+    Commit m_commits[Capacity];
+    quint64 m_commitCount;
+    // Index of the first commit whose frame callbacks have not been sent
+    quint64 m_pendingFrameCallbacks;
+    QSize m_bufferSize;
+    BufferType m_bufferType;
+};
+
+#endif // FRAMESTATISTICS_H
@@ -0,0 +1,133 @@
+/***************************************************************************
+**
+** Copyright (c) 2021 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#ifndef KEYGRABTABLE_H
+#define KEYGRABTABLE_H
+
+#include <QHash>
+#include <QList>
+#include <QVector>
+
+/*
+ * Maps key codes to the windows grabbing them.
+ *
+ * The window that most recently started grabbing keys takes precedence
+ * over the ones that were grabbing before it. A key release goes to the
+ * window that received the press, even if the grab has changed since.
+ */
+template <typename Window>
+class KeyGrabTable
+{
+public:
+    KeyGrabTable() : m_nextStamp(0) {}
+
+    //! Replaces the keys grabbed by \a window
+    void setGrabbedKeys(Window *window, const QList<int> &keys)
+    {
+        quint64 stamp = m_stamps.value(window, 0);
+        removeGrabs(window);
+        if (keys.isEmpty()) {
+            m_stamps.remove(window);
+            return;
+        }
+
+        if (stamp == 0) {
+            stamp = ++m_nextStamp;
+            m_stamps.insert(window, stamp);
+        }
+        foreach (int key, keys) {
+            QVector<Window *> &grabbers = m_grabbers[key];
+            if (grabbers.contains(window)) {
+                continue;
+            }
+
+            // Kept in precedence order, the most recent grabber first
+            int index = 0;
+            while (index < grabbers.count() && m_stamps.value(grabbers.at(index)) > stamp) {
+                ++index;
+            }
+            grabbers.insert(index, window);
+        }
+    }
+
+    //! Forgets \a window, including the keys it has received the press of
+    void removeWindow(Window *window)
+    {
+        removeGrabs(window);
+        m_stamps.remove(window);
+
+        typename QHash<int, Window *>::iterator it = m_pressed.begin();
+        while (it != m_pressed.end()) {
+            if (it.value() == window) {
+                it = m_pressed.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    //! Returns the window grabbing \a key, or null if there is none
+    Window *grabber(int key) const
+    {
+        typename QHash<int, QVector<Window *> >::const_iterator it = m_grabbers.constFind(key);
+        return it != m_grabbers.constEnd() ? it->first() : 0;
+    }
+
+    //! Returns the window receiving the press of \a key, or null if the key is not grabbed
+    Window *press(int key)
+    {
+        Window *window = grabber(key);
+        if (window) {
+            m_pressed.insert(key, window);
+        }
+        return window;
+    }
+
+    //! Returns the window receiving the release of \a key, or null if the key is not grabbed
+    Window *release(int key)
+    {
+        if (m_pressed.isEmpty()) {
+            return grabber(key);
+        }
+
+        Window *window = m_pressed.take(key);
+        return window ? window : grabber(key);
+    }
+
+    bool isEmpty() const
+    {
+        return m_grabbers.isEmpty() && m_pressed.isEmpty();
+    }
+
+private:
+    void removeGrabs(Window *window)
+    {
+        typename QHash<int, QVector<Window *> >::iterator it = m_grabbers.begin();
+        while (it != m_grabbers.end()) {
+            it->removeOne(window);
+            if (it->isEmpty()) {
+                it = m_grabbers.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    QHash<int, QVector<Window *> > m_grabbers;
+    QHash<int, Window *> m_pressed;
+    QHash<Window *, quint64> m_stamps;
+    quint64 m_nextStamp;
+};
+
+#endif // KEYGRABTABLE_H
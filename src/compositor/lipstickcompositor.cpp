@@ -16,7 +16,6 @@
 
 #include <QWaylandInputDevice>
 #include <QDesktopServices>
-#include <QtSensors/QOrientationSensor>
 #include <QClipboard>
 #include <QMimeData>
 #include <QtGui/qpa/qplatformnativeinterface.h>
@@ -25,8 +24,8 @@
 #include <QtGui/qpa/qplatformintegration.h>
 
 #include <qmcenameowner.h>
-#include <dbus/dbus-protocol.h>
 #include <sys/types.h>
+#include <time.h>
 #include <systemd/sd-bus.h>
 #include <systemd/sd-login.h>
 #include <unistd.h>
@@ -35,6 +34,11 @@
 #include "touchscreen/touchscreen.h"
 #include "windowmodel.h"
 #include "lipstickcompositorprocwindow.h"
+#include "keygrabtable.h"
+#include "windowpropertycache.h"
+#include "orientationmonitor.h"
+#include "processterminator.h"
+#include "snapshotstore.h"
 #include "lipstickcompositor.h"
 #include "lipstickcompositoradaptor.h"
 #include "fileserviceadaptor.h"
@@ -42,10 +46,42 @@
 #include "lipsticksettings.h"
 #include "lipstickrecorder.h"
 #include "alienmanager/alienmanager.h"
+#include "utilities/callercredentials.h"
 #include "logging.h"
+#include "tracing.h"
 
 LipstickCompositor *LipstickCompositor::m_instance = 0;
 
+// Milliseconds a new device orientation has to be reported before the screen follows it
+static const int DefaultOrientationSettleTime = 200;
+// Returns the single orientation the /lipstick/orientationLock setting pins the screen to,
+// or no orientation if the screen follows the device
+static Qt::ScreenOrientations lockedOrientations(const QString &orientationLock)
+{
+    if (orientationLock == QLatin1String("portrait"))
+        return Qt::PortraitOrientation;
+    else if (orientationLock == QLatin1String("portrait-inverted"))
+        return Qt::InvertedPortraitOrientation;
+    else if (orientationLock == QLatin1String("landscape"))
+        return Qt::LandscapeOrientation;
+    else if (orientationLock == QLatin1String("landscape-inverted"))
+        return Qt::InvertedLandscapeOrientation;
+    return 0;
+}
+
+// Seconds the display has to stay off before the scene graph resources are released
+static const int DefaultDisplayOffReleaseDelay = 30;
+
+// Returns whether windows are rendered by the threaded render loop, which is chosen
+// the same way as in QSGRenderLoop::instance()
+static bool usesThreadedRenderLoop()
+{
+    const QByteArray renderLoop = qgetenv("QSG_RENDER_LOOP");
+    if (!renderLoop.isEmpty())
+        return renderLoop == "threaded";
+    return QGuiApplicationPrivate::platformIntegration()->hasCapability(QPlatformIntegration::ThreadedOpenGL);
+}
+
 LipstickCompositor::LipstickCompositor()    
 #if QTCOMPOSITOR_VERSION >= QT_VERSION_CHECK(5, 6, 0)
     : QWaylandQuickCompositor(nullptr, (QWaylandCompositor::ExtensionFlags)QWaylandCompositor::DefaultExtensions & ~QWaylandCompositor::QtKeyExtension)
@@ -54,6 +90,7 @@ LipstickCompositor::LipstickCompositor()
     : QWaylandQuickCompositor(this, 0, (QWaylandCompositor::ExtensionFlags)QWaylandCompositor::DefaultExtensions & ~QWaylandCompositor::QtKeyExtension)
 #endif
     , m_totalWindowCount(0)
+    , m_windowProperties(new WindowPropertyCache<LipstickCompositorWindow>)
     , m_nextWindowId(1)
     , m_homeActive(true)
     , m_topmostWindowId(0)
@@ -61,12 +98,21 @@ LipstickCompositor::LipstickCompositor()
     , m_topmostWindowOrientation(Qt::PrimaryOrientation)
     , m_screenOrientation(Qt::PrimaryOrientation)
     , m_sensorOrientation(Qt::PrimaryOrientation)
+    , m_topmostWindowAllowedOrientations(0)
     , m_retainedSelection(0)
     , m_updatesEnabled(true)
     , m_completed(false)
     , m_onUpdatesDisabledUnfocusedWindowId(0)
+    , m_keyGrabs(new KeyGrabTable<LipstickCompositorWindow>)
     , m_keymap(0)
+    , m_keymapApplied(false)
+    , m_keymapUpdateTimerId(0)
     , m_fakeRepaintTimerId(0)
+    , m_displayOffReleaseDelay(DefaultDisplayOffReleaseDelay * 1000)
+    , m_displayOffReleaseTimerId(0)
+    , m_lowPowerMode(false)
+    , m_renderedFrames(0)
+    , m_renderStatisticsCpuTime(0)
     , m_queuedSetUpdatesEnabledCalls()
     , m_mceNameOwner(new QMceNameOwner(this))
     , m_sessionActivationTries(0)
@@ -80,20 +126,44 @@ LipstickCompositor::LipstickCompositor()
 
     m_orientationLock = new MGConfItem("/lipstick/orientationLock", this);
     connect(m_orientationLock, SIGNAL(valueChanged()), SIGNAL(orientationLockChanged()));
+    connect(m_orientationLock, &MGConfItem::valueChanged, this, &LipstickCompositor::updateSensorOrientations);
 
     connect(this, SIGNAL(visibleChanged(bool)), this, SLOT(onVisibleChanged(bool)));
     QObject::connect(this, SIGNAL(afterRendering()), this, SLOT(windowSwapped()));
     QObject::connect(HomeApplication::instance(), SIGNAL(aboutToDestroy()), this, SLOT(homeApplicationAboutToDestroy()));
     connect(this, &QQuickWindow::afterRendering, this, &LipstickCompositor::readContent, Qt::DirectConnection);
 
-    m_orientationSensor = new QOrientationSensor(this);
-    QObject::connect(m_orientationSensor, SIGNAL(readingChanged()), this, SLOT(setScreenOrientationFromSensor()));
-    if (!m_orientationSensor->connectToBackend()) {
-        qWarning() << "Could not connect to the orientation sensor backend";
-    } else {
-        if (!m_orientationSensor->start())
-            qWarning() << "Could not start the orientation sensor";
-    }
+    m_orientationMonitor = new OrientationMonitor(this);
+    m_processTerminator = new ProcessTerminator(this);
+    QObject::connect(m_orientationMonitor, SIGNAL(orientationChanged()), this, SLOT(setScreenOrientationFromSensor()));
+    updateSensorOrientations();
+    MGConfItem *orientationSettleTime = new MGConfItem("/lipstick/orientationSettleTime", this);
+    auto updateOrientationSettleTime = [this, orientationSettleTime]() {
+        m_orientationMonitor->setSettleTime(orientationSettleTime->value(DefaultOrientationSettleTime).toInt());
+    };
+    connect(orientationSettleTime, &MGConfItem::valueChanged, this, updateOrientationSettleTime);
+    updateOrientationSettleTime();
+
+    // GPU memory for the snapshots of closed windows, in megabytes
+    MGConfItem *snapshotMemoryBudget = new MGConfItem("/lipstick/snapshotMemoryBudget", this);
+    auto updateSnapshotMemoryBudget = [snapshotMemoryBudget]() {
+        const QVariant megabytes = snapshotMemoryBudget->value();
+        if (megabytes.isValid())
+            SnapshotStore::instance()->setBudget(qint64(megabytes.toInt()) * 1024 * 1024);
+    };
+    connect(snapshotMemoryBudget, &MGConfItem::valueChanged, this, updateSnapshotMemoryBudget);
+    updateSnapshotMemoryBudget();
+
+    // Seconds before the resources are released when the display is off, negative never releases them
+    MGConfItem *displayOffReleaseDelay = new MGConfItem("/lipstick/displayOffReleaseDelay", this);
+    auto updateDisplayOffReleaseDelay = [this, displayOffReleaseDelay]() {
+        const int seconds = displayOffReleaseDelay->value(DefaultDisplayOffReleaseDelay).toInt();
+        m_displayOffReleaseDelay = seconds >= 0 ? seconds * 1000 : -1;
+        if (!m_updatesEnabled)
+            startDisplayOffReleaseTimer();
+    };
+    connect(displayOffReleaseDelay, &MGConfItem::valueChanged, this, updateDisplayOffReleaseDelay);
+    updateDisplayOffReleaseDelay();
     emit HomeApplication::instance()->homeActiveChanged();
 
     QDesktopServices::setUrlHandler("http", this, "openUrl");
@@ -111,12 +181,24 @@ LipstickCompositor::LipstickCompositor()
     QObject::connect(m_mceNameOwner, &QMceNameOwner::nameOwnerChanged,
                      this, &LipstickCompositor::processQueuedSetUpdatesEnabledCalls);
 
+    connect(LipstickSettings::instance(), &LipstickSettings::lowPowerModeChanged,
+            this, &LipstickCompositor::updateLowPowerMode);
+    logRenderStatistics("normal");
+
     setUpdatesEnabledNow(false);
     QTimer::singleShot(0, this, SLOT(initialize()));
 
     setClientFullScreenHint(true);
 }
 
+static qint64 processCpuTime()
+{
+    struct timespec ts;
+    if (clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts) != 0)
+        return 0;
+    return qint64(ts.tv_sec) * 1000 + ts.tv_nsec / 1000000;
+}
+
 static inline bool displayStateIsDimmed(TouchScreen::DisplayState state)
 {
     return state == TouchScreen::DisplayDimmed;
@@ -133,6 +215,8 @@ LipstickCompositor::~LipstickCompositor()
     // are destroyed, so disconnect it.
     disconnect(this, SIGNAL(visibleChanged(bool)), this, SLOT(onVisibleChanged(bool)));
 
+    delete m_keyGrabs;
+    delete m_windowProperties;
     m_instance = nullptr;
 }
 
@@ -168,7 +252,7 @@ void LipstickCompositor::classBegin()
 void LipstickCompositor::onVisibleChanged(bool visible)
 {
     if (!visible) {
-        sendFrameCallbacks(surfaces());
+        sendFrameCallbacksIfAllowed();
     }
 }
 
@@ -285,23 +369,62 @@ bool LipstickCompositor::completed()
     return m_completed;
 }
 
+uint LipstickCompositor::notificationPreviewsDisabled(int windowId, uint defaultValue) const
+{
+    LipstickCompositorWindow *window = m_windows.value(windowId, 0);
+    return window && window->surface()
+            ? m_windowProperties->notificationPreviewsDisabled(window, defaultValue) : defaultValue;
+}
+
 int LipstickCompositor::windowIdForLink(int siblingId, uint link) const
 {
     if (LipstickCompositorWindow *sibling = m_windows.value(siblingId)) {
-        for (LipstickCompositorWindow *window : m_windows) {
-            QWaylandSurface *windowSurface  = window->surface();
-
-            if (windowSurface
-                    && sibling->processId() == window->processId()
-                    && windowSurface->windowProperties().value("WINID", uint(0)).toUInt() == link) {
+        foreach (LipstickCompositorWindow *window, m_windowProperties->linkedWindows(sibling->processId(), link)) {
+            if (window->surface())
                 return window->windowId();
-            }
         }
     }
 
     return 0;
 }
 
+QVariantMap LipstickCompositor::snapshotStatistics() const
+{
+    const SnapshotStore::Statistics statistics = SnapshotStore::instance()->statistics();
+
+    QVariantMap map;
+    map.insert(QStringLiteral("budget"), statistics.budget);
+    map.insert(QStringLiteral("residentBytes"), statistics.residentBytes);
+    map.insert(QStringLiteral("compressedBytes"), statistics.compressedBytes);
+    map.insert(QStringLiteral("snapshots"), statistics.snapshots);
+    map.insert(QStringLiteral("evictedSnapshots"), statistics.evictedSnapshots);
+    map.insert(QStringLiteral("evictions"), statistics.evictions);
+    map.insert(QStringLiteral("restores"), statistics.restores);
+    return map;
+}
+
+QVariantMap LipstickCompositor::frameStatistics()
+{
+    if (!calledFromDBus())
+        return windowFrameStatistics();
+
+    // The statistics tell which applications are running, so they are only given to privileged callers
+    CallerCredentials::instance()->runPrivileged(*this, this, [this](const QDBusMessage &message) {
+        return message.createReply(windowFrameStatistics());
+    });
+    return QVariantMap();
+}
+
+QVariantMap LipstickCompositor::windowFrameStatistics() const
+{
+    QVariantMap map;
+    foreach (LipstickCompositorWindow *window, m_mappedSurfaces) {
+        if (!window->isInProcess())
+            map.insert(QString::number(window->windowId()), window->frameStatistics());
+    }
+    return map;
+}
+
 void LipstickCompositor::clearKeyboardFocus()
 {
     defaultInputDevice()->setKeyboardFocus(0);
@@ -312,12 +435,16 @@ void LipstickCompositor::setDisplayOff()
     HomeApplication::instance()->setDisplayOff();
 }
 
-void LipstickCompositor::surfaceDamaged(const QRegion &)
+void LipstickCompositor::surfaceDamaged(const QRegion &damage)
 {
+    QWaylandSurface *surface = qobject_cast<QWaylandSurface *>(sender());
+    if (LipstickCompositorWindow *window = surface ? surfaceWindow(surface) : 0)
+        window->recordCommit(damage);
+
     if (!isVisible()) {
         // If the compositor is not visible, do not throttle.
         // make it conditional to QT_WAYLAND_COMPOSITOR_NO_THROTTLE?
-        sendFrameCallbacks(surfaces());
+        sendFrameCallbacksIfAllowed();
     }
 }
 
@@ -361,6 +488,10 @@ QWaylandSurfaceView *LipstickCompositor::createView(QWaylandSurface *surface)
     item->setParent(this);
     QObject::connect(item, SIGNAL(destroyed(QObject*)), this, SLOT(windowDestroyed()));
     m_windows.insert(item->windowId(), item);
+
+    // Later changes are picked up in windowPropertyChanged()
+    m_windowProperties->setNotificationPreviewsDisabled(item, properties.value(QLatin1String("NOTIFICATION_PREVIEWS_DISABLED")));
+    m_windowProperties->setLink(item, item->processId(), properties.value(QLatin1String("WINID"), uint(0)).toUInt());
     return item;
 }
 
@@ -475,11 +606,14 @@ void LipstickCompositor::windowDestroyed(LipstickCompositorWindow *item)
     int id = item->windowId();
 
     m_windows.remove(id);
+    m_windowProperties->removeWindow(item);
+    m_keyGrabs->removeWindow(item);
     surfaceUnmapped(item);
 }
 
 void LipstickCompositor::surfaceMapped()
 {
+    LIPSTICK_TRACE_SCOPE("compositor", "surfaceMapped");
     QWaylandSurface *surface = qobject_cast<QWaylandSurface *>(sender());
 
     LipstickCompositorWindow *item = surfaceWindow(surface);
@@ -577,7 +711,54 @@ void LipstickCompositor::surfaceLowered()
 
 void LipstickCompositor::windowSwapped()
 {
+    LIPSTICK_TRACE_INSTANT("compositor", "windowSwapped");
+    ++m_renderedFrames;
+    sendFrameCallbacksIfAllowed();
+}
+
+void LipstickCompositor::sendFrameCallbacksIfAllowed()
+{
+    // In low power mode only the lockscreen is shown, so clients are kept
+    // from rendering frames that nobody would see.
+    if (m_lowPowerMode)
+        return;
+
     sendFrameCallbacks(surfaces());
+
+    const qint64 now = Tracing::now() / 1000;
+    foreach (LipstickCompositorWindow *window, m_mappedSurfaces)
+        window->recordFrameCallbacksSent(now);
+}
+
+void LipstickCompositor::updateLowPowerMode()
+{
+    const bool lowPowerMode = LipstickSettings::instance()->lowPowerMode();
+    if (m_lowPowerMode == lowPowerMode)
+        return;
+
+    logRenderStatistics(m_lowPowerMode ? "low power" : "normal");
+
+    m_lowPowerMode = lowPowerMode;
+
+    // Let the clients continue right away from where they were held back
+    sendFrameCallbacksIfAllowed();
+
+    emit lowPowerModeChanged();
+}
+
+void LipstickCompositor::logRenderStatistics(const char *profile)
+{
+    const qint64 cpuTime = processCpuTime();
+
+    if (m_renderStatisticsTimer.isValid()) {
+        qCDebug(lcLipstickCoreLog) << "Rendered" << m_renderedFrames << "frames in" << profile << "mode during"
+                                   << m_renderStatisticsTimer.elapsed() << "ms using"
+                                   << cpuTime - m_renderStatisticsCpuTime << "ms of CPU time";
+    }
+
+    m_renderedFrames = 0;
+    m_renderStatisticsCpuTime = cpuTime;
+    m_renderStatisticsTimer.start();
 }
 
 void LipstickCompositor::windowDestroyed()
@@ -590,18 +771,24 @@ void LipstickCompositor::windowDestroyed()
 void LipstickCompositor::windowPropertyChanged(const QString &property)
 {
     QWaylandSurface *surface = qobject_cast<QWaylandSurface *>(sender());
+    const QVariantMap properties = surface->windowProperties();
 
     if (debug())
-        qDebug() << "Window properties changed:" << surface << surface->windowProperties();
+        qDebug() << "Window properties changed:" << surface << properties;
 
+    LipstickCompositorWindow *window = surfaceWindow(surface);
+    if (!window)
+        return;
+
+    const QVariant value = properties.value(property);
     if (property == QLatin1String("MOUSE_REGION")) {
-        LipstickCompositorWindow *window = surfaceWindow(surface);
-        if (window)
-            window->refreshMouseRegion();
+        window->refreshMouseRegion(value);
     } else if (property == QLatin1String("GRABBED_KEYS")) {
-        LipstickCompositorWindow *window = surfaceWindow(surface);
-        if (window)
-            window->refreshGrabbedKeys();
+        window->refreshGrabbedKeys(value);
+    } else if (property == QLatin1String("WINID")) {
+        m_windowProperties->setLink(window, window->processId(), value.toUInt());
+    } else if (property == QLatin1String("NOTIFICATION_PREVIEWS_DISABLED")) {
+        m_windowProperties->setNotificationPreviewsDisabled(window, value);
     }
 }
 
@@ -614,6 +801,7 @@ void LipstickCompositor::surfaceUnmapped(QWaylandSurface *surface)
 
 void LipstickCompositor::surfaceUnmapped(LipstickCompositorWindow *item)
 {
+    LIPSTICK_TRACE_SCOPE("compositor", "surfaceUnmapped");
     int id = item->windowId();
 
     int gc = ghostWindowCount();
@@ -693,11 +881,11 @@ void LipstickCompositor::setKeymap(LipstickKeymap *keymap)
     m_keymap = keymap;
 
     if (m_keymap) {
-        connect(m_keymap, &LipstickKeymap::rulesChanged, this, &LipstickCompositor::updateKeymap);
-        connect(m_keymap, &LipstickKeymap::modelChanged, this, &LipstickCompositor::updateKeymap);
-        connect(m_keymap, &LipstickKeymap::layoutChanged, this, &LipstickCompositor::updateKeymap);
-        connect(m_keymap, &LipstickKeymap::variantChanged, this, &LipstickCompositor::updateKeymap);
-        connect(m_keymap, &LipstickKeymap::optionsChanged, this, &LipstickCompositor::updateKeymap);
+        connect(m_keymap, &LipstickKeymap::rulesChanged, this, &LipstickCompositor::scheduleKeymapUpdate);
+        connect(m_keymap, &LipstickKeymap::modelChanged, this, &LipstickCompositor::scheduleKeymapUpdate);
+        connect(m_keymap, &LipstickKeymap::layoutChanged, this, &LipstickCompositor::scheduleKeymapUpdate);
+        connect(m_keymap, &LipstickKeymap::variantChanged, this, &LipstickCompositor::scheduleKeymapUpdate);
+        connect(m_keymap, &LipstickKeymap::optionsChanged, this, &LipstickCompositor::scheduleKeymapUpdate);
     }
 
     if (update)
@@ -706,12 +894,47 @@ void LipstickCompositor::setKeymap(LipstickKeymap *keymap)
     emit keymapChanged();
 }
 
+void LipstickCompositor::scheduleKeymapUpdate()
+{
+    // A layout switch usually changes several of the RMLVO properties in a row.
+    // Every QWaylandInputDevice::setKeymap() recompiles the XKB keymap and sends
+    // a new keymap fd to all clients, so apply the changes only once.
+    if (m_keymapUpdateTimerId == 0)
+        m_keymapUpdateTimerId = startTimer(0);
+}
+
+static bool keymapsEqual(const QWaylandKeymap &a, const QWaylandKeymap &b)
+{
+    return a.rules() == b.rules()
+            && a.model() == b.model()
+            && a.layout() == b.layout()
+            && a.variant() == b.variant()
+            && a.options() == b.options();
+}
+
 void LipstickCompositor::updateKeymap()
 {
-    if (m_keymap)
-        defaultInputDevice()->setKeymap(m_keymap->waylandKeymap());
-    else
-        defaultInputDevice()->setKeymap(QWaylandKeymap());
+    if (m_keymapUpdateTimerId > 0) {
+        killTimer(m_keymapUpdateTimerId);
+        m_keymapUpdateTimerId = 0;
+    }
+
+    const QWaylandKeymap keymap = m_keymap ? m_keymap->waylandKeymap() : QWaylandKeymap();
+
+    // Changes that cancel each other out do not need a recompile
+    if (m_keymapApplied && keymapsEqual(keymap, m_appliedKeymap))
+        return;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    defaultInputDevice()->setKeymap(keymap);
+    m_appliedKeymap = keymap;
+    m_keymapApplied = true;
+
+    qCDebug(lcLipstickCoreLog) << "Keymap" << keymap.rules() << keymap.model() << keymap.layout()
+                               << keymap.variant() << keymap.options()
+                               << "applied in" << timer.nsecsElapsed() / 1000 << "us";
 }
 
 void LipstickCompositor::reactOnDisplayStateChanges(TouchScreen::DisplayState oldState, TouchScreen::DisplayState newState)
@@ -719,6 +942,7 @@ void LipstickCompositor::reactOnDisplayStateChanges(TouchScreen::DisplayState ol
     bool oldOn = displayStateIsOn(oldState);
     bool newOn = displayStateIsOn(newState);
 
+    m_orientationMonitor->setDisplayOn(newOn);
     if (oldOn != newOn) {
         if (newOn) {
             emit displayOn();
@@ -738,34 +962,10 @@ void LipstickCompositor::reactOnDisplayStateChanges(TouchScreen::DisplayState ol
 
 void LipstickCompositor::setScreenOrientationFromSensor()
 {
-    QOrientationReading* reading = m_orientationSensor->reading();
+    Qt::ScreenOrientation sensorOrientation = m_orientationMonitor->orientation();
 
     if (debug())
-        qDebug() << "Screen orientation changed " << reading->orientation();
-
-    Qt::ScreenOrientation sensorOrientation = m_sensorOrientation;
-    switch (reading->orientation()) {
-        case QOrientationReading::TopUp:
-            sensorOrientation = Qt::PortraitOrientation;
-            break;
-        case QOrientationReading::TopDown:
-            sensorOrientation = Qt::InvertedPortraitOrientation;
-            break;
-        case QOrientationReading::LeftUp:
-            sensorOrientation = Qt::InvertedLandscapeOrientation;
-            break;
-        case QOrientationReading::RightUp:
-            sensorOrientation = Qt::LandscapeOrientation;
-            break;
-        case QOrientationReading::FaceUp:
-        case QOrientationReading::FaceDown:
-            /* Keep screen orientation at previous state */
-            break;
-        case QOrientationReading::Undefined:
-        default:
-            sensorOrientation = Qt::PrimaryOrientation;
-            break;
-    }
+        qDebug() << "Screen orientation changed " << sensorOrientation;
 
     if (sensorOrientation != m_sensorOrientation) {
         m_sensorOrientation = sensorOrientation;
@@ -773,6 +973,28 @@ void LipstickCompositor::setScreenOrientationFromSensor()
     }
 }
 
+Qt::ScreenOrientations LipstickCompositor::topmostWindowAllowedOrientations() const
+{
+    return m_topmostWindowAllowedOrientations;
+}
+
+void LipstickCompositor::setTopmostWindowAllowedOrientations(Qt::ScreenOrientations orientations)
+{
+    if (m_topmostWindowAllowedOrientations != orientations) {
+        m_topmostWindowAllowedOrientations = orientations;
+        updateSensorOrientations();
+        emit topmostWindowAllowedOrientationsChanged();
+    }
+}
+
+void LipstickCompositor::updateSensorOrientations()
+{
+    // The sensor is not needed while the orientation lock pins the screen, whatever the
+    // topmost window allows
+    const Qt::ScreenOrientations locked = lockedOrientations(orientationLock().toString());
+    m_orientationMonitor->setAllowedOrientations(locked != 0 ? locked : m_topmostWindowAllowedOrientations);
+}
+
 void LipstickCompositor::clipboardDataChanged()
 {
     const QMimeData *mimeData = QGuiApplication::clipboard()->mimeData();
@@ -783,6 +1005,13 @@ void LipstickCompositor::clipboardDataChanged()
 void LipstickCompositor::setUpdatesEnabledNow(bool enabled)
 {
     if (m_updatesEnabled != enabled) {
+        LIPSTICK_TRACE_SCOPE("compositor", "setUpdatesEnabled");
+        QElapsedTimer timer;
+        timer.start();
+        // How long the display stayed in the previous state, fast toggles show up here
+        const qint64 previousStateDuration = m_updatesEnabledStateTimer.isValid() ? m_updatesEnabledStateTimer.elapsed() : 0;
+        m_updatesEnabledStateTimer.start();
+
         m_updatesEnabled = enabled;
 
         if (!m_updatesEnabled) {
@@ -798,7 +1027,13 @@ void LipstickCompositor::setUpdatesEnabledNow(bool enabled)
             }
             // trigger frame callbacks which are pending already at this time
             surfaceCommitted();
+
+            startDisplayOffReleaseTimer();
         } else {
+            if (m_displayOffReleaseTimerId > 0) {
+                killTimer(m_displayOffReleaseTimerId);
+                m_displayOffReleaseTimerId = 0;
+            }
             if (QWindow::handle()) {
                 QGuiApplication::platformNativeInterface()->nativeResourceForIntegration("DisplayOn");
             }
@@ -814,6 +1049,10 @@ void LipstickCompositor::setUpdatesEnabledNow(bool enabled)
                 m_onUpdatesDisabledUnfocusedWindowId = 0;
             }
         }
+
+        qCDebug(lcLipstickCoreLog) << "Display updates" << (enabled ? "enabled" : "disabled")
+                                   << "in" << timer.nsecsElapsed() / 1000 << "us, the previous state lasted"
+                                   << previousStateDuration << "ms";
     }
 
     if (m_updatesEnabled && !m_completed) {
@@ -829,29 +1068,39 @@ void LipstickCompositor::setUpdatesEnabled(bool enabled)
     } else {
         if (message().isReplyRequired())
             setDelayedReply(true);
+        // Calls arriving before the queue is processed are handled together
+        if (m_queuedSetUpdatesEnabledCalls.isEmpty())
+            QMetaObject::invokeMethod(this, "processQueuedSetUpdatesEnabledCalls", Qt::QueuedConnection);
         m_queuedSetUpdatesEnabledCalls.append(QueuedSetUpdatesEnabledCall(connection(), message(), enabled));
-        QMetaObject::invokeMethod(this, "processQueuedSetUpdatesEnabledCalls", Qt::QueuedConnection);
     }
 }
 
 void LipstickCompositor::processQueuedSetUpdatesEnabledCalls()
 {
-    if (m_mceNameOwner->valid()) {
-        while (!m_queuedSetUpdatesEnabledCalls.isEmpty()) {
-            QueuedSetUpdatesEnabledCall queued(m_queuedSetUpdatesEnabledCalls.takeFirst());
-            if (queued.m_message.service() != m_mceNameOwner->nameOwner()) {
-                if (queued.m_message.isReplyRequired()) {
-                    QDBusMessage reply(queued.m_message.createErrorReply(DBUS_ERROR_ACCESS_DENIED,
-                                                                         "Only mce is allowed to call this method"));
-                    queued.m_connection.send(reply);
-                }
-            } else {
-                setUpdatesEnabledNow(queued.m_enable);
-                if (queued.m_message.isReplyRequired()) {
-                    QDBusMessage reply(queued.m_message.createReply());
-                    queued.m_connection.send(reply);
-                }
-            }
+    if (!m_mceNameOwner->valid() || m_queuedSetUpdatesEnabledCalls.isEmpty())
+        return;
+
+    const SetUpdatesEnabledBatch batch = SetUpdatesEnabledBatch::collapse(m_queuedSetUpdatesEnabledCalls,
+                                                                          m_mceNameOwner->nameOwner());
+    m_queuedSetUpdatesEnabledCalls.clear();
+
+    foreach (const QueuedSetUpdatesEnabledCall &queued, batch.denied) {
+        if (queued.m_message.isReplyRequired())
+            queued.m_connection.send(SetUpdatesEnabledBatch::deniedReply(queued.m_message));
+    }
+
+    if (batch.accepted.isEmpty())
+        return;
+
+    if (batch.accepted.count() > 1)
+        qCDebug(lcLipstickCoreLog) << "Collapsed" << batch.accepted.count() << "display update requests";
+    setUpdatesEnabledNow(batch.enable);
+
+    // Replies are sent once the final state has been applied, in the order of the calls
+    foreach (const QueuedSetUpdatesEnabledCall &queued, batch.accepted) {
+        if (queued.m_message.isReplyRequired()) {
+            QDBusMessage reply(queued.m_message.createReply());
+            queued.m_connection.send(reply);
         }
     }
 }
@@ -875,10 +1124,51 @@ void LipstickCompositor::timerEvent(QTimerEvent *e)
 {
     if (e->timerId() == m_fakeRepaintTimerId) {
         frameStarted();
-        sendFrameCallbacks(surfaces());
+        sendFrameCallbacksIfAllowed();
         killTimer(e->timerId());
         m_fakeRepaintTimerId = 0;
+    } else if (e->timerId() == m_keymapUpdateTimerId) {
+        updateKeymap();
+    } else if (e->timerId() == m_displayOffReleaseTimerId) {
+        killTimer(e->timerId());
+        m_displayOffReleaseTimerId = 0;
+        releaseDisplayOffResources();
+    }
+}
+
+void LipstickCompositor::startDisplayOffReleaseTimer()
+{
+    // Restarted when the delay changes while the display is off, the new delay counts from then
+    if (m_displayOffReleaseTimerId > 0) {
+        killTimer(m_displayOffReleaseTimerId);
+        m_displayOffReleaseTimerId = 0;
     }
+
+    // The other render loops do not release anything from a hidden window
+    if (m_displayOffReleaseDelay >= 0 && usesThreadedRenderLoop())
+        m_displayOffReleaseTimerId = startTimer(m_displayOffReleaseDelay);
+}
+
+void LipstickCompositor::releaseDisplayOffResources()
+{
+    if (m_updatesEnabled || isVisible())
+        return;
+
+    LIPSTICK_TRACE_SCOPE("compositor", "releaseDisplayOffResources");
+
+    // Tears down the scene graph of the hidden window, which deletes the nodes, the textures
+    // of the surfaces, the glyph caches and the shader programs. The OpenGL context is kept
+    // so that turning the display on only has to rebuild what is shown at that time.
+    // Window snapshots are moved out of GPU memory by WindowPixmapItem::invalidateSceneGraph().
+    // Only the threaded render loop invalidates the scene graph of a hidden window whose
+    // scene graph is not persistent; the basic and windows loops ignore releaseResources(),
+    // so the timer is not started with them.
+    setPersistentSceneGraph(false);
+    releaseResources();
+    setPersistentSceneGraph(true);
+
+    if (debug())
+        qDebug() << "Released scene graph resources while the display is off" << snapshotStatistics();
 }
 
 bool LipstickCompositor::event(QEvent *event)
@@ -896,19 +1186,34 @@ bool LipstickCompositor::event(QEvent *event)
             }
             return true;
         }
+    } else if ((event->type() == QEvent::KeyPress || event->type() == QEvent::KeyRelease) && !m_keyGrabs->isEmpty()) {
+        QKeyEvent *keyEvent = static_cast<QKeyEvent *>(event);
+
+        // Windows grabbing a key get it regardless of the keyboard focus, the
+        // release going to the same window as the press
+        if (!keyEvent->isAutoRepeat()) {
+            LIPSTICK_TRACE_SCOPE("input", "keyEvent");
+            LipstickCompositorWindow *window = event->type() == QEvent::KeyPress
+                    ? m_keyGrabs->press(keyEvent->key())
+                    : m_keyGrabs->release(keyEvent->key());
+            if (window && window->handleGrabbedKeyEvent(keyEvent))
+                return true;
+        }
     }
     return QQuickWindow::event(event);
 }
 
 void LipstickCompositor::sendKeyEvent(QEvent::Type type, Qt::Key key, quint32 nativeScanCode)
 {
-    QKeyEvent *event = new QKeyEvent(type, key, Qt::NoModifier, nativeScanCode, 0, 0);
+    QKeyEvent event(type, key, Qt::NoModifier, nativeScanCode, 0, 0);
 
-    // Not all Lipstick windows are real windows
+    // Not all Lipstick windows are real windows, the in-process ones are items of this window
+    // and get the event directly
     LipstickCompositorWindow *topmostWindow = qobject_cast<LipstickCompositorWindow *>(windowForId(topmostWindowId()));
     if (topmostWindow && topmostWindow->isInProcess()) {
-        QCoreApplication::sendEvent(activeFocusItem(), event);
+        if (QQuickItem *item = activeFocusItem())
+            QCoreApplication::sendEvent(item, &event);
     } else {
-        defaultInputDevice()->sendFullKeyEvent(event);
+        defaultInputDevice()->sendFullKeyEvent(&event);
     }
 }
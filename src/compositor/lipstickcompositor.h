@@ -28,10 +28,13 @@
 #include <QWaylandSurfaceItem>
 #include <QPointer>
 #include <QTimer>
+#include <QElapsedTimer>
 #include <MGConfItem>
 #include <QDBusConnection>
 #include <QDBusContext>
 #include <QDBusMessage>
+#include <QWaylandInputDevice>
+#include "setupdatesenabledbatch.h"
 
 #ifdef LIPSTICK_UNIT_TEST_STUB
 #undef Q_DECL_OVERRIDE
@@ -41,25 +44,14 @@
 class WindowModel;
 class LipstickCompositorWindow;
 class LipstickCompositorProcWindow;
-class QOrientationSensor;
+class OrientationMonitor;
+class ProcessTerminator;
 class LipstickRecorderManager;
+template <typename Window> class KeyGrabTable;
+template <typename Window> class WindowPropertyCache;
 class LipstickKeymap;
 class QMceNameOwner;
 
-struct QueuedSetUpdatesEnabledCall
-{
-    QueuedSetUpdatesEnabledCall(const QDBusConnection &connection, const QDBusMessage &message, bool enable)
-    : m_connection(connection)
-    , m_message(message)
-    , m_enable(enable)
-    {
-    }
-
-    QDBusConnection m_connection;
-    QDBusMessage m_message;
-    bool m_enable;
-};
-
 
 #if QTCOMPOSITOR_VERSION >= QT_VERSION_CHECK(5, 6, 0)
 typedef QWaylandClient WaylandClient;
@@ -84,11 +76,13 @@ class LIPSTICK_EXPORT LipstickCompositor
     Q_PROPERTY(Qt::ScreenOrientation topmostWindowOrientation READ topmostWindowOrientation WRITE setTopmostWindowOrientation NOTIFY topmostWindowOrientationChanged)
     Q_PROPERTY(Qt::ScreenOrientation screenOrientation READ screenOrientation WRITE setScreenOrientation NOTIFY screenOrientationChanged)
     Q_PROPERTY(Qt::ScreenOrientation sensorOrientation READ sensorOrientation NOTIFY sensorOrientationChanged)
+    Q_PROPERTY(Qt::ScreenOrientations topmostWindowAllowedOrientations READ topmostWindowAllowedOrientations WRITE setTopmostWindowAllowedOrientations NOTIFY topmostWindowAllowedOrientationsChanged)
     Q_PROPERTY(LipstickKeymap *keymap READ keymap WRITE setKeymap NOTIFY keymapChanged)
     Q_PROPERTY(QObject* clipboard READ clipboard CONSTANT)
     Q_PROPERTY(QVariant orientationLock READ orientationLock NOTIFY orientationLockChanged)
     Q_PROPERTY(bool displayDimmed READ displayDimmed NOTIFY displayDimmedChanged)
     Q_PROPERTY(bool completed READ completed NOTIFY completedChanged)
+    Q_PROPERTY(bool lowPowerMode READ lowPowerMode NOTIFY lowPowerModeChanged)
 
 public:
     LipstickCompositor();
@@ -112,6 +106,8 @@ public:
     void setTopmostWindowId(int id);
     int privateTopmostWindowProcessId() const { return m_topmostWindowProcessId; }
     QString privateTopmostWindowPolicyApplicationId() const { return m_topmostWindowPolicyApplicationId; }
+    //! Returns the frame statistics of the client windows by their window ids, to privileged D-Bus callers only
+    QVariantMap frameStatistics();
 
     Qt::ScreenOrientation topmostWindowOrientation() const { return m_topmostWindowOrientation; }
     void setTopmostWindowOrientation(Qt::ScreenOrientation topmostWindowOrientation);
@@ -121,6 +117,9 @@ public:
 
     Qt::ScreenOrientation sensorOrientation() const { return m_sensorOrientation; }
 
+    Qt::ScreenOrientations topmostWindowAllowedOrientations() const;
+    void setTopmostWindowAllowedOrientations(Qt::ScreenOrientations orientations);
+
     QVariant orientationLock() const { return m_orientationLock->value("dynamic"); }
 
     bool displayDimmed() const;
@@ -136,6 +135,7 @@ public:
     Q_INVOKABLE void closeClientForWindowId(int);
     Q_INVOKABLE void clearKeyboardFocus();
     Q_INVOKABLE void setDisplayOff();
+    Q_INVOKABLE QVariantMap snapshotStatistics() const;
     Q_INVOKABLE QVariant settingsValue(const QString &key, const QVariant &defaultValue = QVariant()) const
         { return (key == "orientationLock") ? m_orientationLock->value(defaultValue) : MGConfItem("/lipstick/" + key).value(defaultValue); }
     Q_INVOKABLE void openUrl(const QString &url)
@@ -148,9 +148,12 @@ public:
     LipstickCompositorProcWindow *mapProcWindow(const QString &title, const QString &category, const QRect &, QQuickItem *rootItem);
 
     QWaylandSurface *surfaceForId(int) const;
+    uint notificationPreviewsDisabled(int windowId, uint defaultValue) const;
 
     bool completed();
 
+    bool lowPowerMode() const { return m_lowPowerMode; }
+
     void setUpdatesEnabledNow(bool enabled);
     void setUpdatesEnabled(bool enabled);
     QWaylandSurfaceView *createView(QWaylandSurface *surf) Q_DECL_OVERRIDE;
@@ -179,6 +182,7 @@ signals:
     void topmostWindowOrientationChanged();
     void screenOrientationChanged();
     void sensorOrientationChanged();
+    void topmostWindowAllowedOrientationsChanged();
     void orientationLockChanged();
     void displayDimmedChanged();
 
@@ -190,6 +194,7 @@ signals:
     void displayAboutToBeOff();
 
     void completedChanged();
+    void lowPowerModeChanged();
 
     void showUnlockScreen();
 
@@ -211,9 +216,11 @@ private slots:
     void setScreenOrientationFromSensor();
     void clipboardDataChanged();
     void onVisibleChanged(bool visible);
+    void scheduleKeymapUpdate();
     void updateKeymap();
     void initialize();
     void processQueuedSetUpdatesEnabledCalls();
+    void updateLowPowerMode();
 
 private:
     friend class LipstickCompositorWindow;
@@ -235,6 +242,12 @@ private:
     void surfaceCommitted();
 
     void activateLogindSession();
+    void sendFrameCallbacksIfAllowed();
+    void logRenderStatistics(const char *profile);
+    QVariantMap windowFrameStatistics() const;
+    void updateSensorOrientations();
+    void startDisplayOffReleaseTimer();
+    void releaseDisplayOffResources();
 
     static LipstickCompositor *m_instance;
 
@@ -247,6 +260,7 @@ private:
     int m_totalWindowCount;
     QHash<int, LipstickCompositorWindow *> m_mappedSurfaces;
     QHash<int, LipstickCompositorWindow *> m_windows;
+    WindowPropertyCache<LipstickCompositorWindow> *m_windowProperties;
 
     int m_nextWindowId;
     QList<WindowModel *> m_windowModels;
@@ -259,15 +273,29 @@ private:
     Qt::ScreenOrientation m_topmostWindowOrientation;
     Qt::ScreenOrientation m_screenOrientation;
     Qt::ScreenOrientation m_sensorOrientation;
-    QOrientationSensor* m_orientationSensor;
+    Qt::ScreenOrientations m_topmostWindowAllowedOrientations;
+    OrientationMonitor *m_orientationMonitor;
+    ProcessTerminator *m_processTerminator;
     QPointer<QMimeData> m_retainedSelection;
     MGConfItem *m_orientationLock;
     bool m_updatesEnabled;
+    QElapsedTimer m_updatesEnabledStateTimer;
     bool m_completed;
     int m_onUpdatesDisabledUnfocusedWindowId;
     LipstickRecorderManager *m_recorder;
+    KeyGrabTable<LipstickCompositorWindow> *m_keyGrabs;
     LipstickKeymap *m_keymap;
+    QWaylandKeymap m_appliedKeymap;
+    bool m_keymapApplied;
+    int m_keymapUpdateTimerId;
     int m_fakeRepaintTimerId;
+    int m_displayOffReleaseDelay;
+    int m_displayOffReleaseTimerId;
+
+    bool m_lowPowerMode;
+    int m_renderedFrames;
+    QElapsedTimer m_renderStatisticsTimer;
+    qint64 m_renderStatisticsCpuTime;
 
     QList<QueuedSetUpdatesEnabledCall> m_queuedSetUpdatesEnabledCalls;
     QMceNameOwner *m_mceNameOwner;
@@ -22,10 +22,18 @@
 #include <QWaylandClient>
 #endif
 #include <QTimer>
-#include <sys/types.h>
-#include <signal.h>
 #include "lipstickcompositor.h"
 #include "lipstickcompositorwindow.h"
+#include "framestatistics.h"
+#include "processterminator.h"
+#include "tracing.h"
+
+namespace {
+
+// Interval in milliseconds between frameStatisticsChanged() emissions of a committing window
+const int FrameStatisticsNotifyInterval = 1000;
+
+}
 
 
 LipstickCompositorWindow::LipstickCompositorWindow(int windowId, const QString &category,
@@ -33,10 +41,12 @@ LipstickCompositorWindow::LipstickCompositorWindow(int windowId, const QString &
 : QWaylandSurfaceItem(surface, parent), m_processId(0), m_windowId(windowId), m_isAlien(false), m_category(category),
   m_delayRemove(false), m_windowClosed(false), m_removePosted(false), m_mouseRegionValid(false),
   m_interceptingTouch(false), m_mapped(false),
-  m_focusOnTouch(false)
+  m_focusOnTouch(false),
+  m_frameStatistics(new FrameStatistics), m_frameStatisticsTimer(0)
 {
     setFlags(QQuickItem::ItemIsFocusScope | flags());
-    refreshMouseRegion();
+    if (surface)
+        refreshMouseRegion(surface->windowProperties().value(QLatin1String("MOUSE_REGION")));
 
     // Handle ungrab situations
     connect(this, SIGNAL(visibleChanged()), SLOT(handleTouchCancel()));
@@ -53,6 +63,8 @@ LipstickCompositorWindow::LipstickCompositorWindow(int windowId, const QString &
 #else
         m_processId = surface->processId();
 #endif
+        // Refers to the process through a pidfd from now on, in case it exits and its pid is reused
+        LipstickCompositor::instance()->m_processTerminator->watch(m_processId);
 
         m_isAlien = surface->property("alienSurface").toBool();
 
@@ -67,7 +79,10 @@ LipstickCompositorWindow::~LipstickCompositorWindow()
 {
     // We don't want tryRemove() posting an event anymore, we're dying anyway
     m_removePosted = true;
-    LipstickCompositor::instance()->windowDestroyed(this);
+    LipstickCompositor *compositor = LipstickCompositor::instance();
+    compositor->m_processTerminator->cancel(m_processId, this);
+    compositor->windowDestroyed(this);
+    delete m_frameStatistics;
 }
 
 void LipstickCompositorWindow::updatePolicyApplicationId()
@@ -205,13 +220,11 @@ QRect LipstickCompositorWindow::mouseRegionBounds() const
         return QRect(0, 0, width(), height());
 }
 
-void LipstickCompositorWindow::refreshMouseRegion()
+void LipstickCompositorWindow::refreshMouseRegion(const QVariant &mouseRegion)
 {
-    QWaylandSurface *s = surface();
-    if (s) {
-        QVariantMap properties = s->windowProperties();
-        if (properties.contains(QLatin1String("MOUSE_REGION"))) {
-            m_mouseRegion = s->windowProperties().value("MOUSE_REGION").value<QRegion>();
+    if (surface()) {
+        if (mouseRegion.isValid()) {
+            m_mouseRegion = mouseRegion.value<QRegion>();
             m_mouseRegionValid = true;
             if (LipstickCompositor::instance()->debug())
                 qDebug() << "Window" << windowId() << "mouse region set:" << m_mouseRegion;
@@ -225,28 +238,43 @@ void LipstickCompositorWindow::refreshMouseRegion()
     }
 }
 
-void LipstickCompositorWindow::refreshGrabbedKeys()
+void LipstickCompositorWindow::refreshGrabbedKeys(const QVariant &grabbedKeys)
 {
-    QWaylandSurface *s = surface();
-    if (s) {
-        const QStringList grabbedKeys = s->windowProperties().value(
-                    QLatin1String("GRABBED_KEYS")).value<QStringList>();
+    if (surface()) {
+        const QStringList keyNames = grabbedKeys.value<QStringList>();
 
-        if (m_grabbedKeys.isEmpty() && !grabbedKeys.isEmpty()) {
-            qApp->installEventFilter(this);
-        } else if (!m_grabbedKeys.isEmpty() && grabbedKeys.isEmpty() && m_pressedGrabbedKeys.keys.isEmpty()) {
-            // we don't remove the event filter if m_pressedGrabbedKeys.keys contains still some key.
-            // we wait the key release for that.
-            qApp->removeEventFilter(this);
-        }
-
-        m_grabbedKeys.clear();
-        foreach (const QString &key, grabbedKeys)
-            m_grabbedKeys.append(key.toInt());
+        // Keys that are still pressed keep going to this window until they are released
+        QList<int> keys;
+        foreach (const QString &key, keyNames)
+            keys.append(key.toInt());
+        LipstickCompositor::instance()->m_keyGrabs->setGrabbedKeys(this, keys);
 
         if (LipstickCompositor::instance()->debug())
-            qDebug() << "Window" << windowId() << "grabbed keys changed:" << grabbedKeys;
+            qDebug() << "Window" << windowId() << "grabbed keys changed:" << keyNames;
+    }
+}
+
+bool LipstickCompositorWindow::handleGrabbedKeyEvent(QKeyEvent *ke)
+{
+    QWaylandSurface *m_surface = surface();
+    if (!m_surface)
+        return false;
+
+    QWaylandInputDevice *inputDevice = m_surface->compositor()->defaultInputDevice();
+    if (ke->type() == QEvent::KeyPress) {
+        if (m_pressedGrabbedKeys.keys.isEmpty()) {
+            QWaylandSurface *old = inputDevice->keyboardFocus();
+            m_pressedGrabbedKeys.oldFocus = old;
+            inputDevice->setKeyboardFocus(m_surface);
+        }
+        m_pressedGrabbedKeys.keys << ke->key();
     }
+    inputDevice->sendFullKeyEvent(ke);
+    if (ke->type() == QEvent::KeyRelease) {
+        if (m_pressedGrabbedKeys.keys.removeOne(ke->key()) && m_pressedGrabbedKeys.keys.isEmpty())
+            inputDevice->setKeyboardFocus(m_pressedGrabbedKeys.oldFocus.data());
+    }
+    return true;
 }
 
 bool LipstickCompositorWindow::eventFilter(QObject *obj, QEvent *event)
@@ -272,31 +300,6 @@ bool LipstickCompositorWindow::eventFilter(QObject *obj, QEvent *event)
         }
         return false;
     }
-    if (event->type() == QEvent::KeyPress || event->type() == QEvent::KeyRelease) {
-        QKeyEvent *ke = static_cast<QKeyEvent *>(event);
-        QWaylandSurface *m_surface = surface();
-        if (m_surface && (m_grabbedKeys.contains(ke->key()) || m_pressedGrabbedKeys.keys.contains(ke->key())) && !ke->isAutoRepeat()) {
-            QWaylandInputDevice *inputDevice = m_surface->compositor()->defaultInputDevice();
-            if (event->type() == QEvent::KeyPress) {
-                if (m_pressedGrabbedKeys.keys.isEmpty()) {
-                    QWaylandSurface *old = inputDevice->keyboardFocus();
-                    m_pressedGrabbedKeys.oldFocus = old;
-                    inputDevice->setKeyboardFocus(m_surface);
-                }
-                m_pressedGrabbedKeys.keys << ke->key();
-            }
-            inputDevice->sendFullKeyEvent(ke);
-            if (event->type() == QEvent::KeyRelease) {
-                m_pressedGrabbedKeys.keys.removeOne(ke->key());
-                if (m_pressedGrabbedKeys.keys.isEmpty()) {
-                    inputDevice->setKeyboardFocus(m_pressedGrabbedKeys.oldFocus.data());
-                    if (m_grabbedKeys.isEmpty())
-                        qApp->removeEventFilter(this);
-                }
-            }
-            return true;
-        }
-    }
     return false;
 }
 
@@ -446,19 +449,7 @@ void LipstickCompositorWindow::handleTouchCancel()
 
 void LipstickCompositorWindow::terminateProcess(int killTimeout)
 {
-    pid_t pid = processId();
-    if (pid > 0) {
-        kill(pid, SIGTERM);
-        QTimer::singleShot(killTimeout, this, SLOT(killProcess()));
-    }
-}
-
-void LipstickCompositorWindow::killProcess()
-{
-    pid_t pid = processId();
-    if (pid > 0) {
-        kill(pid, SIGKILL);
-    }
+    LipstickCompositor::instance()->m_processTerminator->terminate(processId(), killTimeout, this);
 }
 
 bool LipstickCompositorWindow::focusOnTouch() const
@@ -482,3 +473,102 @@ void LipstickCompositorWindow::resize(const QSize &size)
         emit resized();
     }
 }
+
+qreal LipstickCompositorWindow::commitRate() const
+{
+    return m_frameStatistics->commitRate(Tracing::now() / 1000);
+}
+
+int LipstickCompositorWindow::damagedArea() const
+{
+    return int(m_frameStatistics->averageDamagedArea());
+}
+
+QSize LipstickCompositorWindow::bufferSize() const
+{
+    return m_frameStatistics->bufferSize();
+}
+
+QString LipstickCompositorWindow::bufferType() const
+{
+    switch (m_frameStatistics->bufferType()) {
+    case FrameStatistics::ShmBuffer:
+        return QStringLiteral("shm");
+    case FrameStatistics::EglBuffer:
+        return QStringLiteral("egl");
+    case FrameStatistics::NoBuffer:
+        break;
+    }
+    return QString();
+}
+
+qreal LipstickCompositorWindow::frameCallbackLatency() const
+{
+    const qint64 latency = m_frameStatistics->averageFrameCallbackLatency();
+    return latency >= 0 ? latency / 1000.0 : -1;
+}
+
+QVariantMap LipstickCompositorWindow::frameStatistics() const
+{
+    const qint64 maximumLatency = m_frameStatistics->maximumFrameCallbackLatency();
+
+    QVariantMap map;
+    map.insert(QStringLiteral("processId"), processId());
+    map.insert(QStringLiteral("category"), category());
+    map.insert(QStringLiteral("commits"), m_frameStatistics->commitCount());
+    map.insert(QStringLiteral("commitRate"), commitRate());
+    map.insert(QStringLiteral("damagedArea"), damagedArea());
+    map.insert(QStringLiteral("bufferWidth"), bufferSize().width());
+    map.insert(QStringLiteral("bufferHeight"), bufferSize().height());
+    map.insert(QStringLiteral("bufferType"), bufferType());
+    map.insert(QStringLiteral("frameCallbackLatency"), frameCallbackLatency());
+    map.insert(QStringLiteral("maximumFrameCallbackLatency"), maximumLatency >= 0 ? maximumLatency / 1000.0 : -1);
+    return map;
+}
+
+void LipstickCompositorWindow::recordCommit(const QRegion &damage)
+{
+    QWaylandSurface *surface = this->surface();
+    if (!surface)
+        return;
+
+    qint64 damagedArea = 0;
+    foreach (const QRect &rect, damage.rects())
+        damagedArea += qint64(rect.width()) * rect.height();
+
+    FrameStatistics::BufferType bufferType = FrameStatistics::NoBuffer;
+    switch (surface->type()) {
+    case QWaylandSurface::Shm:
+        bufferType = FrameStatistics::ShmBuffer;
+        break;
+    case QWaylandSurface::Texture:
+        bufferType = FrameStatistics::EglBuffer;
+        break;
+    default:
+        break;
+    }
+
+    m_frameStatistics->commit(Tracing::now() / 1000, damagedArea, surface->size(), bufferType);
+
+    if (!m_frameStatisticsTimer) {
+        m_frameStatisticsTimer = new QTimer(this);
+        m_frameStatisticsTimer->setInterval(FrameStatisticsNotifyInterval);
+        connect(m_frameStatisticsTimer, &QTimer::timeout, this, &LipstickCompositorWindow::notifyFrameStatistics);
+    }
+    if (!m_frameStatisticsTimer->isActive())
+        m_frameStatisticsTimer->start();
+}
+
+void LipstickCompositorWindow::notifyFrameStatistics()
+{
+    emit frameStatisticsChanged();
+
+    // Keeps notifying until the commit rate has dropped to zero, so that it does not go stale
+    if (qFuzzyIsNull(commitRate()))
+        m_frameStatisticsTimer->stop();
+}
+
+void LipstickCompositorWindow::recordFrameCallbacksSent(qint64 time)
+{
+    m_frameStatistics->frameCallbacksSent(time);
+}
@@ -21,6 +21,8 @@
 #include "lipstickglobal.h"
 
 class LipstickCompositorWindowHwcNode;
+class FrameStatistics;
+class QTimer;
 
 class LIPSTICK_EXPORT LipstickCompositorWindow : public QWaylandSurfaceItem
 {
@@ -40,6 +42,12 @@ class LIPSTICK_EXPORT LipstickCompositorWindow : public QWaylandSurfaceItem
     Q_PROPERTY(QRect mouseRegionBounds READ mouseRegionBounds NOTIFY mouseRegionBoundsChanged)
     Q_PROPERTY(bool focusOnTouch READ focusOnTouch WRITE setFocusOnTouch NOTIFY focusOnTouchChanged)
 
+    Q_PROPERTY(qreal commitRate READ commitRate NOTIFY frameStatisticsChanged)
+    Q_PROPERTY(int damagedArea READ damagedArea NOTIFY frameStatisticsChanged)
+    Q_PROPERTY(QSize bufferSize READ bufferSize NOTIFY frameStatisticsChanged)
+    Q_PROPERTY(QString bufferType READ bufferType NOTIFY frameStatisticsChanged)
+    Q_PROPERTY(qreal frameCallbackLatency READ frameCallbackLatency NOTIFY frameStatisticsChanged)
+
 public:
     LipstickCompositorWindow(int windowId, const QString &, QWaylandQuickSurface *surface, QQuickItem *parent = 0);
     ~LipstickCompositorWindow();
@@ -71,6 +79,18 @@ public:
 
     Q_INVOKABLE void resize(const QSize &size);
 
+    //! Commits per second during the last second
+    qreal commitRate() const;
+    //! Average number of pixels damaged by the recent commits
+    int damagedArea() const;
+    QSize bufferSize() const;
+    //! "shm" or "egl", empty if no buffer has been committed
+    QString bufferType() const;
+    //! Average milliseconds from a recent commit until its frame callbacks were sent, -1 if unknown
+    qreal frameCallbackLatency() const;
+
+    QVariantMap frameStatistics() const;
+
 protected:
     void itemChange(ItemChange change, const ItemChangeData &data);
 
@@ -89,10 +109,12 @@ signals:
     void committed();
     void focusOnTouchChanged();
     void resized();
+    //! Emitted once a second from the first commit until the commit rate has dropped to zero
+    void frameStatisticsChanged();
 
 private slots:
     void handleTouchCancel();
-    void killProcess();
+    void notifyFrameStatistics();
 
 private:
     friend class LipstickCompositor;
@@ -102,12 +124,16 @@ private:
 
     bool canRemove() const;
     void tryRemove();
-    void refreshMouseRegion();
-    void refreshGrabbedKeys();
+    void refreshMouseRegion(const QVariant &mouseRegion);
+    void refreshGrabbedKeys(const QVariant &grabbedKeys);
+    bool handleGrabbedKeyEvent(QKeyEvent *event);
     void handleTouchEvent(QTouchEvent *e);
 
     void updatePolicyApplicationId();
 
+    void recordCommit(const QRegion &damage);
+    void recordFrameCallbacksSent(qint64 time);
+
     qint64 m_processId;
     QString m_policyApplicationId;
     int m_windowId;
@@ -122,12 +148,13 @@ private:
     bool m_focusOnTouch : 1;
     QVariant m_data;
     QRegion m_mouseRegion;
-    QList<int> m_grabbedKeys;
     struct {
         QPointer<QWaylandSurface> oldFocus;
         QList<int> keys;
     } m_pressedGrabbedKeys;
     QVector<QQuickItem *> m_refs;
+    FrameStatistics *m_frameStatistics;
+    QTimer *m_frameStatisticsTimer;
 };
 
 #endif // LIPSTICKCOMPOSITORWINDOW_H
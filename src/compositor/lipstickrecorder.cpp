@@ -13,12 +13,12 @@
 ****************************************************************************/
 
 #include <sys/time.h>
-#include <grp.h>
 
 #include <QMutexLocker>
 
 #include "lipstickrecorder.h"
 #include "lipstickcompositor.h"
+#include "utilities/callercredentials.h"
 
 static uint32_t getTime()
 {
@@ -109,8 +109,7 @@ void LipstickRecorderManager::bind(wl_client *client, quint32 version, quint32 i
 
     gid_t gid;
     wl_client_get_credentials(client, Q_NULLPTR, Q_NULLPTR, &gid);
-    group *g = getgrgid(gid);
-    if (strcmp(g->gr_name, "privileged") != 0) {
+    if (gid != CallerCredentials::privilegedGroupId()) {
         wl_resource_post_error(res->handle, WL_DISPLAY_ERROR_INVALID_OBJECT, "Permission to bind lipstick_recorder_manager denied");
         wl_resource_destroy(res->handle);
     }
@@ -0,0 +1,173 @@
+/***************************************************************************
+**
+** Copyright (c) 2021 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#include <QtSensors/QOrientationSensor>
+#include <QDebug>
+#include "orientationmonitor.h"
+
+namespace {
+
+const Qt::ScreenOrientations AllOrientations = Qt::PortraitOrientation | Qt::LandscapeOrientation
+        | Qt::InvertedPortraitOrientation | Qt::InvertedLandscapeOrientation;
+
+bool hasSeveralOrientations(Qt::ScreenOrientations orientations)
+{
+    const int mask = int(orientations & AllOrientations);
+    return mask == 0 || (mask & (mask - 1)) != 0;
+}
+
+}
+
+OrientationMonitor::OrientationMonitor(QObject *parent)
+    : QObject(parent)
+    , m_sensor(new QOrientationSensor(this))
+    , m_orientation(Qt::PrimaryOrientation)
+    , m_pendingOrientation(Qt::PrimaryOrientation)
+    , m_allowedOrientations(0)
+    , m_displayOn(true)
+    , m_active(false)
+    , m_started(false)
+{
+    m_settleTimer.setSingleShot(true);
+    m_settleTimer.setInterval(0);
+    connect(&m_settleTimer, &QTimer::timeout, this, &OrientationMonitor::settle);
+
+    connect(m_sensor, &QOrientationSensor::readingChanged, this, &OrientationMonitor::readingChanged);
+    if (!m_sensor->connectToBackend()) {
+        qWarning() << "Could not connect to the orientation sensor backend";
+    }
+    updateActive();
+}
+
+Qt::ScreenOrientation OrientationMonitor::orientation() const
+{
+    return m_orientation;
+}
+
+bool OrientationMonitor::displayOn() const
+{
+    return m_displayOn;
+}
+
+void OrientationMonitor::setDisplayOn(bool on)
+{
+    if (m_displayOn != on) {
+        m_displayOn = on;
+        updateActive();
+    }
+}
+
+Qt::ScreenOrientations OrientationMonitor::allowedOrientations() const
+{
+    return m_allowedOrientations;
+}
+
+void OrientationMonitor::setAllowedOrientations(Qt::ScreenOrientations orientations)
+{
+    if (m_allowedOrientations != orientations) {
+        m_allowedOrientations = orientations;
+        updateActive();
+    }
+}
+
+int OrientationMonitor::settleTime() const
+{
+    return m_settleTimer.interval();
+}
+
+void OrientationMonitor::setSettleTime(int milliseconds)
+{
+    m_settleTimer.setInterval(qMax(0, milliseconds));
+}
+
+bool OrientationMonitor::isActive() const
+{
+    return m_active;
+}
+
+void OrientationMonitor::updateActive()
+{
+    const bool active = m_displayOn && hasSeveralOrientations(m_allowedOrientations) && m_sensor->isConnectedToBackend();
+    if (m_active == active)
+        return;
+
+    m_active = active;
+    m_settleTimer.stop();
+    if (m_active) {
+        // The device may have been turned while the sensor was stopped
+        m_started = true;
+        if (!m_sensor->start())
+            qWarning() << "Could not start the orientation sensor";
+    } else {
+        m_sensor->stop();
+    }
+}
+
+void OrientationMonitor::readingChanged()
+{
+    QOrientationReading *reading = m_sensor->reading();
+    if (!reading)
+        return;
+
+    Qt::ScreenOrientation orientation = m_orientation;
+    switch (reading->orientation()) {
+    case QOrientationReading::TopUp:
+        orientation = Qt::PortraitOrientation;
+        break;
+    case QOrientationReading::TopDown:
+        orientation = Qt::InvertedPortraitOrientation;
+        break;
+    case QOrientationReading::LeftUp:
+        orientation = Qt::InvertedLandscapeOrientation;
+        break;
+    case QOrientationReading::RightUp:
+        orientation = Qt::LandscapeOrientation;
+        break;
+    case QOrientationReading::FaceUp:
+    case QOrientationReading::FaceDown:
+        /* Keep screen orientation at previous state */
+        break;
+    case QOrientationReading::Undefined:
+    default:
+        orientation = Qt::PrimaryOrientation;
+        break;
+    }
+
+    const bool started = m_started;
+    m_started = false;
+
+    if (orientation == m_orientation) {
+        // Back to where it was before settling on a new orientation
+        m_settleTimer.stop();
+    } else if (started || m_settleTimer.interval() == 0) {
+        m_settleTimer.stop();
+        setOrientation(orientation);
+    } else if (orientation != m_pendingOrientation || !m_settleTimer.isActive()) {
+        m_pendingOrientation = orientation;
+        m_settleTimer.start();
+    }
+}
+
+void OrientationMonitor::settle()
+{
+    setOrientation(m_pendingOrientation);
+}
+
+void OrientationMonitor::setOrientation(Qt::ScreenOrientation orientation)
+{
+    if (m_orientation != orientation) {
+        m_orientation = orientation;
+        emit orientationChanged();
+    }
+}
@@ -0,0 +1,79 @@
+/***************************************************************************
+**
+** Copyright (c) 2021 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#ifndef ORIENTATIONMONITOR_H
+#define ORIENTATIONMONITOR_H
+
+#include <QObject>
+#include <QTimer>
+#include "lipstickglobal.h"
+
+class QOrientationSensor;
+
+/*!
+ * Follows the device orientation with the orientation sensor.
+ *
+ * The sensor only runs while the display is on and the topmost window
+ * can be shown in more than one orientation, so it does not wake the
+ * device up when nobody would react to a change. A new orientation must
+ * be reported for the settle time before it is taken into use, so that
+ * holding the device at a borderline angle does not make the screen
+ * flip back and forth. The first reading after the sensor has been
+ * started is taken into use right away.
+ */
+class LIPSTICK_EXPORT OrientationMonitor : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit OrientationMonitor(QObject *parent = 0);
+
+    //! Returns the current device orientation, Qt::PrimaryOrientation if it is not known
+    Qt::ScreenOrientation orientation() const;
+
+    bool displayOn() const;
+    void setDisplayOn(bool on);
+
+    //! The orientations of the topmost window, 0 if they are not known
+    Qt::ScreenOrientations allowedOrientations() const;
+    void setAllowedOrientations(Qt::ScreenOrientations orientations);
+
+    //! Time in milliseconds a new orientation must be reported before it is taken into use
+    int settleTime() const;
+    void setSettleTime(int milliseconds);
+
+    bool isActive() const;
+
+signals:
+    void orientationChanged();
+
+private slots:
+    void readingChanged();
+    void settle();
+
+private:
+    void updateActive();
+    void setOrientation(Qt::ScreenOrientation orientation);
+
+    QOrientationSensor *m_sensor;
+    QTimer m_settleTimer;
+    Qt::ScreenOrientation m_orientation;
+    Qt::ScreenOrientation m_pendingOrientation;
+    Qt::ScreenOrientations m_allowedOrientations;
+    bool m_displayOn;
+    bool m_active;
+    bool m_started;
+};
+
+#endif // ORIENTATIONMONITOR_H
@@ -0,0 +1,257 @@
+/***************************************************************************
+**
+** Copyright (c) 2021 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#include <QSet>
+#include <QSocketNotifier>
+#include <errno.h>
+#include <signal.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include "logging.h"
+#include "processterminator.h"
+
+#ifndef SYS_pidfd_open
+#define SYS_pidfd_open 434
+#endif
+#ifndef SYS_pidfd_send_signal
+#define SYS_pidfd_send_signal 424
+#endif
+
+namespace {
+
+int pidfdOpen(pid_t pid)
+{
+    return ::syscall(SYS_pidfd_open, pid, 0);
+}
+
+int pidfdSendSignal(int pidfd, int signal)
+{
+    return ::syscall(SYS_pidfd_send_signal, pidfd, signal, nullptr, 0);
+}
+
+}
+
+struct ProcessTerminator::Process
+{
+    qint64 pid;
+    int pidfd;
+    QSocketNotifier *notifier;
+    int windows;
+    QSet<const QObject *> terminatedBy;
+    qint64 terminated;
+    qint64 killDeadline;
+    bool killed;
+};
+
+ProcessTerminator::ProcessTerminator(QObject *parent)
+    : QObject(parent)
+{
+    m_escalationTimer.setSingleShot(true);
+    connect(&m_escalationTimer, SIGNAL(timeout()), this, SLOT(escalate()));
+    m_clock.start();
+}
+
+ProcessTerminator::~ProcessTerminator()
+{
+    foreach (Process *process, m_processes)
+        remove(process);
+}
+
+void ProcessTerminator::watch(qint64 pid)
+{
+    if (pid <= 0)
+        return;
+
+    Process *process = m_processes.value(pid);
+    if (!process)
+        process = open(pid);
+    if (process)
+        ++process->windows;
+}
+
+void ProcessTerminator::terminate(qint64 pid, int killTimeout, const QObject *window)
+{
+    if (pid <= 0)
+        return;
+
+    Process *process = m_processes.value(pid);
+    if (!process) {
+        // Not watched, as for a window that was created without a client
+        process = open(pid);
+        if (!process)
+            return;
+    }
+
+    if (window)
+        process->terminatedBy.insert(window);
+
+    const qint64 now = m_clock.elapsed();
+    if (process->terminated >= 0) {
+        // Terminated again, the earlier deadline holds
+        if (!process->killed && now + killTimeout < process->killDeadline) {
+            process->killDeadline = now + killTimeout;
+            scheduleEscalation();
+        }
+        return;
+    }
+
+    process->terminated = now;
+    process->killDeadline = now + killTimeout;
+    if (!sendSignal(process, SIGTERM)) {
+        stopTerminating(process);
+        releaseIfUnused(process);
+        return;
+    }
+
+    if (process->pidfd >= 0) {
+        // A pidfd becomes readable when the process exits
+        process->notifier = new QSocketNotifier(process->pidfd, QSocketNotifier::Read, this);
+        connect(process->notifier, SIGNAL(activated(int)), this, SLOT(pidfdActivated(int)));
+    }
+    scheduleEscalation();
+}
+
+void ProcessTerminator::cancel(qint64 pid, const QObject *window)
+{
+    Process *process = m_processes.value(pid);
+    if (!process)
+        return;
+
+    if (process->windows > 0)
+        --process->windows;
+
+    // Other windows of a hung process do not save it from being killed, only the closed ones do
+    const bool closedWindowGone = process->terminatedBy.remove(window) && process->terminatedBy.isEmpty();
+    if (process->terminated >= 0 && (closedWindowGone || process->windows == 0)) {
+        stopTerminating(process);
+        scheduleEscalation();
+    }
+    releaseIfUnused(process);
+}
+
+bool ProcessTerminator::isTerminating(qint64 pid) const
+{
+    const Process *process = m_processes.value(pid);
+    return process && process->terminated >= 0;
+}
+
+void ProcessTerminator::pidfdActivated(int pidfd)
+{
+    foreach (Process *process, m_processes) {
+        if (process->pidfd == pidfd && process->terminated >= 0) {
+            const qint64 milliseconds = m_clock.elapsed() - process->terminated;
+            const qint64 pid = process->pid;
+            const bool killed = process->killed;
+
+            qCDebug(lcLipstickCoreLog) << "Process" << pid << "exited" << milliseconds << "ms after SIGTERM"
+                                       << (killed ? "and SIGKILL" : "");
+            // The pidfd stays open while windows refer to the process, signals through it fail from now on
+            stopTerminating(process);
+            releaseIfUnused(process);
+            scheduleEscalation();
+
+            emit processExited(pid, milliseconds, killed);
+            return;
+        }
+    }
+}
+
+void ProcessTerminator::escalate()
+{
+    const qint64 now = m_clock.elapsed();
+
+    foreach (Process *process, m_processes) {
+        if (process->terminated >= 0 && !process->killed && process->killDeadline <= now) {
+            process->killed = true;
+            sendSignal(process, SIGKILL);
+
+            // Without a pidfd there is no way to know when the process exits
+            if (process->pidfd < 0) {
+                stopTerminating(process);
+                releaseIfUnused(process);
+            }
+        }
+    }
+
+    scheduleEscalation();
+}
+
+ProcessTerminator::Process *ProcessTerminator::open(qint64 pid)
+{
+    const int pidfd = pidfdOpen(pid_t(pid));
+    if (pidfd < 0 && errno == ESRCH)
+        return 0;
+
+    Process *process = new Process { pid, pidfd, 0, 0, QSet<const QObject *>(), -1, 0, false };
+    m_processes.insert(pid, process);
+    return process;
+}
+
+bool ProcessTerminator::sendSignal(Process *process, int signal)
+{
+    const int result = process->pidfd >= 0
+            ? pidfdSendSignal(process->pidfd, signal)
+            : ::kill(pid_t(process->pid), signal);
+    if (result < 0) {
+        if (errno != ESRCH)
+            qCWarning(lcLipstickCoreLog) << "Cannot send signal" << signal << "to process" << process->pid << strerror(errno);
+        return false;
+    }
+    return true;
+}
+
+void ProcessTerminator::stopTerminating(Process *process)
+{
+    // This can be called from the notifier, which must outlive its activation
+    if (process->notifier) {
+        process->notifier->setEnabled(false);
+        process->notifier->deleteLater();
+        process->notifier = 0;
+    }
+    process->terminatedBy.clear();
+    process->terminated = -1;
+    process->killed = false;
+}
+
+void ProcessTerminator::releaseIfUnused(Process *process)
+{
+    if (process->windows == 0 && process->terminated < 0) {
+        m_processes.remove(process->pid);
+        remove(process);
+    }
+}
+
+void ProcessTerminator::remove(Process *process)
+{
+    delete process->notifier;
+    if (process->pidfd >= 0)
+        ::close(process->pidfd);
+    delete process;
+}
+
+void ProcessTerminator::scheduleEscalation()
+{
+    qint64 deadline = -1;
+    foreach (const Process *process, m_processes) {
+        if (process->terminated >= 0 && !process->killed && (deadline < 0 || process->killDeadline < deadline))
+            deadline = process->killDeadline;
+    }
+
+    if (deadline < 0) {
+        m_escalationTimer.stop();
+    } else {
+        m_escalationTimer.start(int(qMax<qint64>(0, deadline - m_clock.elapsed())));
+    }
+}
@@ -0,0 +1,86 @@
+/***************************************************************************
+**
+** Copyright (c) 2021 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#ifndef PROCESSTERMINATOR_H
+#define PROCESSTERMINATOR_H
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QObject>
+#include <QTimer>
+#include "lipstickglobal.h"
+
+/*!
+ * Terminates the processes of closed windows.
+ *
+ * A process is sent SIGTERM and, if it has not exited by the time the
+ * kill timeout runs out, SIGKILL. The processes are referred to through
+ * pidfds opened when their windows are created, so a signal never reaches
+ * another process that has been given the same pid after the original one
+ * exited. The pidfd also tells when the process exits, which is reported
+ * together with the time it took.
+ *
+ * All the processes share a single timer for the kill timeouts, so closing
+ * many windows at once does not start a timer for each of them. On kernels
+ * without pidfd support the signals are sent to the plain pid and exits
+ * are not reported.
+ */
+class LIPSTICK_EXPORT ProcessTerminator : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ProcessTerminator(QObject *parent = 0);
+    ~ProcessTerminator();
+
+    //! Opens a pidfd for \a pid when a window of the process is created
+    void watch(qint64 pid);
+
+    //! Sends SIGTERM to \a pid, followed by SIGKILL if it is still running after \a killTimeout milliseconds
+    void terminate(qint64 pid, int killTimeout, const QObject *window = 0);
+
+    /*!
+     * Releases \a window of \a pid. The pending SIGKILL is cancelled once the
+     * windows that terminated the process or all of its windows have gone
+     * away, and the pidfd is closed with the last window.
+     */
+    void cancel(qint64 pid, const QObject *window);
+
+    //! Returns true if \a pid has been terminated but has not exited yet
+    bool isTerminating(qint64 pid) const;
+
+signals:
+    //! Emitted when a terminated process has exited \a milliseconds after SIGTERM was sent to it
+    void processExited(qint64 pid, qint64 milliseconds, bool killed);
+
+private slots:
+    void pidfdActivated(int pidfd);
+    void escalate();
+
+private:
+    struct Process;
+
+    Process *open(qint64 pid);
+    bool sendSignal(Process *process, int signal);
+    void stopTerminating(Process *process);
+    void releaseIfUnused(Process *process);
+    void remove(Process *process);
+    void scheduleEscalation();
+
+    QHash<qint64, Process *> m_processes;
+    QTimer m_escalationTimer;
+    QElapsedTimer m_clock;
+};
+
+#endif // PROCESSTERMINATOR_H
@@ -0,0 +1,35 @@
+/***************************************************************************
+**
+** Copyright (c) 2021 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#include <QDBusError>
+#include "setupdatesenabledbatch.h"
+
+SetUpdatesEnabledBatch SetUpdatesEnabledBatch::collapse(const QList<QueuedSetUpdatesEnabledCall> &calls, const QString &mceNameOwner)
+{
+    SetUpdatesEnabledBatch batch;
+    foreach (const QueuedSetUpdatesEnabledCall &call, calls) {
+        if (call.m_message.service() != mceNameOwner) {
+            batch.denied.append(call);
+        } else {
+            batch.accepted.append(call);
+            batch.enable = call.m_enable;
+        }
+    }
+    return batch;
+}
+
+QDBusMessage SetUpdatesEnabledBatch::deniedReply(const QDBusMessage &call)
+{
+    return call.createErrorReply(QDBusError::AccessDenied, QStringLiteral("Only mce is allowed to call this method"));
+}
@@ -0,0 +1,63 @@
+/***************************************************************************
+**
+** Copyright (c) 2021 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#ifndef SETUPDATESENABLEDBATCH_H
+#define SETUPDATESENABLEDBATCH_H
+
+#include <QDBusConnection>
+#include <QDBusMessage>
+#include <QList>
+#include <QString>
+
+struct QueuedSetUpdatesEnabledCall
+{
+    QueuedSetUpdatesEnabledCall(const QDBusConnection &connection, const QDBusMessage &message, bool enable)
+    : m_connection(connection)
+    , m_message(message)
+    , m_enable(enable)
+    {
+    }
+
+    QDBusConnection m_connection;
+    QDBusMessage m_message;
+    bool m_enable;
+};
+
+/*
+ * The setUpdatesEnabled() calls queued while the compositor was busy or the
+ * owner of the mce name was not known yet, handled together.
+ *
+ * Only mce may change the display state. Of its calls only the state asked
+ * for last is applied, toggling the display through the ones before it
+ * would hide and show the window for nothing. The other callers are denied.
+ */
+struct SetUpdatesEnabledBatch
+{
+    SetUpdatesEnabledBatch() : enable(false) {}
+
+    //! Splits \a calls by whether they were made by \a mceNameOwner, keeping their order
+    static SetUpdatesEnabledBatch collapse(const QList<QueuedSetUpdatesEnabledCall> &calls, const QString &mceNameOwner);
+
+    //! Returns the error reply for a call made by someone else than mce
+    static QDBusMessage deniedReply(const QDBusMessage &call);
+
+    //! Calls of others than mce, to be denied before the state is applied
+    QList<QueuedSetUpdatesEnabledCall> denied;
+    //! Calls of mce, to be replied once the state has been applied
+    QList<QueuedSetUpdatesEnabledCall> accepted;
+    //! The state mce asked for last, meaningful only if some call was accepted
+    bool enable;
+};
+
+#endif // SETUPDATESENABLEDBATCH_H
@@ -0,0 +1,189 @@
+/***************************************************************************
+**
+** Copyright (c) 2021 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#include <QOpenGLFramebufferObject>
+#include <QOpenGLShaderProgram>
+#include <QQuickWindow>
+#include <QRunnable>
+#include <QSGTexture>
+#include <QDebug>
+#include "snapshotcapture.h"
+#include "snapshotstore.h"
+#include "tracing.h"
+
+class SnapshotCapture::RenderJob : public QRunnable
+{
+public:
+    explicit RenderJob(SnapshotCapture *capture)
+        : m_capture(capture)
+    {
+    }
+
+    void run() Q_DECL_OVERRIDE
+    {
+        m_capture->render();
+    }
+
+private:
+    SnapshotCapture *m_capture;
+};
+
+SnapshotCapture::SnapshotCapture(QQuickWindow *window)
+    : QObject(window)
+    , m_window(window)
+    , m_program(0)
+    , m_vertexLocation(-1)
+    , m_textureLocation(-1)
+    , m_jobScheduled(false)
+{
+    connect(window, &QQuickWindow::sceneGraphInvalidated, this, &SnapshotCapture::invalidate, Qt::DirectConnection);
+}
+
+SnapshotCapture::~SnapshotCapture()
+{
+    delete m_program;
+}
+
+SnapshotCapture *SnapshotCapture::instance(QQuickWindow *window)
+{
+    SnapshotCapture *capture = window->findChild<SnapshotCapture *>(QString(), Qt::FindDirectChildrenOnly);
+    if (!capture)
+        capture = new SnapshotCapture(window);
+    return capture;
+}
+
+void SnapshotCapture::capture(SnapshotTextureProvider *snapshot, QSGTexture *source, const QSize &size)
+{
+    m_captured.remove(snapshot);
+    connect(snapshot, &QObject::destroyed, this, &SnapshotCapture::snapshotDestroyed,
+            Qt::ConnectionType(Qt::DirectConnection | Qt::UniqueConnection));
+
+    const Request request = { snapshot, source, size };
+    bool replaced = false;
+    for (int i = 0; i < m_requests.count(); ++i) {
+        if (m_requests.at(i).snapshot == snapshot) {
+            m_requests[i] = request;
+            replaced = true;
+        }
+    }
+    if (!replaced)
+        m_requests.append(request);
+
+    // One job renders all the snapshots requested during the frame
+    if (!m_jobScheduled) {
+        m_jobScheduled = true;
+        m_window->scheduleRenderJob(new RenderJob(this), QQuickWindow::BeforeRenderingStage);
+    }
+}
+
+bool SnapshotCapture::takeCaptured(SnapshotTextureProvider *snapshot)
+{
+    return m_captured.remove(snapshot);
+}
+
+void SnapshotCapture::render()
+{
+    m_jobScheduled = false;
+    if (m_requests.isEmpty())
+        return;
+
+    LIPSTICK_TRACE_SCOPE("compositor", "captureSnapshots");
+
+    if (!m_program) {
+        m_program = new QOpenGLShaderProgram;
+        m_program->addShaderFromSourceCode(QOpenGLShader::Vertex,
+            "attribute highp vec4 vertex;\n"
+            "varying highp vec2 texPos;\n"
+            "void main(void) {\n"
+            "   texPos = vertex.xy;\n"
+            "   gl_Position = vec4(vertex.xy * 2.0 - 1.0, 0, 1);\n"
+            "}");
+        m_program->addShaderFromSourceCode(QOpenGLShader::Fragment,
+            "uniform sampler2D texture;\n"
+            "varying highp vec2 texPos;\n"
+            "void main(void) {\n"
+            "   gl_FragColor = texture2D(texture, texPos);\n"
+            "}");
+        if (!m_program->link())
+            qDebug() << m_program->log();
+
+        m_vertexLocation = m_program->attributeLocation("vertex");
+        m_textureLocation = m_program->uniformLocation("texture");
+    }
+
+    static GLfloat const triangleVertices[] = {
+        1.f, 0.f,
+        1.f, 1.f,
+        0.f, 0.f,
+        0.f, 1.f,
+    };
+
+    m_program->bind();
+    m_program->enableAttributeArray(m_vertexLocation);
+    m_program->setAttributeArray(m_vertexLocation, triangleVertices, 2);
+    glDisable(GL_BLEND);
+
+    foreach (const Request &request, m_requests) {
+        SnapshotTextureProvider *snapshot = request.snapshot;
+
+        // The previous snapshot is shown until it is replaced by the new one
+        QOpenGLFramebufferObject *fbo = snapshot->fbo;
+        if (!fbo || fbo->size() != request.size)
+            fbo = new QOpenGLFramebufferObject(request.size);
+
+        fbo->bind();
+        request.source->bind();
+        glViewport(0, 0, request.size.width(), request.size.height());
+        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+        fbo->release();
+
+        if (fbo != snapshot->fbo || !snapshot->t) {
+            delete snapshot->t;
+            if (fbo != snapshot->fbo)
+                delete snapshot->fbo;
+            snapshot->fbo = fbo;
+            snapshot->t = m_window->createTextureFromId(fbo->texture(), fbo->size(), 0);
+            emit snapshot->textureChanged();
+        }
+
+        SnapshotStore::instance()->snapshotTaken(snapshot);
+        m_captured.insert(snapshot);
+    }
+
+    m_program->disableAttributeArray(m_vertexLocation);
+    m_program->release();
+    m_requests.clear();
+
+    emit captured();
+}
+
+void SnapshotCapture::snapshotDestroyed(QObject *snapshot)
+{
+    SnapshotTextureProvider *destroyed = static_cast<SnapshotTextureProvider *>(snapshot);
+    m_captured.remove(destroyed);
+    for (int i = m_requests.count() - 1; i >= 0; --i) {
+        if (m_requests.at(i).snapshot == destroyed)
+            m_requests.remove(i);
+    }
+}
+
+void SnapshotCapture::invalidate()
+{
+    // The sources of the pending requests and the scheduled render job are gone with the scene graph
+    m_requests.clear();
+    m_jobScheduled = false;
+
+    delete m_program;
+    m_program = 0;
+}
@@ -0,0 +1,87 @@
+/***************************************************************************
+**
+** Copyright (c) 2021 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#ifndef SNAPSHOTCAPTURE_H
+#define SNAPSHOTCAPTURE_H
+
+#include <QObject>
+#include <QSet>
+#include <QSize>
+#include <QVector>
+
+class QOpenGLShaderProgram;
+class QQuickWindow;
+class QSGTexture;
+class SnapshotTextureProvider;
+
+/*
+ * Renders window snapshots on the render thread.
+ *
+ * Snapshots requested while the scene graph is synchronized are rendered
+ * by a single render job once the synchronization is over, so the GUI
+ * thread is not kept waiting for them and the snapshots of all windows
+ * closed during a frame share the setup. A snapshot keeps its previous
+ * texture until the new one has been rendered.
+ *
+ * Apart from instance(), the capture is used from the render thread with
+ * the scene graph context current.
+ */
+class SnapshotCapture : public QObject
+{
+    Q_OBJECT
+
+public:
+    //! Returns the capture of \a window, called from the GUI thread
+    static SnapshotCapture *instance(QQuickWindow *window);
+
+    //! Renders \a source into \a snapshot at \a size before the next frame is rendered
+    void capture(SnapshotTextureProvider *snapshot, QSGTexture *source, const QSize &size);
+    //! Returns true once after \a snapshot has been rendered
+    bool takeCaptured(SnapshotTextureProvider *snapshot);
+
+signals:
+    //! Emitted on the render thread after the requested snapshots have been rendered
+    void captured();
+
+private:
+    struct Request
+    {
+        SnapshotTextureProvider *snapshot;
+        QSGTexture *source;
+        QSize size;
+    };
+
+    class RenderJob;
+
+    explicit SnapshotCapture(QQuickWindow *window);
+    ~SnapshotCapture();
+
+    void render();
+    void snapshotDestroyed(QObject *snapshot);
+    void invalidate();
+
+    QQuickWindow *m_window;
+    QVector<Request> m_requests;
+    QSet<SnapshotTextureProvider *> m_captured;
+    QOpenGLShaderProgram *m_program;
+    int m_vertexLocation;
+    int m_textureLocation;
+    bool m_jobScheduled;
+
+#ifdef UNIT_TEST
+    friend class Ut_SnapshotCapture;
+#endif
+};
+
+#endif // SNAPSHOTCAPTURE_H
@@ -0,0 +1,213 @@
+/***************************************************************************
+**
+** Copyright (c) 2021 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#include <QOpenGLFramebufferObject>
+#include <QQuickWindow>
+#include <QSGTexture>
+#include <QDebug>
+#include "snapshotstore.h"
+
+namespace {
+
+// Default budget, enough for the covers of a full switcher
+const qint64 DefaultBudget = 32 * 1024 * 1024;
+
+qint64 residentSize(const SnapshotTextureProvider *snapshot)
+{
+    if (!snapshot->t)
+        return 0;
+
+    const QSize size = snapshot->t->textureSize();
+    return qint64(size.width()) * size.height() * 4;
+}
+
+}
+
+SnapshotTextureProvider::SnapshotTextureProvider()
+    : t(0)
+    , fbo(0)
+    , m_compressedFormat(QImage::Format_Invalid)
+    , m_lastDisplayed(0)
+    , m_visible(true)
+    , m_opaque(false)
+{
+    SnapshotStore::instance()->add(this);
+}
+
+SnapshotTextureProvider::~SnapshotTextureProvider()
+{
+    SnapshotStore::instance()->remove(this);
+    delete fbo;
+    delete t;
+}
+
+bool SnapshotTextureProvider::isEvicted() const
+{
+    return !t && !m_compressed.isEmpty();
+}
+
+SnapshotStore::SnapshotStore()
+    : m_budget(DefaultBudget)
+    , m_displayCounter(0)
+    , m_evictions(0)
+    , m_restores(0)
+{
+}
+
+SnapshotStore *SnapshotStore::instance()
+{
+    // Never destroyed, snapshots can outlive the static objects at exit
+    static SnapshotStore *store = new SnapshotStore;
+    return store;
+}
+
+qint64 SnapshotStore::budget() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_budget;
+}
+
+void SnapshotStore::setBudget(qint64 bytes)
+{
+    QMutexLocker locker(&m_mutex);
+    m_budget = bytes;
+}
+
+SnapshotStore::Statistics SnapshotStore::statistics() const
+{
+    QMutexLocker locker(&m_mutex);
+
+    Statistics statistics = { m_budget, 0, 0, m_snapshots.count(), 0, m_evictions, m_restores };
+    foreach (const SnapshotTextureProvider *snapshot, m_snapshots) {
+        statistics.residentBytes += residentSize(snapshot);
+        statistics.compressedBytes += snapshot->m_compressed.size();
+        if (snapshot->isEvicted())
+            ++statistics.evictedSnapshots;
+    }
+    return statistics;
+}
+
+void SnapshotStore::add(SnapshotTextureProvider *snapshot)
+{
+    QMutexLocker locker(&m_mutex);
+    m_snapshots.append(snapshot);
+}
+
+void SnapshotStore::remove(SnapshotTextureProvider *snapshot)
+{
+    QMutexLocker locker(&m_mutex);
+    m_snapshots.removeOne(snapshot);
+}
+
+void SnapshotStore::snapshotTaken(SnapshotTextureProvider *snapshot)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        snapshot->m_compressed.clear();
+        snapshot->m_lastDisplayed = ++m_displayCounter;
+    }
+    enforceBudget(snapshot);
+}
+
+void SnapshotStore::setDisplayed(SnapshotTextureProvider *snapshot, bool visible, bool opaque)
+{
+    QMutexLocker locker(&m_mutex);
+    snapshot->m_visible = visible;
+    snapshot->m_opaque = opaque;
+    if (visible)
+        snapshot->m_lastDisplayed = ++m_displayCounter;
+}
+
+bool SnapshotStore::restore(SnapshotTextureProvider *snapshot, QQuickWindow *window)
+{
+    QMutexLocker locker(&m_mutex);
+    if (!snapshot->isEvicted())
+        return false;
+
+    QImage image(snapshot->m_compressedSize, snapshot->m_compressedFormat);
+    const QByteArray data = qUncompress(snapshot->m_compressed);
+    if (data.size() != image.byteCount()) {
+        qWarning() << "Cannot restore a window snapshot of" << snapshot->m_compressedSize;
+        return false;
+    }
+    memcpy(image.bits(), data.constData(), data.size());
+
+    snapshot->t = window->createTextureFromImage(image, image.hasAlphaChannel()
+            ? QQuickWindow::TextureHasAlphaChannel : QQuickWindow::CreateTextureOptions());
+    ++m_restores;
+    locker.unlock();
+
+    emit snapshot->textureChanged();
+    return true;
+}
+
+void SnapshotStore::enforceBudget(const SnapshotTextureProvider *keep)
+{
+    QMutexLocker locker(&m_mutex);
+
+    qint64 resident = 0;
+    foreach (const SnapshotTextureProvider *snapshot, m_snapshots)
+        resident += residentSize(snapshot);
+
+    while (resident > m_budget) {
+        SnapshotTextureProvider *leastRecent = 0;
+        foreach (SnapshotTextureProvider *snapshot, m_snapshots) {
+            if (snapshot != keep && snapshot->t && !snapshot->m_visible
+                    && (!leastRecent || snapshot->m_lastDisplayed < leastRecent->m_lastDisplayed)) {
+                leastRecent = snapshot;
+            }
+        }
+        if (!leastRecent)
+            break;
+
+        resident -= residentSize(leastRecent);
+        evict(leastRecent);
+    }
+}
+
+void SnapshotStore::release(SnapshotTextureProvider *snapshot)
+{
+    QMutexLocker locker(&m_mutex);
+    if (snapshot->t)
+        evict(snapshot);
+}
+
+void SnapshotStore::evict(SnapshotTextureProvider *snapshot)
+{
+    // A snapshot that has been restored still has its compressed copy, there is nothing to read back
+    if (snapshot->fbo) {
+        QImage image(snapshot->fbo->size(), QImage::Format_RGBA8888_Premultiplied);
+        snapshot->fbo->bind();
+        glReadPixels(0, 0, image.width(), image.height(), GL_RGBA, GL_UNSIGNED_BYTE, image.bits());
+        snapshot->fbo->release();
+
+        // RGB565 halves the size of snapshots without transparency before compressing
+        if (snapshot->m_opaque)
+            image = image.convertToFormat(QImage::Format_RGB16);
+
+        snapshot->m_compressed = qCompress(image.constBits(), image.byteCount(), 1);
+        snapshot->m_compressedSize = image.size();
+        snapshot->m_compressedFormat = image.format();
+    }
+
+    QSGTexture *texture = snapshot->t;
+    snapshot->t = 0;
+    emit snapshot->textureChanged();
+
+    delete texture;
+    delete snapshot->fbo;
+    snapshot->fbo = 0;
+
+    ++m_evictions;
+}
@@ -0,0 +1,115 @@
+/***************************************************************************
+**
+** Copyright (c) 2021 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#ifndef SNAPSHOTSTORE_H
+#define SNAPSHOTSTORE_H
+
+#include <QImage>
+#include <QMutex>
+#include <QSGTextureProvider>
+#include <QVector>
+
+class QOpenGLFramebufferObject;
+class QQuickWindow;
+
+class SnapshotTextureProvider : public QSGTextureProvider
+{
+public:
+    SnapshotTextureProvider();
+    ~SnapshotTextureProvider();
+
+    QSGTexture *texture() const Q_DECL_OVERRIDE
+    {
+        return t;
+    }
+
+    //! Returns true if the snapshot has been moved out of GPU memory
+    bool isEvicted() const;
+
+    QSGTexture *t;
+    QOpenGLFramebufferObject *fbo;
+
+private:
+    friend class SnapshotStore;
+
+    QByteArray m_compressed;
+    QSize m_compressedSize;
+    QImage::Format m_compressedFormat;
+    quint64 m_lastDisplayed;
+    bool m_visible;
+    bool m_opaque;
+};
+
+/*
+ * Keeps the GPU memory taken by window snapshots within a budget.
+ *
+ * When the snapshots take more memory than the budget allows, the least
+ * recently displayed hidden ones are read back into compressed images and
+ * their framebuffer objects are released. An evicted snapshot is uploaded
+ * again when it is shown. Visible snapshots are never evicted, so the
+ * budget can be exceeded while many of them are shown at once.
+ *
+ * Apart from the budget and the statistics, the store is used from the
+ * render thread with the scene graph context current.
+ */
+class SnapshotStore
+{
+public:
+    struct Statistics
+    {
+        qint64 budget;
+        qint64 residentBytes;
+        qint64 compressedBytes;
+        int snapshots;
+        int evictedSnapshots;
+        quint64 evictions;
+        quint64 restores;
+    };
+
+    static SnapshotStore *instance();
+
+    qint64 budget() const;
+    void setBudget(qint64 bytes);
+
+    Statistics statistics() const;
+
+    //! Records a new snapshot rendered into the framebuffer object of \a snapshot
+    void snapshotTaken(SnapshotTextureProvider *snapshot);
+    //! Records whether \a snapshot is shown, \a opaque allows compressing it without an alpha channel
+    void setDisplayed(SnapshotTextureProvider *snapshot, bool visible, bool opaque);
+    //! Uploads an evicted snapshot again, returns false if it was not evicted
+    bool restore(SnapshotTextureProvider *snapshot, QQuickWindow *window);
+    //! Evicts hidden snapshots other than \a keep until the rest fit in the budget
+    void enforceBudget(const SnapshotTextureProvider *keep);
+    //! Evicts \a snapshot regardless of the budget, as when the scene graph is torn down
+    void release(SnapshotTextureProvider *snapshot);
+
+private:
+    friend class SnapshotTextureProvider;
+
+    SnapshotStore();
+
+    void add(SnapshotTextureProvider *snapshot);
+    void remove(SnapshotTextureProvider *snapshot);
+    void evict(SnapshotTextureProvider *snapshot);
+
+    mutable QMutex m_mutex;
+    QVector<SnapshotTextureProvider *> m_snapshots;
+    qint64 m_budget;
+    quint64 m_displayCounter;
+    quint64 m_evictions;
+    quint64 m_restores;
+};
+
+#endif // SNAPSHOTSTORE_H
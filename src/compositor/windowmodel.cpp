@@ -13,11 +13,11 @@
 ****************************************************************************/
 
 #include <QDBusConnection>
-#include <QDBusConnectionInterface>
-#include <QFileInfo>
+#include <QFile>
 #include "lipstickcompositorwindow.h"
 #include "lipstickcompositor.h"
 #include "windowmodel.h"
+#include "utilities/callercredentials.h"
 
 WindowModel::WindowModel()
 : m_complete(false)
@@ -171,27 +171,18 @@ void WindowModel::refresh()
     endResetModel();
 }
 
-bool WindowModel::isPrivileged() const
+// used by mapplauncherd to bring a binary to the front
+void WindowModel::launchProcess(const QString &binaryName)
 {
-    if (!calledFromDBus()) {
-        return true;
-    }
-
-    uint pid = connection().interface()->servicePid(message().service()).value();
-    QFileInfo info(QString("/proc/%1").arg(pid));
-    if (info.group() != QLatin1String("privileged") && info.owner() != QLatin1String("root")) {
-        QString errorString = QString("PID %1 is not in privileged group").arg(pid);
-        sendErrorReply(QDBusError::AccessDenied, errorString);
-        return false;
-    }
-    return true;
+    CallerCredentials::instance()->runPrivileged(*this, this, [this, binaryName] {
+        raiseProcess(binaryName);
+    });
 }
 
-// used by mapplauncherd to bring a binary to the front
-void WindowModel::launchProcess(const QString &binaryName)
+void WindowModel::raiseProcess(const QString &binaryName)
 {
     LipstickCompositor *c = LipstickCompositor::instance();
-    if (!m_complete || !c || !isPrivileged())
+    if (!m_complete || !c)
         return;
 
     QStringList binaryParts = binaryName.split(QRegExp(QRegExp("\\s+")));
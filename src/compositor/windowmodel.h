@@ -65,7 +65,7 @@ private:
     void titleChanged(int);
 
     void refresh();
-    bool isPrivileged() const;
+    void raiseProcess(const QString &binaryName);
 
     bool m_complete:1;
     QList<int> m_items;
@@ -18,12 +18,13 @@
 #include <QSGMaterialShader>
 #include <QSGTexture>
 #include <QSGTextureProvider>
-#include <QOpenGLFramebufferObject>
 #include <QOpenGLShaderProgram>
 #include <QWaylandSurfaceItem>
 #include "lipstickcompositorwindow.h"
 #include "lipstickcompositor.h"
 #include "windowpixmapitem.h"
+#include "snapshotcapture.h"
+#include "snapshotstore.h"
 
 namespace {
 
@@ -151,7 +152,7 @@ class SurfaceNode : public QObject, public QSGGeometryNode
 {
     Q_OBJECT
 public:
-    SurfaceNode();
+    SurfaceNode(QQuickItem *item);
     ~SurfaceNode();
     void setRect(const QRectF &);
     void setTextureProvider(QSGTextureProvider *, bool owned);
@@ -185,6 +186,7 @@ private:
     qreal m_xScale = 1;
     qreal m_yScale = 1;
 
+    QPointer<QQuickItem> m_item;
     QSGTextureProvider *m_provider = nullptr;
     QSGTexture *m_texture = nullptr;
     bool m_providerOwned = false;
@@ -409,7 +411,8 @@ int CornerSurfaceTextureMaterial::compare(const QSGMaterial *other) const
     }
 }
 
-SurfaceNode::SurfaceNode()
+SurfaceNode::SurfaceNode(QQuickItem *item)
+    : m_item(item)
 {
     setGeometry(&m_geometry);
     setMaterial(&m_material);
@@ -426,7 +429,8 @@ SurfaceNode::SurfaceNode()
 
 SurfaceNode::~SurfaceNode()
 {
-    if (m_provider && m_providerOwned)
+    // The item keeps its snapshot if the node is deleted with the scene graph
+    if (m_provider && m_providerOwned && !m_item)
         delete m_provider;
 }
 
@@ -630,37 +634,10 @@ void SurfaceNode::providerDestroyed()
 
 }
 
-SnapshotProgram *WindowPixmapItem::s_snapshotProgram = 0;
-
-struct SnapshotProgram
-{
-    QOpenGLShaderProgram program;
-    int vertexLocation;
-    int textureLocation;
-};
-
-class SnapshotTextureProvider : public QSGTextureProvider
-{
-public:
-    SnapshotTextureProvider() : t(0), fbo(0) {}
-    ~SnapshotTextureProvider()
-    {
-        delete fbo;
-        delete t;
-    }
-    QSGTexture *texture() const Q_DECL_OVERRIDE
-    {
-        return t;
-    }
-    QSGTexture *t;
-    QOpenGLFramebufferObject *fbo;
-};
-
-
 WindowPixmapItem::WindowPixmapItem()
 : m_item(0), m_id(0), m_opaque(false), m_radius(0), m_xOffset(0), m_yOffset(0)
 , m_xScale(1), m_yScale(1), m_unmapLock(0), m_hasBuffer(false), m_hasPixmap(false), m_surfaceDestroyed(false), m_haveSnapshot(false)
-, m_textureProvider(0)
+, m_snapshotDetached(false), m_snapshotPending(false), m_textureProvider(0), m_snapshotCapture(0)
 {
     setFlag(ItemHasContents);
 }
@@ -668,6 +645,13 @@ WindowPixmapItem::WindowPixmapItem()
 WindowPixmapItem::~WindowPixmapItem()
 {
     setWindowId(0);
+
+    // Without a node there is nothing else to delete the snapshot, which has no GPU resources left
+    if (m_snapshotDetached)
+        delete m_textureProvider;
+    // A snapshot being rendered is not in the node yet, and belongs to the render thread
+    else if (m_snapshotPending)
+        m_textureProvider->deleteLater();
 }
 
 int WindowPixmapItem::windowId() const
@@ -853,6 +837,18 @@ QSGNode *WindowPixmapItem::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData
 {
     SurfaceNode *node = static_cast<SurfaceNode *>(oldNode);
 
+    // The render job of the previous frame has rendered the requested snapshot, if it was not dropped
+    if (m_snapshotPending) {
+        m_snapshotPending = false;
+        if (m_snapshotCapture && m_snapshotCapture->takeCaptured(static_cast<SnapshotTextureProvider *>(m_textureProvider))) {
+            m_haveSnapshot = true;
+            if (!m_hasBuffer) {
+                delete m_unmapLock;
+                m_unmapLock = 0;
+            }
+        }
+    }
+
     if (m_item == 0 && !m_haveSnapshot) {
         if (node)
             node->setTextureProvider(0, false);
@@ -871,77 +867,21 @@ QSGNode *WindowPixmapItem::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData
     }
 
     if (!m_hasBuffer && texture) {
-        if (!m_textureProvider) {
-            SnapshotTextureProvider *prov = new SnapshotTextureProvider;
-            m_textureProvider = prov;
-
-            if (!s_snapshotProgram) {
-                s_snapshotProgram = new SnapshotProgram;
-                s_snapshotProgram->program.addShaderFromSourceCode(QOpenGLShader::Vertex,
-                    "attribute highp vec4 vertex;\n"
-                    "varying highp vec2 texPos;\n"
-                    "void main(void) {\n"
-                    "   texPos = vertex.xy;\n"
-                    "   gl_Position = vec4(vertex.xy * 2.0 - 1.0, 0, 1);\n"
-                    "}");
-                s_snapshotProgram->program.addShaderFromSourceCode(QOpenGLShader::Fragment,
-                    "uniform sampler2D texture;\n"
-                    "varying highp vec2 texPos;\n"
-                    "void main(void) {\n"
-                    "   gl_FragColor = texture2D(texture, texPos);\n"
-                    "}");
-                if (!s_snapshotProgram->program.link())
-                    qDebug() << s_snapshotProgram->program.log();
-
-                s_snapshotProgram->vertexLocation = s_snapshotProgram->program.attributeLocation("vertex");
-                s_snapshotProgram->textureLocation = s_snapshotProgram->program.uniformLocation("texture");
-
-                connect(window(), &QQuickWindow::sceneGraphInvalidated, this, &WindowPixmapItem::cleanupOpenGL);
-            }
-        }
+        QSGTextureProvider *windowProvider = provider;
+        if (!m_textureProvider)
+            m_textureProvider = new SnapshotTextureProvider;
         provider = m_textureProvider;
 
-        if (m_unmapLock) {
-            SnapshotTextureProvider *prov = static_cast<SnapshotTextureProvider *>(provider);
-
-            if (!prov->fbo || prov->fbo->size() != QSize(width(), height())) {
-                delete prov->fbo;
-                delete prov->t;
-                prov->t = 0;
-                prov->fbo = new QOpenGLFramebufferObject(width(), height());
-            }
-
-            prov->fbo->bind();
-            s_snapshotProgram->program.bind();
-
-            texture->bind();
-
-            static GLfloat const triangleVertices[] = {
-                1.f, 0.f,
-                1.f, 1.f,
-                0.f, 0.f,
-                0.f, 1.f,
-            };
-            s_snapshotProgram->program.enableAttributeArray(s_snapshotProgram->vertexLocation);
-            s_snapshotProgram->program.setAttributeArray(s_snapshotProgram->vertexLocation, triangleVertices, 2);
-
-            glViewport(0, 0, width(), height());
-            glDisable(GL_BLEND);
-            glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-
-            s_snapshotProgram->program.release();
-
-            if (!prov->t) {
-                prov->t = window()->createTextureFromId(prov->fbo->texture(), prov->fbo->size(), 0);
-                emit prov->textureChanged();
-            }
-            prov->fbo->release();
-            delete m_unmapLock;
-            m_unmapLock = 0;
-            s_snapshotProgram->program.disableAttributeArray(s_snapshotProgram->vertexLocation);
-
-            m_haveSnapshot = true;
+        if (m_unmapLock && !m_snapshotPending && m_snapshotCapture) {
+            // Rendered by a render job once the synchronization is over
+            m_snapshotCapture->capture(static_cast<SnapshotTextureProvider *>(m_textureProvider),
+                                       texture, QSize(width(), height()));
+            m_snapshotPending = true;
         }
+
+        // The unmapped window is shown until its snapshot has been rendered
+        if (m_snapshotPending)
+            provider = windowProvider;
     } else if (!m_hasBuffer && m_textureProvider) {
         provider = m_textureProvider;
     } else if (!provider) {
@@ -953,16 +893,29 @@ QSGNode *WindowPixmapItem::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData
     // The else case here is no buffer and no screenshot, so no way to show a sane image.
     // It should normally not happen, though.
 
-    if (provider != m_textureProvider) {
+    if (provider != m_textureProvider && !m_snapshotPending) {
         delete m_textureProvider;
         m_textureProvider = 0;
+        m_snapshotDetached = false;
+    }
+
+    bool evicted = false;
+    if (provider == m_textureProvider) {
+        // Snapshots of hidden covers may be moved out of GPU memory, and are uploaded again when shown
+        SnapshotTextureProvider *snapshot = static_cast<SnapshotTextureProvider *>(m_textureProvider);
+        SnapshotStore *store = SnapshotStore::instance();
+        store->setDisplayed(snapshot, isVisible(), m_opaque);
+        if (isVisible())
+            store->restore(snapshot, window());
+        store->enforceBudget(snapshot);
+        evicted = snapshot->isEvicted();
     }
 
-    if (m_surfaceDestroyed && m_item) {
+    if (m_surfaceDestroyed && m_item && !m_snapshotPending) {
         m_item->setDelayRemove(false);
     }
 
-    if (!provider->texture()) {
+    if (!provider->texture() && !evicted) {
         qWarning("WindowPixmapItem does not have a source texture, cover will be dropped..");
         if (node) {
             node->setTextureProvider(0, false);
@@ -971,9 +924,11 @@ QSGNode *WindowPixmapItem::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData
         return 0;
     }
 
-    if (!node) node = new SurfaceNode;
+    if (!node) node = new SurfaceNode(this);
 
     node->setTextureProvider(provider, provider == m_textureProvider);
+    if (provider == m_textureProvider)
+        m_snapshotDetached = false;
     node->setRect(QRectF(0, 0, width(), height()));
     node->setBlending(!m_opaque);
     node->setRadius(m_radius);
@@ -986,6 +941,23 @@ QSGNode *WindowPixmapItem::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData
     return node;
 }
 
+void WindowPixmapItem::itemChange(ItemChange change, const ItemChangeData &data)
+{
+    if (change == ItemSceneChange) {
+        if (m_snapshotCapture)
+            disconnect(m_snapshotCapture, &SnapshotCapture::captured, this, &WindowPixmapItem::snapshotCaptured);
+        m_snapshotCapture = data.window ? SnapshotCapture::instance(data.window) : 0;
+        if (m_snapshotCapture)
+            connect(m_snapshotCapture, &SnapshotCapture::captured, this, &WindowPixmapItem::snapshotCaptured);
+    }
+
+    // Lets the snapshot store know whether the snapshot is shown
+    if (change == ItemVisibleHasChanged && m_haveSnapshot)
+        update();
+
+    QQuickItem::itemChange(change, data);
+}
+
 void WindowPixmapItem::updateItem()
 {
     LipstickCompositor *c = LipstickCompositor::instance();
@@ -1034,11 +1006,22 @@ void WindowPixmapItem::configure(bool hasBuffer)
     }
 }
 
-void WindowPixmapItem::cleanupOpenGL()
+void WindowPixmapItem::invalidateSceneGraph()
+{
+    // Called on the render thread with the context current when the scene graph is torn down,
+    // the node of the snapshot is already gone. The snapshot is read back into a compressed
+    // copy and uploaded again once the cover is shown.
+    if (m_textureProvider) {
+        SnapshotStore::instance()->release(static_cast<SnapshotTextureProvider *>(m_textureProvider));
+        m_snapshotDetached = true;
+    }
+}
+
+void WindowPixmapItem::snapshotCaptured()
 {
-    disconnect(window(), &QQuickWindow::sceneGraphInvalidated, this, &WindowPixmapItem::cleanupOpenGL);
-    delete s_snapshotProgram;
-    s_snapshotProgram = 0;
+    // Swaps the window for its snapshot
+    if (m_snapshotPending)
+        update();
 }
 
 #include "windowpixmapitem.moc"
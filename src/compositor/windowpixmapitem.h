@@ -23,6 +23,7 @@ class QWaylandUnmapLock;
 
 class LipstickCompositor;
 class LipstickCompositorWindow;
+class SnapshotCapture;
 class LIPSTICK_EXPORT WindowPixmapItem : public QQuickItem
 {
     Q_OBJECT
@@ -68,6 +69,7 @@ public:
 
 protected:
     QSGNode *updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *);
+    void itemChange(ItemChange change, const ItemChangeData &data);
 
 signals:
     void windowIdChanged();
@@ -83,12 +85,13 @@ signals:
 private slots:
     void handleWindowSizeChanged();
     void itemDestroyed(QObject *);
+    void invalidateSceneGraph();
+    void snapshotCaptured();
 
 private:
     void updateItem();
     void surfaceDestroyed();
     void configure(bool hasBuffer);
-    void cleanupOpenGL();
 
     QPointer<LipstickCompositorWindow> m_item;
     int m_id;
@@ -104,9 +107,10 @@ private:
     bool m_hasPixmap;
     bool m_surfaceDestroyed;
     bool m_haveSnapshot;
+    bool m_snapshotDetached;
+    bool m_snapshotPending;
     QSGTextureProvider *m_textureProvider;
-
-    static struct SnapshotProgram *s_snapshotProgram;
+    SnapshotCapture *m_snapshotCapture;
 };
 
 #endif // WINDOWPIXMAPITEM_H
@@ -0,0 +1,104 @@
+/***************************************************************************
+**
+** Copyright (c) 2021 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#ifndef WINDOWPROPERTYCACHE_H
+#define WINDOWPROPERTYCACHE_H
+
+#include <QHash>
+#include <QList>
+#include <QPair>
+#include <QVariant>
+
+/*
+ * Keeps the window properties the compositor itself needs, so that they
+ * are not looked up from the property map of the surface every time.
+ *
+ * The WINID property links windows of the same process, for example an
+ * application window and its cover. Several windows of a process may have
+ * the same WINID; a lookup returns the most recently linked one first.
+ */
+template <typename Window>
+class WindowPropertyCache
+{
+public:
+    //! Sets the WINID of \a window, which belongs to the process \a processId. 0 removes the link.
+    void setLink(Window *window, qint64 processId, uint link)
+    {
+        Properties &properties = m_properties[window];
+        if (properties.processId == processId && properties.link == link) {
+            return;
+        }
+
+        removeLink(window, properties);
+        properties.processId = processId;
+        properties.link = link;
+        if (link) {
+            m_links.insert(qMakePair(processId, link), window);
+        }
+    }
+
+    //! Returns the windows of the process \a processId with the WINID \a link, the most recently linked first
+    QList<Window *> linkedWindows(qint64 processId, uint link) const
+    {
+        return link ? m_links.values(qMakePair(processId, link)) : QList<Window *>();
+    }
+
+    //! Sets the NOTIFICATION_PREVIEWS_DISABLED property of \a window
+    void setNotificationPreviewsDisabled(Window *window, const QVariant &value)
+    {
+        bool ok = false;
+        const int mode = value.toInt(&ok);
+        m_properties[window].notificationPreviewsDisabled = ok && mode >= 0 ? mode : -1;
+    }
+
+    //! Returns the NOTIFICATION_PREVIEWS_DISABLED property of \a window, or \a defaultValue if it is not set
+    uint notificationPreviewsDisabled(Window *window, uint defaultValue) const
+    {
+        typename QHash<Window *, Properties>::const_iterator it = m_properties.constFind(window);
+        return it != m_properties.constEnd() && it->notificationPreviewsDisabled >= 0
+                ? uint(it->notificationPreviewsDisabled) : defaultValue;
+    }
+
+    //! Forgets \a window
+    void removeWindow(Window *window)
+    {
+        typename QHash<Window *, Properties>::iterator it = m_properties.find(window);
+        if (it != m_properties.end()) {
+            removeLink(window, *it);
+            m_properties.erase(it);
+        }
+    }
+
+private:
+    struct Properties
+    {
+        Properties() : processId(0), link(0), notificationPreviewsDisabled(-1) {}
+
+        qint64 processId;
+        uint link;
+        int notificationPreviewsDisabled;
+    };
+
+    void removeLink(Window *window, const Properties &properties)
+    {
+        if (properties.link) {
+            m_links.remove(qMakePair(properties.processId, properties.link), window);
+        }
+    }
+
+    QHash<Window *, Properties> m_properties;
+    QMultiHash<QPair<qint64, uint>, Window *> m_links;
+};
+
+#endif // WINDOWPROPERTYCACHE_H
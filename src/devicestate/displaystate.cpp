@@ -57,69 +57,36 @@ DisplayStateMonitor::~DisplayStateMonitor() {
 }
 
 void DisplayStateMonitor::connectNotify(const QMetaMethod &signal) {
-    Q_D(DisplayStateMonitor);
-
-    /* QObject::connect() needs to be thread-safe */
-    QMutexLocker locker(&d->connectMutex);
-
-    if (signal == QMetaMethod::fromSignal(&DisplayStateMonitor::displayStateChanged)) {
-        if (0 == d->connectCount[SIGNAL_DISPLAY_STATE]) {
-            QDBusConnection::systemBus().connect(MCE_SERVICE,
-                                                 MCE_SIGNAL_PATH,
-                                                 MCE_SIGNAL_IF,
-                                                 MCE_DISPLAY_SIG,
-                                                 d,
-                                                 SLOT(slotDisplayStateChanged(QString)));
-
-            QDBusConnection::systemBus().callWithCallback(
-                        QDBusMessage::createMethodCall(
-                            MCE_SERVICE, MCE_REQUEST_PATH, MCE_REQUEST_IF, MCE_DISPLAY_STATUS_GET),
-                            d,
-                            SLOT(slotDisplayStateChanged(QString)));
-        }
-        d->connectCount[SIGNAL_DISPLAY_STATE]++;
-    }
+    // DisplayStateMonitorPrivate is subscribed to the change signal for its whole lifetime
+    QObject::connectNotify(signal);
 }
 
 void DisplayStateMonitor::disconnectNotify(const QMetaMethod &signal) {
-    Q_D(DisplayStateMonitor);
-
-    /* QObject::disconnect() needs to be thread-safe */
-    QMutexLocker locker(&d->connectMutex);
-
-    if (signal == QMetaMethod::fromSignal(&DisplayStateMonitor::displayStateChanged)) {
-        d->connectCount[SIGNAL_DISPLAY_STATE]--;
-
-        if (0 == d->connectCount[SIGNAL_DISPLAY_STATE]) {
-            QDBusConnection::systemBus().disconnect(MCE_SERVICE,
-                                                    MCE_SIGNAL_PATH,
-                                                    MCE_SIGNAL_IF,
-                                                    MCE_DISPLAY_SIG,
-                                                    d,
-                                                    SLOT(slotDisplayStateChanged(QString)));
-        }
-    }
+    QObject::disconnectNotify(signal);
 }
 
 DisplayStateMonitor::DisplayState DisplayStateMonitor::get() const {
-    DisplayStateMonitor::DisplayState state = Unknown;
+    DisplayState state = lastKnown();
+    if (state != Unknown) {
+        return state;
+    }
+
+    // Neither the snapshot nor mce has told the state yet
     QDBusReply<QString> displayStateReply = QDBusConnection::systemBus().call(
                                                 QDBusMessage::createMethodCall(MCE_SERVICE, MCE_REQUEST_PATH, MCE_REQUEST_IF,
                                                                                MCE_DISPLAY_STATUS_GET));
     if (!displayStateReply.isValid()) {
-        return state;
+        return Unknown;
     }
 
-    QString stateStr = displayStateReply.value();
+    return DisplayStateMonitorPrivate::stringToState(displayStateReply.value());
+}
 
-    if (stateStr == MCE_DISPLAY_DIM_STRING) {
-        state = Dimmed;
-    } else if (stateStr == MCE_DISPLAY_ON_STRING) {
-        state = On;
-    } else if (stateStr == MCE_DISPLAY_OFF_STRING) {
-        state = Off;
-    }
-    return state;
+DisplayStateMonitor::DisplayState DisplayStateMonitor::lastKnown() const {
+    Q_D(const DisplayStateMonitor);
+
+    QMutexLocker locker(&d->stateMutex);
+    return d->state;
 }
 
 bool DisplayStateMonitor::set(DisplayStateMonitor::DisplayState state) {
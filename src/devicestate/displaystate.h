@@ -78,6 +78,15 @@ public:
      */
     DisplayState get() const;
 
+    /*!
+     * @brief Gets the last known display state without querying mce
+     *
+     * Right after construction this is the state recorded earlier during
+     * the same boot, if any. It is kept current once mce has replied.
+     * @return Last known display state, Unknown if there is none
+     */
+    DisplayState lastKnown() const;
+
     /*!
      * @brief Sets the current display state.
      * @param state Display state new set
@@ -30,14 +30,15 @@
 #define DISPLAYSTATE_P_H
 
 #include "displaystate.h"
+#include "statesnapshot_p.h"
 
+#include <QDBusConnection>
+#include <QDBusMessage>
 #include <QMutex>
 
 #include "mce/dbus-names.h"
 #include "mce/mode-names.h"
 
-#define SIGNAL_DISPLAY_STATE 0
-
 namespace DeviceState
 {
     class DisplayStateMonitorPrivate : public QObject
@@ -45,28 +46,96 @@ namespace DeviceState
         Q_OBJECT;
 
     public:
-        DisplayStateMonitorPrivate() {
-            connectCount[SIGNAL_DISPLAY_STATE] = 0;
+        DisplayStateMonitorPrivate()
+            : state(validState(StateSnapshot::instance()->value(SnapshotKey, DisplayStateMonitor::Unknown)))
+            , stateReceived(false) {
+            // The state seeded from the snapshot is reconciled with mce and then
+            // tracked for the whole lifetime of the object.
+            QDBusConnection::systemBus().connect(MCE_SERVICE,
+                                                 MCE_SIGNAL_PATH,
+                                                 MCE_SIGNAL_IF,
+                                                 MCE_DISPLAY_SIG,
+                                                 this,
+                                                 SLOT(slotDisplayStateChanged(QString)));
+
+            QDBusConnection::systemBus().callWithCallback(
+                        QDBusMessage::createMethodCall(
+                            MCE_SERVICE, MCE_REQUEST_PATH, MCE_REQUEST_IF, MCE_DISPLAY_STATUS_GET),
+                            this,
+                            SLOT(initialDisplayStateReceived(QString)));
         }
 
         ~DisplayStateMonitorPrivate() {
+            QDBusConnection::systemBus().disconnect(MCE_SERVICE,
+                                                    MCE_SIGNAL_PATH,
+                                                    MCE_SIGNAL_IF,
+                                                    MCE_DISPLAY_SIG,
+                                                    this,
+                                                    SLOT(slotDisplayStateChanged(QString)));
+        }
+
+        static DisplayStateMonitor::DisplayState stringToState(const QString &state) {
+            if (state == MCE_DISPLAY_OFF_STRING)
+                return DisplayStateMonitor::Off;
+            else if (state == MCE_DISPLAY_DIM_STRING)
+                return DisplayStateMonitor::Dimmed;
+            else if (state == MCE_DISPLAY_ON_STRING)
+                return DisplayStateMonitor::On;
+            return DisplayStateMonitor::Unknown;
+        }
+
+        static DisplayStateMonitor::DisplayState validState(int state) {
+            switch (state) {
+            case DisplayStateMonitor::Off:
+            case DisplayStateMonitor::Dimmed:
+            case DisplayStateMonitor::On:
+                return static_cast<DisplayStateMonitor::DisplayState>(state);
+            default:
+                return DisplayStateMonitor::Unknown;
+            }
         }
 
-        QMutex connectMutex;
-        size_t connectCount[1];
+        static constexpr const char *SnapshotKey = "display";
+
+        mutable QMutex stateMutex;
+        // Last state reported by mce, or the one from the snapshot until mce replies
+        DisplayStateMonitor::DisplayState state;
+        bool stateReceived;
 
     Q_SIGNALS:
         void displayStateChanged(DeviceState::DisplayStateMonitor::DisplayState);
 
     private Q_SLOTS:
+        void slotDisplayStateChanged(const QString &state) {
+            // A change indication is always newer than the initial query
+            stateReceived = true;
+            update(stringToState(state));
+        }
 
-        void slotDisplayStateChanged(const QString& state) {
-            if (state == MCE_DISPLAY_OFF_STRING)
-                emit displayStateChanged(DisplayStateMonitor::Off);
-            else if (state == MCE_DISPLAY_DIM_STRING)
-                emit displayStateChanged(DisplayStateMonitor::Dimmed);
-            else if (state == MCE_DISPLAY_ON_STRING)
-                emit displayStateChanged(DisplayStateMonitor::On);
+        void initialDisplayStateReceived(const QString &state) {
+            if (!stateReceived) {
+                stateReceived = true;
+                update(stringToState(state));
+            }
+        }
+
+    private:
+        void update(DisplayStateMonitor::DisplayState newState) {
+            if (newState == DisplayStateMonitor::Unknown) {
+                return;
+            }
+
+            {
+                QMutexLocker locker(&stateMutex);
+                if (state == newState) {
+                    // The snapshot was right, nothing to re-evaluate
+                    return;
+                }
+                state = newState;
+            }
+
+            StateSnapshot::instance()->setValue(SnapshotKey, newState);
+            emit displayStateChanged(newState);
         }
     };
 }
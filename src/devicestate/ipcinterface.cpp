@@ -54,6 +54,16 @@ void IPCInterface::callAsynchronously(const QString& method,
     (void)call(QDBus::NoBlock, method, arg1, arg2);
 }
 
+bool IPCInterface::getAsync(const QString& method,
+                            QObject *receiver,
+                            const char *returnMethod,
+                            const char *errorMethod) {
+    if (errorMethod) {
+        return callWithCallback(method, QList<QVariant>(), receiver, returnMethod, errorMethod);
+    }
+    return callWithCallback(method, QList<QVariant>(), receiver, returnMethod);
+}
+
 QList<QVariant> IPCInterface::get(const QString& method,
                                     const QVariant& arg1,
                                     const QVariant& arg2) {
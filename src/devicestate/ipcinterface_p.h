@@ -61,6 +61,15 @@ public:
     void callAsynchronously(const QString& method,
                             const QVariant& arg1 = QVariant(),
                             const QVariant& arg2 = QVariant());
+    /*
+     * Makes a non-blocking call whose reply is delivered to returnMethod of
+     * receiver, and a possible error to errorMethod. Use this instead of get()
+     * on the GUI thread to avoid waiting for the remote service.
+     */
+    bool getAsync(const QString& method,
+                  QObject *receiver,
+                  const char *returnMethod,
+                  const char *errorMethod = 0);
 };
 
 } // DeviceState namespace
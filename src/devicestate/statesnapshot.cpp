@@ -0,0 +1,117 @@
+/*!
+ * @file statesnapshot.cpp
+ * @brief StateSnapshot
+
+   <p>
+   Copyright (c) 2021 Jolla Ltd.
+
+   This file is part of SystemSW QtAPI.
+
+   SystemSW QtAPI is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License
+   version 2.1 as published by the Free Software Foundation.
+
+   SystemSW QtAPI is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with SystemSW QtAPI.  If not, see <http://www.gnu.org/licenses/>.
+   </p>
+ */
+#include "statesnapshot_p.h"
+
+#include <QFile>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+namespace DeviceState {
+
+namespace {
+const char *const BootIdFile = "/proc/sys/kernel/random/boot_id";
+const char *const SnapshotFileName = "/lipstick-devicestate";
+}
+
+StateSnapshot *StateSnapshot::instance() {
+    static StateSnapshot snapshot;
+    return &snapshot;
+}
+
+StateSnapshot::StateSnapshot() {
+    QFile bootIdFile(BootIdFile);
+    if (bootIdFile.open(QIODevice::ReadOnly)) {
+        bootId = bootIdFile.readAll().trimmed();
+    }
+
+    const QString runtimeDir = QStandardPaths::writableLocation(QStandardPaths::RuntimeLocation);
+    if (!runtimeDir.isEmpty() && !bootId.isEmpty()) {
+        path = runtimeDir + SnapshotFileName;
+        load();
+    }
+}
+
+StateSnapshot::StateSnapshot(const QString &path, const QByteArray &bootId)
+    : path(path)
+    , bootId(bootId) {
+    load();
+}
+
+void StateSnapshot::load() {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+
+    // The first line is the boot id the snapshot was written during
+    if (file.readLine().trimmed() != bootId) {
+        return;
+    }
+
+    while (!file.atEnd()) {
+        const QByteArray line = file.readLine().trimmed();
+        const int separator = line.indexOf('=');
+        bool ok = false;
+        const int value = line.mid(separator + 1).toInt(&ok);
+        if (separator > 0 && ok) {
+            values.insert(QString::fromLatin1(line.left(separator)), value);
+        }
+    }
+}
+
+void StateSnapshot::save() {
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning("StateSnapshot: cannot write %s: %s", qPrintable(path), qPrintable(file.errorString()));
+        return;
+    }
+
+    QByteArray data = bootId + '\n';
+    for (QHash<QString, int>::const_iterator it = values.constBegin(); it != values.constEnd(); ++it) {
+        data += it.key().toLatin1() + '=' + QByteArray::number(it.value()) + '\n';
+    }
+    file.write(data);
+    file.commit();
+}
+
+int StateSnapshot::value(const QString &key, int defaultValue) const {
+    QMutexLocker locker(&mutex);
+
+    return values.value(key, defaultValue);
+}
+
+void StateSnapshot::setValue(const QString &key, int value) {
+    QMutexLocker locker(&mutex);
+
+    QHash<QString, int>::iterator it = values.find(key);
+    if (it != values.end() && it.value() == value) {
+        return;
+    }
+    values.insert(key, value);
+
+    if (!path.isEmpty()) {
+        save();
+    }
+}
+
+} // DeviceState namespace
@@ -0,0 +1,72 @@
+/*!
+ * @file statesnapshot_p.h
+ * @brief Contains StateSnapshot
+
+   <p>
+   Copyright (c) 2021 Jolla Ltd.
+
+   @scope Private
+
+   This file is part of SystemSW QtAPI.
+
+   SystemSW QtAPI is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License
+   version 2.1 as published by the Free Software Foundation.
+
+   SystemSW QtAPI is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with SystemSW QtAPI.  If not, see <http://www.gnu.org/licenses/>.
+   </p>
+ */
+#ifndef STATESNAPSHOT_P_H
+#define STATESNAPSHOT_P_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QMutex>
+#include <QString>
+
+#ifdef UNIT_TEST
+class Ut_StateSnapshot;
+#endif
+
+namespace DeviceState
+{
+    /*
+     * Last known device states, kept in a small file in the runtime
+     * directory so that they can be read synchronously at startup and
+     * reconciled with the system services afterwards. The runtime
+     * directory is a tmpfs and a snapshot written during a previous boot
+     * is ignored, so a stale value never outlives the boot it belongs to.
+     */
+    class StateSnapshot
+    {
+    public:
+        static StateSnapshot *instance();
+
+        //! Returns the value stored for \a key, or \a defaultValue if there is none
+        int value(const QString &key, int defaultValue) const;
+        //! Stores \a value for \a key, writing the snapshot only if it changed
+        void setValue(const QString &key, int value);
+
+    private:
+        StateSnapshot();
+        StateSnapshot(const QString &path, const QByteArray &bootId);
+        void load();
+        void save();
+
+        mutable QMutex mutex;
+        QString path;
+        QByteArray bootId;
+        QHash<QString, int> values;
+
+#ifdef UNIT_TEST
+        friend class ::Ut_StateSnapshot;
+#endif
+    };
+}
+#endif // STATESNAPSHOT_P_H
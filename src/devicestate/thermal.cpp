@@ -28,7 +28,6 @@
  */
 #include "thermal.h"
 #include "thermal_p.h"
-#include <QMetaMethod>
 
 namespace DeviceState {
 
@@ -50,58 +49,10 @@ Thermal::~Thermal() {
     delete d_ptr;
 }
 
-void Thermal::connectNotify(const QMetaMethod &signal) {
-    Q_D(Thermal);
-
-    /* QObject::connect() needs to be thread-safe */
-    QMutexLocker locker(&d->connectMutex);
-
-    if (signal == QMetaMethod::fromSignal(&Thermal::thermalChanged)) {
-        if (0 == d->connectCount[SIGNAL_THERMAL_STATE]) {
-            QDBusConnection::systemBus().connect("",
-                                                 thermalmanager_path,
-                                                 thermalmanager_interface,
-                                                 thermalmanager_state_change_ind,
-                                                 d,
-                                                 SLOT(thermalStateChanged(const QString&)));
-        }
-        d->connectCount[SIGNAL_THERMAL_STATE]++;
-    }
-}
-
-void Thermal::disconnectNotify(const QMetaMethod &signal) {
-    Q_D(Thermal);
-
-    /* QObject::disconnect() needs to be thread-safe */
-    QMutexLocker locker(&d->connectMutex);
-
-    if (signal == QMetaMethod::fromSignal(&Thermal::thermalChanged)) {
-        d->connectCount[SIGNAL_THERMAL_STATE]--;
-
-        if (0 == d->connectCount[SIGNAL_THERMAL_STATE]) {
-            QDBusConnection::systemBus().disconnect("",
-                                                    thermalmanager_path,
-                                                    thermalmanager_interface,
-                                                    thermalmanager_state_change_ind,
-                                                    d,
-                                                    SLOT(thermalStateChanged(const QString&)));
-        }
-    }
-}
-
 Thermal::ThermalState Thermal::get() const {
     Q_D(const Thermal);
-    QString state;
-    QList<QVariant> resp;
-
-    resp = d->If->get(thermalmanager_get_thermal_state);
-
-    if (resp.isEmpty()) {
-        return Error;
-    }
 
-    state = resp[0].toString();
-    return ThermalPrivate::stringToState(state);
+    return d->state;
 }
 
 } // DeviceState namespace
@@ -81,6 +81,10 @@ public:
 
     /*!
      * @brief Gets the current thermal state.
+     *
+     * The state is cached from the thermal manager and never blocks. Until
+     * the thermal manager has answered, it is the state last known during
+     * this boot, or Unknown if there is none.
      * @return Current thermal state
      */
     ThermalState get() const;
@@ -92,10 +96,6 @@ Q_SIGNALS:
      */
     void thermalChanged(DeviceState::Thermal::ThermalState state);
 
-protected:
-    void connectNotify(const QMetaMethod &signal);
-    void disconnectNotify(const QMetaMethod &signal);
-
 private:
     Q_DISABLE_COPY(Thermal)
     Q_DECLARE_PRIVATE(Thermal)
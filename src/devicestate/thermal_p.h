@@ -31,13 +31,12 @@
 
 #include "thermal.h"
 #include "ipcinterface_p.h"
+#include "statesnapshot_p.h"
 
 #include <dsme/thermalmanager_dbus_if.h>
 
-#include <QMutex>
-
-
-#define SIGNAL_THERMAL_STATE 0
+#include <QDBusConnection>
+#include <QDBusError>
 
 namespace DeviceState
 {
@@ -46,15 +45,35 @@ namespace DeviceState
         Q_OBJECT
 
     public:
-        ThermalPrivate() {
+        ThermalPrivate()
+            : state(validState(StateSnapshot::instance()->value(SnapshotKey, Thermal::Unknown)))
+            , stateReceived(false) {
             If = new IPCInterface(thermalmanager_service,
                                   thermalmanager_path,
                                   thermalmanager_interface);
 
-            connectCount[SIGNAL_THERMAL_STATE] = 0;
+            // The state is seeded from the snapshot and tracked for the whole
+            // lifetime of the object so that Thermal::get() can be answered
+            // without a round trip to dsme.
+            QDBusConnection::systemBus().connect("",
+                                                 thermalmanager_path,
+                                                 thermalmanager_interface,
+                                                 thermalmanager_state_change_ind,
+                                                 this,
+                                                 SLOT(thermalStateChanged(const QString&)));
+            If->getAsync(thermalmanager_get_thermal_state,
+                         this,
+                         SLOT(initialThermalStateReceived(const QString&)),
+                         SLOT(initialThermalStateFailed(const QDBusError&)));
         }
 
         ~ThermalPrivate() {
+            QDBusConnection::systemBus().disconnect("",
+                                                    thermalmanager_path,
+                                                    thermalmanager_interface,
+                                                    thermalmanager_state_change_ind,
+                                                    this,
+                                                    SLOT(thermalStateChanged(const QString&)));
             if (If) {
                 delete If, If = 0;
             }
@@ -75,8 +94,22 @@ namespace DeviceState
             return mState;
         }
 
-        QMutex connectMutex;
-        size_t connectCount[1];
+        static Thermal::ThermalState validState(int state) {
+            switch (state) {
+            case Thermal::Normal:
+            case Thermal::Warning:
+            case Thermal::Alert:
+            case Thermal::LowTemperatureWarning:
+                return static_cast<Thermal::ThermalState>(state);
+            default:
+                return Thermal::Unknown;
+            }
+        }
+
+        static constexpr const char *SnapshotKey = "thermal";
+
+        Thermal::ThermalState state;
+        bool stateReceived;
         IPCInterface *If;
 
     Q_SIGNALS:
@@ -84,7 +117,30 @@ namespace DeviceState
 
     private Q_SLOTS:
         void thermalStateChanged(const QString &state) {
-            emit thermalChanged(ThermalPrivate::stringToState(state));
+            // A change indication is always newer than the initial query
+            stateReceived = true;
+            this->state = ThermalPrivate::stringToState(state);
+            StateSnapshot::instance()->setValue(SnapshotKey, this->state);
+            emit thermalChanged(this->state);
+        }
+
+        void initialThermalStateReceived(const QString &state) {
+            if (!stateReceived) {
+                stateReceived = true;
+                Thermal::ThermalState seededState = this->state;
+                this->state = ThermalPrivate::stringToState(state);
+                StateSnapshot::instance()->setValue(SnapshotKey, this->state);
+                if (seededState != Thermal::Unknown && seededState != this->state) {
+                    // Users may have acted on a stale snapshot
+                    emit thermalChanged(this->state);
+                }
+            }
+        }
+
+        void initialThermalStateFailed(const QDBusError &error) {
+            // The seeded state remains the best known one, and the next
+            // change indication replaces it
+            qWarning("Thermal: failed to query thermal state: %s", qPrintable(error.message()));
         }
     };
 }
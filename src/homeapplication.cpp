@@ -51,6 +51,7 @@
 #include "connmanvpnagent.h"
 #include "connmanvpnproxy.h"
 #include "connectivitymonitor.h"
+#include "traceservice.h"
 
 #include <nemo-devicelock/devicelock.h>
 
@@ -63,9 +64,10 @@ void HomeApplication::quitSignalHandler(int)
 
 int HomeApplication::s_quitSignalFd = -1;
 
-static void registerDBusObject(QDBusConnection &bus, const char *path, QObject *object)
+static void registerDBusObject(QDBusConnection &bus, const char *path, QObject *object,
+                               QDBusConnection::RegisterOptions options = QDBusConnection::ExportAdaptors)
 {
-    if (!bus.registerObject(path, object)) {
+    if (!bus.registerObject(path, object, options)) {
         qWarning("Unable to register object at path %s: %s", path, bus.lastError().message().toUtf8().constData());
     }
 }
@@ -179,6 +181,11 @@ HomeApplication::HomeApplication(int &argc, char **argv, const QString &qmlPath)
 
     registerVpnAgent();
 
+    // Recording and writing out traces of the notification, launcher, compositor and input paths
+    QDBusConnection sessionBus = QDBusConnection::sessionBus();
+    registerDBusObject(sessionBus, LIPSTICK_DBUS_TRACE_PATH, new TraceService(this), QDBusConnection::ExportAllSlots);
+    sessionBus.registerService(LIPSTICK_DBUS_SERVICE_NAME);
+
     // Setting up the context and engine things
     m_qmlEngine->rootContext()->setContextProperty("initialSize", QGuiApplication::primaryScreen()->size());
     m_qmlEngine->rootContext()->setContextProperty("lipstickSettings", LipstickSettings::instance());
@@ -366,6 +373,7 @@ void HomeApplication::setCompositorPath(const QString &path)
             LipstickCompositor::instance()->setGeometry(QRect(QPoint(0, 0), QGuiApplication::primaryScreen()->size()));
             connect(m_usbModeSelector, SIGNAL(showUnlockScreen()),
                     LipstickCompositor::instance(), SIGNAL(showUnlockScreen()));
+            m_screenLock->setLockScreenWindow(LipstickCompositor::instance());
         }
 
         component.completeCreate();
@@ -0,0 +1,44 @@
+/***************************************************************************
+**
+** Copyright (c) 2021 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#ifndef HOMEQUICKWINDOW_P_H
+#define HOMEQUICKWINDOW_P_H
+
+#include <QQuickWindow>
+
+/*
+ * The window of a HomeWindow that is not the compositor. Close events are
+ * dropped in event() instead of through an event filter so that the events
+ * the window does handle are not routed through an extra object.
+ */
+class HomeQuickWindow : public QQuickWindow
+{
+public:
+    HomeQuickWindow() : closeEventsIgnored(false) {}
+
+    bool closeEventsIgnored;
+
+protected:
+    bool event(QEvent *event) Q_DECL_OVERRIDE
+    {
+        // Keep the window from reacting to CTRL-Q presses and the like
+        if (closeEventsIgnored && event->type() == QEvent::Close) {
+            event->ignore();
+            return true;
+        }
+        return QQuickWindow::event(event);
+    }
+};
+
+#endif
@@ -20,6 +20,7 @@
 #include <QQmlContext>
 #include <QGuiApplication>
 #include "homeapplication.h"
+#include "homequickwindow_p.h"
 #include "compositor/lipstickcompositorprocwindow.h"
 #include "compositor/lipstickcompositor.h"
 
@@ -36,6 +37,7 @@ public:
     static void checkMode();
 
     bool isVisible:1;
+    bool closeEventsIgnored:1;
     QString title;
     QString category;
     QRect geometry;
@@ -49,7 +51,7 @@ public:
 HomeWindowPrivate::Mode HomeWindowPrivate::mode = HomeWindowPrivate::Unknown;
 
 HomeWindowPrivate::HomeWindowPrivate()
-: isVisible(false), window(0), compositorWindow(0), context(0), root(0)
+: isVisible(false), closeEventsIgnored(false), window(0), compositorWindow(0), context(0), root(0)
 {
     checkMode();
     if (0 == HomeApplication::instance())
@@ -58,7 +60,7 @@ HomeWindowPrivate::HomeWindowPrivate()
     context = new QQmlContext(HomeApplication::instance()->engine());
 
     if (isWindow()) {
-        window = new QQuickWindow;
+        window = new HomeQuickWindow;
         // XXX
         // window->setResizeMode(QQuickView::SizeRootObjectToView);
     } else {
@@ -227,6 +229,20 @@ void HomeWindow::setCategory(const QString &category)
     d->category = category;
 }
 
+bool HomeWindow::closeEventsIgnored() const
+{
+    return d->closeEventsIgnored;
+}
+
+void HomeWindow::setCloseEventsIgnored(bool ignored)
+{
+    d->closeEventsIgnored = ignored;
+
+    // In-process compositor windows never receive close events
+    if (d->isWindow())
+        static_cast<HomeQuickWindow *>(d->window)->closeEventsIgnored = ignored;
+}
+
 QList<QQmlError> HomeWindow::errors() const
 {
     return d->errors;
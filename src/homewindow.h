@@ -47,6 +47,9 @@ public:
     QString category() const;
     void setCategory(const QString &category);
 
+    bool closeEventsIgnored() const;
+    void setCloseEventsIgnored(bool ignored);
+
     void resize(const QSize &);
     void setGeometry(const QRect &);
 
@@ -29,7 +29,9 @@ LipstickApi::LipstickApi(QObject *parent)
 
 bool LipstickApi::active() const
 {
-    return HomeApplication::instance()->homeActive();
+    // Other processes importing the plugin have no home application
+    HomeApplication *homeApp = HomeApplication::instance();
+    return homeApp && homeApp->homeActive();
 }
 
 QObject *LipstickApi::compositor() const
@@ -44,5 +46,6 @@ ScreenshotResult *LipstickApi::takeScreenshot(const QString &path)
 
 QString LipstickApi::notificationSystemApplicationName() const
 {
-    return NotificationManager::instance(false)->systemApplicationName();
+    // Doesn't need a notification manager, which would open the notification database
+    return NotificationManager::systemApplicationName();
 }
@@ -34,6 +34,9 @@
 #define LIPSTICK_DBUS_SHUTDOWN_PATH "/shutdown"
 #define LIPSTICK_DBUS_SCREENSHOT_PATH "/org/nemomobile/lipstick/screenshot"
 
+#define LIPSTICK_DBUS_TRACE_PATH "/org/nemomobile/lipstick/trace"
+#define LIPSTICK_DBUS_TRACE_INTERFACE "org.nemomobile.lipstick.Trace"
+
 #define LIPSTICK_DBUS_VPNAGENT_PATH "/org/nemomobile/lipstick/vpnagent"
 #define LIPSTICK_DBUS_CONNMAN_VPN_SERVICE "net.connman.vpn"
 
@@ -19,6 +19,7 @@
 #include <QTimer>
 #include "notificationmanager.h"
 #include "lipsticknotification.h"
+#include "systemnotification.h"
 #include "batterynotifier.h"
 #include <time.h>
 #include <keepalive/backgroundactivity.h>
@@ -481,26 +482,14 @@ void BatteryNotifier::sendNotification(BatteryNotifier::NotificationType type)
             : info.message;
 
     /* Add fresh notification item */
-    QVariantHash hints;
-    if (!info.category.isEmpty()) {
-        hints.insert(LipstickNotification::HINT_CATEGORY, info.category);
-    }
-    if (!info.feedback.isEmpty()) {
-        hints.insert(LipstickNotification::HINT_FEEDBACK, info.feedback);
-    }
-    hints.insert(LipstickNotification::HINT_VISIBILITY, QLatin1String("public"));
-    hints.insert(LipstickNotification::HINT_URGENCY, LipstickNotification::Critical);
-    hints.insert(LipstickNotification::HINT_TRANSIENT, true);
+    SystemNotification notification(message);
+    notification.setIcon(info.icon)
+            .setCategory(info.category)
+            .setFeedback(info.feedback)
+            .setHint(LipstickNotification::HINT_VISIBILITY, QLatin1String("public"));
     QueuedNotification queuedNotification;
     queuedNotification.m_type = type;
-    queuedNotification.m_id = m_notificationManager->Notify(m_notificationManager->systemApplicationName(),
-                                                            0,
-                                                            info.icon,
-                                                            QString(),
-                                                            message,
-                                                            QStringList(),
-                                                            hints,
-                                                            -1);
+    queuedNotification.m_id = m_notificationManager->publishSystemNotification(notification);
     m_notifications.push_back(queuedNotification);
 }
 
@@ -19,12 +19,86 @@
 
 #include <QDBusArgument>
 #include <QDataStream>
+#include <QSet>
 #include <QtDebug>
 
 namespace {
 // deprecated
 const char *HINT_ICON = "x-nemo-icon";
 const char *HINT_PREVIEW_ICON = "x-nemo-preview-icon";
+
+// Strings are kept in the pool only as long as some notification shares them; the strings
+// are client controlled, so they can not be kept forever.
+const int MinimumInternPruneSize = 256;
+
+// Returns a copy sharing its data with the first equal string seen. Application names, icons,
+// actions and hint keys repeat across the notifications of an application, and sharing them
+// keeps a thousand restored notifications from holding a thousand copies of each.
+// Notifications are only created in the main thread.
+QString intern(const QString &string)
+{
+    static QSet<QString> pool;
+    static int pruneSize = MinimumInternPruneSize;
+
+    if (string.isEmpty()) {
+        return string;
+    }
+
+    QSet<QString>::const_iterator it = pool.constFind(string);
+    if (it != pool.constEnd()) {
+        return *it;
+    }
+    pool.insert(string);
+
+    if (pool.size() >= pruneSize) {
+        // A string not shared with anything but the pool is no longer used by any notification
+        for (QSet<QString>::iterator it = pool.begin(); it != pool.end(); ) {
+            if (it->isDetached()) {
+                it = pool.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        pruneSize = qMax(MinimumInternPruneSize, pool.size() * 2);
+    }
+
+    return string;
+}
+
+QStringList intern(const QStringList &strings)
+{
+    QStringList interned;
+    interned.reserve(strings.count());
+    foreach (const QString &string, strings) {
+        interned.append(intern(string));
+    }
+    return interned;
+}
+
+bool hasRepeatingValue(const QString &hint)
+{
+    return hint == QLatin1String(LipstickNotification::HINT_CATEGORY)
+            || hint == QLatin1String(LipstickNotification::HINT_FEEDBACK)
+            || hint == QLatin1String(LipstickNotification::HINT_ORIGIN_PACKAGE)
+            || hint == QLatin1String(LipstickNotification::HINT_OWNER);
+}
+
+QVariantHash intern(const QVariantHash &hints)
+{
+    QVariantHash interned;
+    interned.reserve(hints.count());
+
+    QVariantHash::const_iterator it = hints.constBegin(), end = hints.constEnd();
+    for ( ; it != end; ++it) {
+        const QString hint(intern(it.key()));
+        if (it.value().type() == QVariant::String && hasRepeatingValue(hint)) {
+            interned.insert(hint, intern(it.value().toString()));
+        } else {
+            interned.insert(hint, it.value());
+        }
+    }
+    return interned;
+}
 }
 
 const char *LipstickNotification::HINT_URGENCY = "urgency";
@@ -60,21 +134,21 @@ LipstickNotification::LipstickNotification(const QString &appName, const QString
                                            const QStringList &actions, const QVariantHash &hints, int expireTimeout,
                                            QObject *parent)
     : QObject(parent),
-      m_appName(appName),
-      m_explicitAppName(explicitAppName),
-      m_disambiguatedAppName(disambiguatedAppName),
+      m_appName(intern(appName)),
+      m_explicitAppName(intern(explicitAppName)),
+      m_disambiguatedAppName(intern(disambiguatedAppName)),
       m_id(id),
-      m_appIcon(appIcon),
+      m_appIcon(intern(appIcon)),
       m_summary(summary),
       m_body(body),
-      m_actions(actions),
-      m_hints(hints),
+      m_actions(intern(actions)),
+      m_hints(intern(hints)),
       m_expireTimeout(expireTimeout),
       m_priority(hints.value(LipstickNotification::HINT_PRIORITY).toInt()),
       m_timestamp(hints.value(LipstickNotification::HINT_TIMESTAMP).toDateTime().toMSecsSinceEpoch()),
       m_activeProgressTimer(0)
 {
-    updateHintValues();
+    warnDeprecatedHints();
 }
 
 LipstickNotification::LipstickNotification(QObject *parent)
@@ -99,7 +173,6 @@ LipstickNotification::LipstickNotification(const LipstickNotification &notificat
       m_body(notification.m_body),
       m_actions(notification.m_actions),
       m_hints(notification.m_hints),
-      m_hintValues(notification.m_hintValues),
       m_expireTimeout(notification.m_expireTimeout),
       m_priority(notification.m_priority),
       m_timestamp(notification.m_timestamp),
@@ -124,17 +197,17 @@ QString LipstickNotification::disambiguatedAppName() const
 
 void LipstickNotification::setAppName(const QString &appName)
 {
-    m_appName = appName;
+    m_appName = intern(appName);
 }
 
 void LipstickNotification::setExplicitAppName(const QString &appName)
 {
-    m_explicitAppName = appName;
+    m_explicitAppName = intern(appName);
 }
 
 void LipstickNotification::setDisambiguatedAppName(const QString &disambiguatedAppName)
 {
-    m_disambiguatedAppName = disambiguatedAppName;
+    m_disambiguatedAppName = intern(disambiguatedAppName);
 }
 
 uint LipstickNotification::id() const
@@ -154,7 +227,7 @@ void LipstickNotification::setAppIcon(const QString &appIcon, int source)
 
     if (appIcon != m_appIcon) {
         iconChanged = true;
-        m_appIcon = appIcon;
+        m_appIcon = intern(appIcon);
     }
 
     if (source != m_appIconOrigin) {
@@ -209,7 +282,7 @@ QStringList LipstickNotification::actions() const
 void LipstickNotification::setActions(const QStringList &actions)
 {
     if (m_actions != actions) {
-        m_actions = actions;
+        m_actions = intern(actions);
         emit remoteActionsChanged();
     }
 }
@@ -221,7 +294,39 @@ QVariantHash LipstickNotification::hints() const
 
 QVariantMap LipstickNotification::hintValues() const
 {
-    return m_hintValues;
+    // Built on demand, only the delegates showing the notification read it,
+    // and kept until the hints change
+    if (m_hintValuesValid) {
+        return m_hintValues;
+    }
+
+    QVariantMap hintValues;
+
+    QVariantHash::const_iterator it = m_hints.constBegin(), end = m_hints.constEnd();
+    for ( ; it != end; ++it) {
+        // Filter out the hints that are represented by other properties
+        const QString &hint(it.key());
+
+        if (hint.compare(LipstickNotification::HINT_TIMESTAMP, Qt::CaseInsensitive) != 0 &&
+            hint.compare(LipstickNotification::HINT_PREVIEW_SUMMARY, Qt::CaseInsensitive) != 0 &&
+            hint.compare(LipstickNotification::HINT_PREVIEW_BODY, Qt::CaseInsensitive) != 0 &&
+            hint.compare(LipstickNotification::HINT_SUB_TEXT, Qt::CaseInsensitive) != 0 &&
+            hint.compare(LipstickNotification::HINT_URGENCY, Qt::CaseInsensitive) != 0 &&
+            hint.compare(LipstickNotification::HINT_ITEM_COUNT, Qt::CaseInsensitive) != 0 &&
+            hint.compare(LipstickNotification::HINT_PRIORITY, Qt::CaseInsensitive) != 0 &&
+            hint.compare(LipstickNotification::HINT_CATEGORY, Qt::CaseInsensitive) != 0 &&
+            hint.compare(LipstickNotification::HINT_USER_REMOVABLE, Qt::CaseInsensitive) != 0 &&
+            hint.compare(LipstickNotification::HINT_OWNER, Qt::CaseInsensitive) != 0 &&
+            hint.compare(LipstickNotification::HINT_PROGRESS, Qt::CaseInsensitive) &&
+            !hint.startsWith(LipstickNotification::HINT_REMOTE_ACTION_PREFIX, Qt::CaseInsensitive) &&
+            !hint.startsWith(LipstickNotification::HINT_REMOTE_ACTION_ICON_PREFIX, Qt::CaseInsensitive)) {
+            hintValues.insert(hint, it.value());
+        }
+    }
+
+    m_hintValues = hintValues;
+    m_hintValuesValid = true;
+    return hintValues;
 }
 
 void LipstickNotification::setHints(const QVariantHash &hints)
@@ -240,8 +345,10 @@ void LipstickNotification::setHints(const QVariantHash &hints)
     bool oldIsTransient = isTransient();
     QString oldColor = color();
 
-    m_hints = hints;
-    updateHintValues();
+    m_hints = intern(hints);
+    m_hintValues.clear();
+    m_hintValuesValid = false;
+    warnDeprecatedHints();
 
     if (oldAppIcon != appIcon()) {
         emit appIconChanged();
@@ -479,40 +586,17 @@ void LipstickNotification::restartProgressTimer()
     }
 }
 
-void LipstickNotification::updateHintValues()
+void LipstickNotification::warnDeprecatedHints() const
 {
-    m_hintValues.clear();
-
-    QVariantHash::const_iterator it = m_hints.constBegin(), end = m_hints.constEnd();
-    for ( ; it != end; ++it) {
-        // Filter out the hints that are represented by other properties
-        const QString &hint(it.key());
-
-        if (hint == HINT_ICON) {
-            qWarning() << "Notification sets deprecated hint" << HINT_ICON
-                       << "to" << it.value() << ", use app_icon parameter or"
-                       << LipstickNotification::HINT_IMAGE_PATH << "instead";
-        } else if (hint == HINT_PREVIEW_ICON) {
-            qWarning() << "Notification sets deprecated hint" << HINT_PREVIEW_ICON
-                       << "to" << it.value() << ", use app_icon parameter or"
-                       << LipstickNotification::HINT_IMAGE_PATH << "instead";
-        }
-
-        if (hint.compare(LipstickNotification::HINT_TIMESTAMP, Qt::CaseInsensitive) != 0 &&
-            hint.compare(LipstickNotification::HINT_PREVIEW_SUMMARY, Qt::CaseInsensitive) != 0 &&
-            hint.compare(LipstickNotification::HINT_PREVIEW_BODY, Qt::CaseInsensitive) != 0 &&
-            hint.compare(LipstickNotification::HINT_SUB_TEXT, Qt::CaseInsensitive) != 0 &&
-            hint.compare(LipstickNotification::HINT_URGENCY, Qt::CaseInsensitive) != 0 &&
-            hint.compare(LipstickNotification::HINT_ITEM_COUNT, Qt::CaseInsensitive) != 0 &&
-            hint.compare(LipstickNotification::HINT_PRIORITY, Qt::CaseInsensitive) != 0 &&
-            hint.compare(LipstickNotification::HINT_CATEGORY, Qt::CaseInsensitive) != 0 &&
-            hint.compare(LipstickNotification::HINT_USER_REMOVABLE, Qt::CaseInsensitive) != 0 &&
-            hint.compare(LipstickNotification::HINT_OWNER, Qt::CaseInsensitive) != 0 &&
-            hint.compare(LipstickNotification::HINT_PROGRESS, Qt::CaseInsensitive) &&
-            !hint.startsWith(LipstickNotification::HINT_REMOTE_ACTION_PREFIX, Qt::CaseInsensitive) &&
-            !hint.startsWith(LipstickNotification::HINT_REMOTE_ACTION_ICON_PREFIX, Qt::CaseInsensitive)) {
-            m_hintValues.insert(hint, it.value());
-        }
+    if (m_hints.contains(HINT_ICON)) {
+        qWarning() << "Notification sets deprecated hint" << HINT_ICON
+                   << "to" << m_hints.value(HINT_ICON) << ", use app_icon parameter or"
+                   << LipstickNotification::HINT_IMAGE_PATH << "instead";
+    }
+    if (m_hints.contains(HINT_PREVIEW_ICON)) {
+        qWarning() << "Notification sets deprecated hint" << HINT_PREVIEW_ICON
+                   << "to" << m_hints.value(HINT_PREVIEW_ICON) << ", use app_icon parameter or"
+                   << LipstickNotification::HINT_IMAGE_PATH << "instead";
     }
 }
 
@@ -533,20 +617,32 @@ QDBusArgument &operator<<(QDBusArgument &argument, const LipstickNotification &n
 
 const QDBusArgument &operator>>(const QDBusArgument &argument, LipstickNotification &notification)
 {
+    QString appName;
+    QString appIcon;
+    QStringList actions;
+    QVariantHash hints;
+
     argument.beginStructure();
-    argument >> notification.m_appName;
+    argument >> appName;
     argument >> notification.m_id;
-    argument >> notification.m_appIcon;
+    argument >> appIcon;
     argument >> notification.m_summary;
     argument >> notification.m_body;
-    argument >> notification.m_actions;
-    argument >> notification.m_hints;
+    argument >> actions;
+    argument >> hints;
     argument >> notification.m_expireTimeout;
     argument.endStructure();
 
+    notification.m_appName = intern(appName);
+    notification.m_appIcon = intern(appIcon);
+    notification.m_actions = intern(actions);
+    notification.m_hints = intern(hints);
+    notification.m_hintValues.clear();
+    notification.m_hintValuesValid = false;
+
     notification.m_priority = notification.m_hints.value(LipstickNotification::HINT_PRIORITY).toInt();
     notification.m_timestamp = notification.m_hints.value(LipstickNotification::HINT_TIMESTAMP).toDateTime().toMSecsSinceEpoch();
-    notification.updateHintValues();
+    notification.warnDeprecatedHints();
 
     return argument;
 }
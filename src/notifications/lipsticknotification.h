@@ -347,7 +347,7 @@ signals:
     void colorChanged();
 
 private:
-    void updateHintValues();
+    void warnDeprecatedHints() const;
 
     //! Name of the application sending the notification
     QString m_appName;
@@ -369,9 +369,12 @@ private:
     //! Actions for the notification as a list of identifier/string pairs
     QStringList m_actions;
 
-    //! Hints for the notification
+    //! Hints for the notification, with the keys and the repeating values interned
     QVariantHash m_hints;
-    QVariantMap m_hintValues;
+
+    //! The hints not represented by other properties, built when first read
+    mutable QVariantMap m_hintValues;
+    mutable bool m_hintValuesValid = false;
 
     //! Expiration timeout for the notification
     int m_expireTimeout;
@@ -14,7 +14,6 @@
 ****************************************************************************/
 
 #include <NgfClient>
-#include <QWaylandSurface>
 #include <QUrl>
 
 #include "lipstickcompositor.h"
@@ -148,11 +147,8 @@ bool NotificationFeedbackPlayer::isEnabled(LipstickNotification *notification, i
     if (notification->restored())
         return false;
 
-    uint mode = AllNotificationsEnabled;
-    QWaylandSurface *surface = LipstickCompositor::instance()->surfaceForId(LipstickCompositor::instance()->topmostWindowId());
-    if (surface != 0) {
-        mode = surface->windowProperties().value("NOTIFICATION_PREVIEWS_DISABLED", uint(AllNotificationsEnabled)).toUInt();
-    }
+    LipstickCompositor *compositor = LipstickCompositor::instance();
+    uint mode = compositor->notificationPreviewsDisabled(compositor->topmostWindowId(), AllNotificationsEnabled);
 
     int urgency = notification->urgency();
     int priority = notification->priority();
@@ -73,6 +73,7 @@ private:
 
 #ifdef UNIT_TEST
     friend class Ut_NotificationListModel;
+    friend class Bench_Notifications;
 #endif
 };
 
@@ -38,6 +38,9 @@
 #include "categorydefinitionstore.h"
 #include "notificationmanageradaptor.h"
 #include "notificationmanager.h"
+#include "systemnotification.h"
+#include "tracing.h"
+#include "utilities/callercredentials.h"
 
 // Define this if you'd like to see debug messages from the notification manager
 #ifdef DEBUG_NOTIFICATIONS
@@ -73,14 +76,7 @@ const int PublicationDelay = 1000;
 
 bool processIsPrivileged(int pid)
 {
-    bool isPrivileged = false;
-    if (pid == getpid()) {
-        // Internal operations are considered privileged
-        isPrivileged = true;
-    } else if (pid > 0) {
-        QFileInfo info(QString("/proc/%1").arg(pid));
-        isPrivileged = info.group() == QLatin1String("privileged") || info.owner() == QLatin1String("root");
-    }
+    bool isPrivileged = CallerCredentials::processIsPrivileged(pid);
     NOTIFICATIONS_DEBUG("pid" << pid << "-> isPrivileged" << isPrivileged);
     return isPrivileged;
 }
@@ -408,6 +404,7 @@ uint NotificationManager::handleNotify(int clientPid, const QString &appName, ui
                                        const QString &summary, const QString &body, const QStringList &actions,
                                        const QVariantHash &hints, int expireTimeout)
 {
+    LIPSTICK_TRACE_SCOPE("notification", "handleNotify");
     NOTIFICATIONS_DEBUG("clientPid:" << clientPid << "appName:" << appName << "replacesId:" << replacesId << "appIcon:" << appIcon
                         << "summary:" << summary << "body:" << body << "actions:" << actions << "hints:" << hints << "expireTimeout:" << expireTimeout);
 
@@ -610,6 +607,78 @@ uint NotificationManager::handleNotify(int clientPid, const QString &appName, ui
     return id;
 }
 
+uint NotificationManager::publishSystemNotification(const SystemNotification &systemNotification, uint replacesId)
+{
+    LIPSTICK_TRACE_SCOPE("notification", "publishSystemNotification");
+    if (replacesId != 0 && !m_notifications.contains(replacesId)) {
+        replacesId = 0;
+    }
+
+    const uint id = replacesId != 0 ? replacesId : nextAvailableNotificationID();
+    const QString appName(systemApplicationName());
+
+    QVariantHash hints(systemNotification.hints());
+    hints.insert(LipstickNotification::HINT_TIMESTAMP, QDateTime::currentDateTimeUtc().toString(Qt::ISODate));
+    hints.insert(LipstickNotification::HINT_URGENCY, systemNotification.urgency());
+    if (systemNotification.isTransient()) {
+        hints.insert(LipstickNotification::HINT_TRANSIENT, true);
+    }
+    if (!systemNotification.category().isEmpty()) {
+        hints.insert(LipstickNotification::HINT_CATEGORY, systemNotification.category());
+    }
+    if (!systemNotification.feedback().isEmpty()) {
+        hints.insert(LipstickNotification::HINT_FEEDBACK, systemNotification.feedback());
+    }
+
+    LipstickNotification notificationData(appName, appName, appName, id, systemNotification.icon(),
+                                          systemNotification.summary(), systemNotification.body(),
+                                          QStringList(), hints, -1);
+    if (!systemNotification.category().isEmpty()) {
+        applyCategoryParameters(&notificationData, systemCategoryParameters(systemNotification.category()));
+        hints = notificationData.hints();
+    }
+
+    if (!hints.contains(LipstickNotification::HINT_PREVIEW_SUMMARY)) {
+        hints.insert(LipstickNotification::HINT_PREVIEW_SUMMARY, notificationData.summary());
+    }
+    if (!hints.contains(LipstickNotification::HINT_PREVIEW_BODY)) {
+        hints.insert(LipstickNotification::HINT_PREVIEW_BODY, notificationData.body());
+    }
+    if (!hints.contains(LipstickNotification::HINT_PRIORITY)) {
+        hints.insert(LipstickNotification::HINT_PRIORITY, DefaultNotificationPriority);
+    }
+    notificationData.setHints(hints);
+
+    LipstickNotification *notification = replacesId != 0
+            ? m_notifications.value(replacesId)
+            : nullptr;
+
+    if (notification) {
+        notification->setAppIcon(notificationData.appIcon(), notificationData.appIconOrigin());
+        notification->setSummary(notificationData.summary());
+        notification->setBody(notificationData.body());
+        notification->setExpireTimeout(notificationData.expireTimeout());
+        notification->setHints(notificationData.hints());
+    } else {
+        notification = new LipstickNotification(notificationData);
+        notification->setParent(this);
+
+        connect(notification, &LipstickNotification::actionInvoked,
+                this, &NotificationManager::invokeAction, Qt::QueuedConnection);
+        connect(notification, &LipstickNotification::removeRequested,
+                this, [this]() { removeNotificationIfUserRemovable(); }, Qt::QueuedConnection);
+
+        m_notifications.insert(id, notification);
+    }
+
+    notification->restartProgressTimer();
+
+    // Transient notifications are dropped on restore anyway, so there is no point in storing them
+    publish(notification, replacesId, !notification->isTransient());
+
+    return id;
+}
+
 void NotificationManager::deleteNotification(uint id)
 {
     // Remove the notification, its actions and its hints from database
@@ -649,6 +718,7 @@ void NotificationManager::identifiedCloseNotification()
 
 void NotificationManager::handleCloseNotification(int clientPid, uint id, NotificationClosedReason closeReason)
 {
+    LIPSTICK_TRACE_SCOPE("notification", "handleCloseNotification");
     NOTIFICATIONS_DEBUG("clientPid:" << clientPid << "id:" << id << "closeReason:" << closeReason);
     if (LipstickNotification *notification = m_notifications.value(id)) {
         if (!notification->isUserRemovableByHint() && !processIsPrivileged(clientPid)) {
@@ -819,7 +889,7 @@ NotificationList NotificationManager::handleGetNotificationsByCategory(int clien
     return NotificationList(notificationList);
 }
 
-QString NotificationManager::systemApplicationName() const
+QString NotificationManager::systemApplicationName()
 {
     //% "System"
     return qtTrId("qtn_ap_lipstick");
@@ -844,6 +914,8 @@ uint NotificationManager::nextAvailableNotificationID()
 
 void NotificationManager::removeNotificationsWithCategory(const QString &category)
 {
+    m_systemCategoryParameters.remove(category);
+
     QList<uint> ids;
     QHash<uint, LipstickNotification *>::const_iterator it = m_notifications.constBegin(), end = m_notifications.constEnd();
     for ( ; it != end; ++it) {
@@ -857,6 +929,8 @@ void NotificationManager::removeNotificationsWithCategory(const QString &categor
 
 void NotificationManager::updateNotificationsWithCategory(const QString &category)
 {
+    m_systemCategoryParameters.remove(category);
+
     QList<LipstickNotification *> categoryNotifications;
 
     QHash<uint, LipstickNotification *>::const_iterator it = m_notifications.constBegin(), end = m_notifications.constEnd();
@@ -885,11 +959,15 @@ QHash<QString, QString> NotificationManager::categoryDefinitionParameters(const
 }
 
 void NotificationManager::applyCategoryDefinition(LipstickNotification *notification) const
+{
+    // Apply a category definition, if any
+    applyCategoryParameters(notification, categoryDefinitionParameters(notification->hints()));
+}
+
+void NotificationManager::applyCategoryParameters(LipstickNotification *notification, const QHash<QString, QString> &categoryParameters) const
 {
     QVariantHash hints = notification->hints();
 
-    // Apply a category definition, if any
-    const QHash<QString, QString> categoryParameters(categoryDefinitionParameters(hints));
     QHash<QString, QString>::const_iterator it = categoryParameters.constBegin(), end = categoryParameters.constEnd();
     for ( ; it != end; ++it) {
         const QString &key(it.key());
@@ -925,7 +1003,22 @@ void NotificationManager::applyCategoryDefinition(LipstickNotification *notifica
     notification->setHints(hints);
 }
 
-void NotificationManager::publish(const LipstickNotification *notification, uint replacesId)
+QHash<QString, QString> NotificationManager::systemCategoryParameters(const QString &category)
+{
+    QHash<QString, QHash<QString, QString> >::const_iterator it = m_systemCategoryParameters.constFind(category);
+    if (it != m_systemCategoryParameters.constEnd()) {
+        return it.value();
+    }
+
+    const QHash<QString, QString> parameters(m_categoryDefinitionStore->categoryParameters(category));
+    // A missing definition is not cached so that a later installed one gets picked up
+    if (!parameters.isEmpty()) {
+        m_systemCategoryParameters.insert(category, parameters);
+    }
+    return parameters;
+}
+
+void NotificationManager::publish(const LipstickNotification *notification, uint replacesId, bool persistent)
 {
     const uint id(notification->id());
     if (id == 0) {
@@ -941,6 +1034,28 @@ void NotificationManager::publish(const LipstickNotification *notification, uint
         deleteNotification(id);
     }
 
+    if (persistent) {
+        persist(notification);
+    }
+
+    NOTIFICATIONS_DEBUG("PUBLISH:" << notification->appName() << notification->appIcon() << notification->summary()
+                        << notification->body() << notification->actions() << notification->hints()
+                        << notification->expireTimeout() << "->" << id);
+    m_modifiedIds.insert(id);
+    if (!m_modificationTimer.isActive()) {
+        m_modificationTimer.start();
+    }
+    if (replacesId == 0) {
+        emit notificationAdded(id);
+    } else {
+        emit notificationModified(id);
+    }
+}
+
+void NotificationManager::persist(const LipstickNotification *notification)
+{
+    const uint id(notification->id());
+
     // Add the notification, its actions and its hints to the database
     execSQL("INSERT INTO notifications VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?)",
             QVariantList() << id << notification->appName() << notification->appIcon() << notification->summary()
@@ -966,23 +1081,11 @@ void NotificationManager::publish(const LipstickNotification *notification, uint
     for ( ; hit != hend; ++hit) {
         execSQL("INSERT INTO hints VALUES (?, ?, ?)", QVariantList() << id << hit.key() << hit.value());
     }
-
-    NOTIFICATIONS_DEBUG("PUBLISH:" << notification->appName() << notification->appIcon() << notification->summary()
-                        << notification->body() << notification->actions() << notification->hints()
-                        << notification->expireTimeout() << "->" << id);
-    m_modifiedIds.insert(id);
-    if (!m_modificationTimer.isActive()) {
-        m_modificationTimer.start();
-    }
-    if (replacesId == 0) {
-        emit notificationAdded(id);
-    } else {
-        emit notificationModified(id);
-    }
 }
 
 void NotificationManager::restoreNotifications(bool update)
 {
+    LIPSTICK_TRACE_SCOPE("notification", "restoreNotifications");
     if (connectToDatabase()) {
         if (checkTableValidity()) {
             fetchData(update);
@@ -1351,6 +1454,7 @@ void NotificationManager::fetchData(bool update)
 
 void NotificationManager::commit()
 {
+    LIPSTICK_TRACE_SCOPE("notification", "commit");
     // Any aditional rules about when database commits are allowed can be added here
     if (!m_committed) {
         m_database->commit();
@@ -1445,6 +1549,7 @@ void NotificationManager::removeNotificationIfUserRemovable(uint id)
 
 void NotificationManager::expire()
 {
+    LIPSTICK_TRACE_SCOPE("notification", "expire");
     const qint64 currentTime(QDateTime::currentDateTimeUtc().toMSecsSinceEpoch());
     QList<uint> expiredIds;
     qint64 nextTimeout = std::numeric_limits<qint64>::max();
@@ -27,6 +27,7 @@
 
 class AndroidPriorityStore;
 class CategoryDefinitionStore;
+class SystemNotification;
 class QSqlDatabase;
 class QDBusPendingCallWatcher;
 
@@ -183,7 +184,19 @@ public:
     NotificationList GetNotificationsByCategory(const QString &category);
 
     // App name for system notifications originating from Lipstick itself
-    QString systemApplicationName() const;
+    static QString systemApplicationName();
+
+    /*!
+     * Publishes a notification originating from lipstick itself. Unlike
+     * Notify() this does not go through client identification or hint
+     * normalization, and transient system notifications are not stored
+     * in the notification database.
+     *
+     * \param notification the system notification to publish
+     * \param replacesId the ID of a notification to replace, or 0
+     * \return the ID of the published notification
+     */
+    uint publishSystemNotification(const SystemNotification &notification, uint replacesId = 0);
 
 signals:
     /*!
@@ -368,10 +381,25 @@ private:
      */
     void applyCategoryDefinition(LipstickNotification *notification) const;
 
+    /*!
+     * Update a notification by applying the given category definition parameters.
+     */
+    void applyCategoryParameters(LipstickNotification *notification, const QHash<QString, QString> &categoryParameters) const;
+
+    /*!
+     * Returns the category definition parameters of a system notification category.
+     * The parameters are looked up once and kept until the category definition changes.
+     */
+    QHash<QString, QString> systemCategoryParameters(const QString &category);
+
     /*!
      * Makes a notification known to the system, or updates its properties if already published.
+     * A notification that is not persistent is not written to the database.
      */
-    void publish(const LipstickNotification *notification, uint replacesId);
+    void publish(const LipstickNotification *notification, uint replacesId, bool persistent = true);
+
+    //! Writes a notification, its actions and its hints to the database
+    void persist(const LipstickNotification *notification);
 
     //! Restores the notifications from a database on the disk
     void restoreNotifications(bool update);
@@ -480,6 +508,9 @@ private:
     //! The category definition store
     CategoryDefinitionStore *m_categoryDefinitionStore;
 
+    //! Category definition parameters used by system notifications, by category
+    QHash<QString, QHash<QString, QString> > m_systemCategoryParameters;
+
     //! The Android application priority store
     AndroidPriorityStore *m_androidPriorityStore;
 
@@ -506,6 +537,7 @@ private:
 
 #ifdef UNIT_TEST
     friend class Ut_NotificationManager;
+    friend class Bench_Notifications;
 #endif
 };
 
@@ -15,7 +15,6 @@
 
 #include "homewindow.h"
 #include "lipsticksettings.h"
-#include "utilities/closeeventeater.h"
 #include "notifications/notificationmanager.h"
 #include "notifications/notificationfeedbackplayer.h"
 #include "notifications/lipsticknotification.h"
@@ -34,7 +33,6 @@
 #include <QDBusPendingCall>
 #include <QGuiApplication>
 #include <QQmlContext>
-#include <QWaylandSurface>
 
 namespace {
 
@@ -182,7 +180,7 @@ void NotificationPreviewPresenter::createWindowIfNecessary()
     m_window->setContextProperty("notificationPreviewPresenter", this);
     m_window->setContextProperty("notificationFeedbackPlayer", m_notificationFeedbackPlayer);
     m_window->setSource(QmlPath::to("notifications/NotificationPreview.qml"));
-    m_window->installEventFilter(new CloseEventEater(this));
+    m_window->setCloseEventsIgnored(true);
 }
 
 bool NotificationPreviewPresenter::notificationShouldBeShown(LipstickNotification *notification)
@@ -223,11 +221,8 @@ bool NotificationPreviewPresenter::notificationShouldBeShown(LipstickNotificatio
         return false;
     }
 
-    uint mode = AllNotificationsEnabled;
-    QWaylandSurface *surface = LipstickCompositor::instance()->surfaceForId(LipstickCompositor::instance()->topmostWindowId());
-    if (surface != 0) {
-        mode = surface->windowProperties().value("NOTIFICATION_PREVIEWS_DISABLED", uint(AllNotificationsEnabled)).toUInt();
-    }
+    LipstickCompositor *compositor = LipstickCompositor::instance();
+    uint mode = compositor->notificationPreviewsDisabled(compositor->topmostWindowId(), AllNotificationsEnabled);
 
     return (mode == AllNotificationsEnabled
             || (mode == ApplicationNotificationsDisabled && notificationIsCritical)
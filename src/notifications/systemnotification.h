@@ -0,0 +1,78 @@
+/***************************************************************************
+**
+** Copyright (c) 2021 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#ifndef SYSTEMNOTIFICATION_H
+#define SYSTEMNOTIFICATION_H
+
+#include <QString>
+#include <QVariantHash>
+#include "lipsticknotification.h"
+
+/*!
+ * \class SystemNotification
+ *
+ * \brief Describes a notification published by lipstick itself.
+ *
+ * System notifications are handed to NotificationManager::publishSystemNotification()
+ * directly instead of going through the Notify() D-Bus interface. They are
+ * critical and transient unless configured otherwise, and transient system
+ * notifications are never written to the notification database.
+ */
+class SystemNotification
+{
+public:
+    /*!
+     * Creates a critical, transient system notification.
+     *
+     * \param body the body text of the notification
+     */
+    explicit SystemNotification(const QString &body = QString())
+        : m_body(body)
+        , m_urgency(LipstickNotification::Critical)
+        , m_transient(true)
+    {
+    }
+
+    SystemNotification &setIcon(const QString &icon) { m_icon = icon; return *this; }
+    SystemNotification &setSummary(const QString &summary) { m_summary = summary; return *this; }
+    SystemNotification &setBody(const QString &body) { m_body = body; return *this; }
+    SystemNotification &setCategory(const QString &category) { m_category = category; return *this; }
+    SystemNotification &setFeedback(const QString &feedback) { m_feedback = feedback; return *this; }
+    SystemNotification &setUrgency(LipstickNotification::Urgency urgency) { m_urgency = urgency; return *this; }
+    SystemNotification &setTransient(bool transient) { m_transient = transient; return *this; }
+
+    //! Sets a hint that has no dedicated setter, such as the visibility
+    SystemNotification &setHint(const QString &hint, const QVariant &value) { m_hints.insert(hint, value); return *this; }
+
+    QString icon() const { return m_icon; }
+    QString summary() const { return m_summary; }
+    QString body() const { return m_body; }
+    QString category() const { return m_category; }
+    QString feedback() const { return m_feedback; }
+    LipstickNotification::Urgency urgency() const { return m_urgency; }
+    bool isTransient() const { return m_transient; }
+    QVariantHash hints() const { return m_hints; }
+
+private:
+    QString m_icon;
+    QString m_summary;
+    QString m_body;
+    QString m_category;
+    QString m_feedback;
+    LipstickNotification::Urgency m_urgency;
+    bool m_transient;
+    QVariantHash m_hints;
+};
+
+#endif // SYSTEMNOTIFICATION_H
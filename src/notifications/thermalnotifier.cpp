@@ -14,6 +14,7 @@
 ****************************************************************************/
 #include "notifications/notificationmanager.h"
 #include "notifications/lipsticknotification.h"
+#include "notifications/systemnotification.h"
 #include "homeapplication.h"
 #include "thermalnotifier.h"
 
@@ -54,7 +55,13 @@ void ThermalNotifier::applyThermalState(DeviceState::Thermal::ThermalState state
 void ThermalNotifier::applyDisplayState(DeviceState::DisplayStateMonitor::DisplayState state)
 {
     if (state == DeviceState::DisplayStateMonitor::On) {
+        // The thermal state is cached, so this does not block the first frame
         DeviceState::Thermal::ThermalState currentThermalState = m_thermalState->get();
+        if (currentThermalState == DeviceState::Thermal::Unknown
+                || currentThermalState == DeviceState::Thermal::Error) {
+            return;
+        }
+
         if (m_thermalStateNotifiedWhileScreenIsOn != currentThermalState) {
             applyThermalState(currentThermalState);
         }
@@ -63,19 +70,8 @@ void ThermalNotifier::applyDisplayState(DeviceState::DisplayStateMonitor::Displa
 
 void ThermalNotifier::publishTemperatureNotification(const QString &body)
 {
-    NotificationManager *manager = NotificationManager::instance();
-
-    QVariantHash hints;
-    hints.insert(LipstickNotification::HINT_URGENCY, LipstickNotification::Critical);
-    hints.insert(LipstickNotification::HINT_TRANSIENT, true);
-    hints.insert(LipstickNotification::HINT_FEEDBACK, "general_warning");
-
-    manager->Notify(manager->systemApplicationName(),
-                    0,
-                    QLatin1String("icon-system-warning"),
-                    QString(),
-                    body,
-                    QStringList(),
-                    hints,
-                    -1);
+    NotificationManager::instance()->publishSystemNotification(
+                SystemNotification(body)
+                .setIcon(QLatin1String("icon-system-warning"))
+                .setFeedback(QLatin1String("general_warning")));
 }
@@ -20,13 +20,19 @@
 #include <QCursor>
 #include <QDebug>
 #include <QTouchEvent>
+#include <QQuickWindow>
 
 #include <mce/mode-names.h>
 
 #include "homeapplication.h"
 #include "screenlock.h"
 #include "touchscreen/touchscreen.h"
-#include "utilities/closeeventeater.h"
+#include "logging.h"
+
+namespace {
+// Upper bound for holding back a tklock_open reply when no frame gets presented
+const int PendingReplyTimeout = 250;
+}
 
 ScreenLock::ScreenLock(TouchScreen *touch, QObject* parent) :
     QObject(parent),
@@ -35,6 +41,7 @@ ScreenLock::ScreenLock(TouchScreen *touch, QObject* parent) :
     m_lockscreenVisible(false),
     m_lowPowerMode(false),
     m_mceBlankingPolicy("default"),
+    m_pendingRepliesTimer(0),
     m_interactionExpectedTimer(0),
     m_interactionExpectedCurrent(false),
     m_interactionExpectedEmitted(-1)
@@ -47,6 +54,12 @@ ScreenLock::ScreenLock(TouchScreen *touch, QObject* parent) :
     connect(m_interactionExpectedTimer, &QTimer::timeout,
             this, &ScreenLock::interactionExpectedBroadcast);
 
+    m_pendingRepliesTimer = new QTimer(this);
+    m_pendingRepliesTimer->setSingleShot(true);
+    m_pendingRepliesTimer->setInterval(PendingReplyTimeout);
+    connect(m_pendingRepliesTimer, &QTimer::timeout,
+            this, &ScreenLock::sendPendingReplies);
+
     connect(m_touchScreen, SIGNAL(touchBlockedChanged()), this, SIGNAL(touchBlockedChanged()));
 
     auto systemBus = QDBusConnection::systemBus();
@@ -79,44 +92,110 @@ int ScreenLock::tklock_open(const QString &service, const QString &path, const Q
     // Store the callback method name
     m_callbackMethod = QDBusMessage::createMethodCall(service, path, interface, method);
 
-    // MCE needs a response ASAP, so the actions are executed with single shot timers
+    // The state change is applied right away so that the screen lock is part of
+    // the next frame. Repeated requests for the current state change nothing.
+    const bool wasLocked = m_lockscreenVisible;
+    applyTkLockMode(mode);
+
+    if (!wasLocked && m_lockscreenVisible) {
+        m_lockScreenFrameTimer.start();
+        waitForLockScreenFrame();
+
+        // MCE turns the display on once the reply arrives, so reply only after
+        // the screen lock has been presented if the window is being rendered.
+        if (calledFromDBus() && message().isReplyRequired()
+                && m_lockScreenWindow && m_lockScreenWindow->isVisible()) {
+            setDelayedReply(true);
+            m_pendingReplies.append(message().createReply(int(TkLockReplyOk)));
+            m_pendingRepliesTimer->start();
+        }
+    }
+
+    return TkLockReplyOk;
+}
+
+int ScreenLock::tklock_close(bool)
+{
+    hideScreenLock();
+
+    return TkLockReplyOk;
+}
+
+void ScreenLock::applyTkLockMode(uint mode)
+{
     switch (mode) {
     case TkLockModeEnable:
         // Create the lock screen already so that it's readily available
-        QTimer::singleShot(0, this, SLOT(showScreenLock()));
+        showScreenLock();
         break;
 
     case TkLockModeOneInput:
-        QTimer::singleShot(0, this, SLOT(showEventEater()));
+        showEventEater();
         break;
 
     case TkLockEnableVisual:
         // Raise the lock screen window on top if it isn't already
-        QTimer::singleShot(0, this, SLOT(showScreenLock()));
+        showScreenLock();
         break;
 
     case TkLockEnableLowPowerMode:
         // Raise the lock screen window on top if it isn't already
         // (XXX: Low power mode is now handled via lpm_ui_mode_ind)
-        QTimer::singleShot(0, this, SLOT(showLowPowerMode()));
+        showLowPowerMode();
         break;
 
     case TkLockRealBlankMode:
-        QTimer::singleShot(0, this, SLOT(setDisplayOffMode()));
+        setDisplayOffMode();
         break;
 
     default:
         break;
     }
+}
 
-    return TkLockReplyOk;
+void ScreenLock::setLockScreenWindow(QQuickWindow *window)
+{
+    if (m_lockScreenWindow == window)
+        return;
+
+    if (m_lockScreenWindow)
+        disconnect(m_lockScreenWindow, &QQuickWindow::frameSwapped, this, &ScreenLock::handleLockScreenFrameSwapped);
+
+    sendPendingReplies();
+    m_lockScreenWindow = window;
 }
 
-int ScreenLock::tklock_close(bool)
+void ScreenLock::waitForLockScreenFrame()
 {
-    QTimer::singleShot(0, this, SLOT(hideScreenLock()));
+    if (m_lockScreenWindow) {
+        connect(m_lockScreenWindow, &QQuickWindow::frameSwapped,
+                this, &ScreenLock::handleLockScreenFrameSwapped, Qt::UniqueConnection);
+    }
+}
 
-    return TkLockReplyOk;
+void ScreenLock::handleLockScreenFrameSwapped()
+{
+    disconnect(m_lockScreenWindow, &QQuickWindow::frameSwapped, this, &ScreenLock::handleLockScreenFrameSwapped);
+
+    if (m_lockScreenFrameTimer.isValid()) {
+        qCDebug(lcLipstickCoreLog) << "Screen lock presented" << m_lockScreenFrameTimer.elapsed()
+                                   << "ms after tklock_open";
+        m_lockScreenFrameTimer.invalidate();
+    }
+
+    sendPendingReplies();
+}
+
+void ScreenLock::sendPendingReplies()
+{
+    m_pendingRepliesTimer->stop();
+
+    if (!m_pendingReplies.isEmpty()) {
+        QDBusConnection systemBus = QDBusConnection::systemBus();
+        for (const QDBusMessage &reply : m_pendingReplies)
+            systemBus.send(reply);
+        m_pendingReplies.clear();
+    }
 }
 
 void ScreenLock::interactionExpectedBroadcast()
@@ -19,15 +19,19 @@
 #include <QObject>
 #include "touchscreen/touchscreen.h"
 
+#include <QDBusContext>
 #include <QDBusMessage>
+#include <QElapsedTimer>
+#include <QPointer>
 
 class QTimer;
+class QQuickWindow;
 
 /*!
  * The screen lock business logic is responsible for showing and hiding
  * the screen lock window and the event eater window when necessary.
  */
-class ScreenLock : public QObject
+class ScreenLock : public QObject, protected QDBusContext
 {
     Q_OBJECT
     Q_PROPERTY(bool touchBlocked READ touchBlocked NOTIFY touchBlockedChanged FINAL)
@@ -96,6 +100,15 @@ public:
 
     TouchScreen::DisplayState displayState() const;
 
+    /*!
+     * Sets the window presenting the screen lock. When the window is
+     * visible, replies to tklock_open requests that show the screen lock
+     * are held back until the window has presented a frame.
+     *
+     * \param window the compositor window
+     */
+    void setLockScreenWindow(QQuickWindow *window);
+
 public slots:
     //! Shows the screen lock window and calls the MCE's lock function.
     void lockScreen(bool immediate = false);
@@ -156,6 +169,12 @@ private slots:
     //! Handles blanking policy change signals from mce
     void handleBlankingPolicyChange(const QString &policy);
 
+    //! Handles a frame presented by the screen lock window
+    void handleLockScreenFrameSwapped();
+
+    //! Sends the replies held back until the screen lock is presented
+    void sendPendingReplies();
+
 signals:
     //! Emitted when the screen lock state changes
     void screenLockedChanged(bool locked);
@@ -200,8 +219,26 @@ private:
         TkLockClosed
     };
 
+    //! Applies the screen lock and event eater states of a tklock_open mode
+    void applyTkLockMode(uint mode);
+
+    //! Starts waiting for the next frame of the screen lock window
+    void waitForLockScreenFrame();
+
     TouchScreen *m_touchScreen;
 
+    //! The window presenting the screen lock
+    QPointer<QQuickWindow> m_lockScreenWindow;
+
+    //! Replies to tklock_open calls waiting for the screen lock to be presented
+    QList<QDBusMessage> m_pendingReplies;
+
+    //! Timer for sending the pending replies if no frame is presented
+    QTimer *m_pendingRepliesTimer;
+
+    //! Measures the time from tklock_open to the first screen lock frame
+    QElapsedTimer m_lockScreenFrameTimer;
+
     //! The MCE callback method
     QDBusMessage m_callbackMethod;
 
@@ -15,18 +15,17 @@
 ****************************************************************************/
 #include <QGuiApplication>
 #include <QDBusContext>
-#include <QDBusConnectionInterface>
-#include <QFileInfo>
 #include "homewindow.h"
 #include <QQmlContext>
 #include <QScreen>
-#include "utilities/closeeventeater.h"
 #include "notifications/notificationmanager.h"
 #include "notifications/lipsticknotification.h"
+#include "notifications/systemnotification.h"
 #include "notifications/thermalnotifier.h"
 #include "homeapplication.h"
 #include "shutdownscreen.h"
 #include "lipstickqmlpath.h"
+#include "utilities/callercredentials.h"
 #include <unistd.h>
 
 ShutdownScreen::ShutdownScreen(QObject *parent) :
@@ -53,7 +52,7 @@ void ShutdownScreen::setWindowVisible(bool visible)
             m_window->setContextProperty("shutdownMode", m_shutdownMode);
             m_window->setContextProperty("user", m_user);
             m_window->setSource(QmlPath::to("system/ShutdownScreen.qml"));
-            m_window->installEventFilter(new CloseEventEater(this));
+            m_window->setCloseEventsIgnored(true);
         }
 
         if (!m_window->isVisible()) {
@@ -132,41 +131,14 @@ void ShutdownScreen::setUser(uint uid)
 
 void ShutdownScreen::publishNotification(const QString &icon, const QString &feedback, const QString &body)
 {
-    QVariantHash hints;
-    hints.insert(LipstickNotification::HINT_URGENCY, LipstickNotification::Critical);
-    hints.insert(LipstickNotification::HINT_TRANSIENT, true);
-    hints.insert(LipstickNotification::HINT_FEEDBACK, feedback);
-
-    NotificationManager *manager = NotificationManager::instance();
-    manager->Notify(manager->systemApplicationName(), 0, icon, QString(), body, QStringList(), hints, -1);
+    NotificationManager::instance()->publishSystemNotification(
+                SystemNotification(body).setIcon(icon).setFeedback(feedback));
 }
 
 void ShutdownScreen::setShutdownMode(const QString &mode)
 {
-    if (!isPrivileged())
-        return;
-
-    m_shutdownMode = mode;
-    applySystemState(DeviceState::DeviceState::Shutdown);
-}
-
-bool ShutdownScreen::isPrivileged()
-{
-    if (!calledFromDBus()) {
-        // Local function calls are always privileged
-        return true;
-    }
-
-    // Get the PID of the calling process
-    pid_t pid = connection().interface()->servicePid(message().service());
-
-    // The /proc/<pid> directory is owned by EUID:EGID of the process
-    QFileInfo info(QString("/proc/%1").arg(pid));
-    if (info.group() != "privileged" && info.owner() != "root") {
-        sendErrorReply(QDBusError::AccessDenied,
-                QString("PID %1 is not in privileged group").arg(pid));
-        return false;
-    }
-
-    return true;
+    CallerCredentials::instance()->runPrivileged(*this, this, [this, mode] {
+        m_shutdownMode = mode;
+        applySystemState(DeviceState::DeviceState::Shutdown);
+    });
 }
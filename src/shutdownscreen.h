@@ -100,8 +100,6 @@ private:
 #ifdef UNIT_TEST
     friend class Ut_ShutdownScreen;
 #endif
-
-    bool isPrivileged();
 };
 
 #endif // SHUTDOWNSCREEN_H
@@ -45,6 +45,7 @@ PUBLICHEADERS += \
     components/launcherfoldermodel.h \
     notifications/notificationmanager.h \
     notifications/lipsticknotification.h \
+    notifications/systemnotification.h \
     notifications/notificationlistmodel.h \
     notifications/notificationpreviewpresenter.h \
     usbmodeselector.h \
@@ -73,6 +74,7 @@ HEADERS += \
     screenlock/screenlock.h \
     screenlock/screenlockadaptor.h \
     touchscreen/touchscreen_p.h \
+    homequickwindow_p.h \
     volume/volumecontrol.h \
     volume/pulseaudiocontrol.h \
     lipstickapi.h \
@@ -88,8 +90,12 @@ HEADERS += \
     devicestate/devicestate_p.h \
     devicestate/displaystate_p.h \
     devicestate/ipcinterface_p.h \
+    devicestate/statesnapshot_p.h \
     devicestate/thermal_p.h \
     logging.h \
+    tracing.h \
+    traceservice.h \
+    utilities/callercredentials.h \
 
 SOURCES += \
     3rdparty/dbus-gmain/dbus-gmain.c \
@@ -99,6 +105,7 @@ SOURCES += \
     lipstickqmlpath.cpp \
     utilities/qobjectlistmodel.cpp \
     utilities/closeeventeater.cpp \
+    utilities/callercredentials.cpp \
     components/launcheritem.cpp \
     components/launchermodel.cpp \
     components/launcherwatchermodel.cpp \
@@ -135,7 +142,10 @@ SOURCES += \
     devicestate/devicestate.cpp \
     devicestate/thermal.cpp \
     devicestate/ipcinterface.cpp \
+    devicestate/statesnapshot.cpp \
     logging.cpp \
+    tracing.cpp \
+    traceservice.cpp \
 
 CONFIG += link_pkgconfig mobility qt warn_on depend_includepath qmake_cache target_qt
 CONFIG -= link_prl
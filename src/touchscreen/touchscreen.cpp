@@ -15,6 +15,7 @@
 
 #include "touchscreen.h"
 #include "touchscreen_p.h"
+#include "tracing.h"
 
 #include <QTimerEvent>
 #include <QDBusConnection>
@@ -110,6 +111,10 @@ TouchScreen::TouchScreen(QObject *parent)
     , d_ptr(new TouchScreenPrivate(this))
 {
     Q_D(TouchScreen);
+
+    // Start from the state known earlier during this boot so that the first evaluation is already right
+    d->currentDisplayState = (TouchScreen::DisplayState)d->displayState->lastKnown();
+
     connect(d->displayState, &DeviceState::DisplayStateMonitor::displayStateChanged, this, [=](DeviceState::DisplayStateMonitor::DisplayState state) {
         TouchScreen::DisplayState newState = (TouchScreen::DisplayState)state;
         if (d->currentDisplayState != newState) {
@@ -197,6 +202,8 @@ bool TouchScreen::eventFilter(QObject *, QEvent *event)
     Q_D(TouchScreen);
 
     if (userInteracting(event)) {
+        LIPSTICK_TRACE_SCOPE("input", "userInteraction");
+
         if (touchBlocked()) {
             event->accept();
             return true;
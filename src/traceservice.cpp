@@ -0,0 +1,87 @@
+/***************************************************************************
+**
+** Copyright (c) 2021 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#include "traceservice.h"
+#include "tracing.h"
+#include "logging.h"
+#include "utilities/callercredentials.h"
+
+#include <QDir>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+TraceService::TraceService(QObject *parent)
+    : QObject(parent)
+{
+}
+
+void TraceService::setEnabled(bool enabled)
+{
+    CallerCredentials::instance()->runPrivileged(*this, this, [enabled] {
+        Tracing::setEnabled(enabled);
+        qCDebug(lcLipstickCoreLog) << "Tracing" << (enabled ? "enabled" : "disabled");
+    });
+}
+
+void TraceService::dump(const QString &name, const QString &format)
+{
+    Tracing::Format traceFormat;
+    if (format == QLatin1String("chrome")) {
+        traceFormat = Tracing::ChromeJson;
+    } else if (format == QLatin1String("systrace")) {
+        traceFormat = Tracing::Systrace;
+    } else {
+        qWarning() << "Unknown trace format" << format;
+        if (calledFromDBus()) {
+            sendErrorReply(QDBusError::InvalidArgs, QStringLiteral("Unknown trace format: %1").arg(format));
+        }
+        return;
+    }
+
+    // Only plain file names, the traces are not written outside of the trace directory
+    if (name.isEmpty() || name.contains(QLatin1Char('/')) || name.startsWith(QLatin1Char('.'))) {
+        qWarning() << "Invalid trace file name" << name;
+        if (calledFromDBus()) {
+            sendErrorReply(QDBusError::InvalidArgs, QStringLiteral("Invalid trace file name: %1").arg(name));
+        }
+        return;
+    }
+
+    CallerCredentials::instance()->runPrivileged(*this, this, [name, traceFormat](const QDBusMessage &message) -> QDBusMessage {
+        const QString directory = QStandardPaths::writableLocation(QStandardPaths::RuntimeLocation)
+                + QStringLiteral("/lipstick-trace");
+        if (!QDir().mkpath(directory)) {
+            qWarning() << "Unable to create trace directory" << directory;
+            return message.createErrorReply(QDBusError::Failed,
+                                            QStringLiteral("Unable to create trace directory %1").arg(directory));
+        }
+
+        QSaveFile file(directory + QLatin1Char('/') + name);
+        if (!file.open(QIODevice::WriteOnly) || !Tracing::write(&file, traceFormat) || !file.commit()) {
+            qWarning() << "Unable to write trace to" << file.fileName() << file.errorString();
+            return message.createErrorReply(QDBusError::Failed,
+                                            QStringLiteral("Unable to write trace to %1: %2").arg(file.fileName(), file.errorString()));
+        }
+
+        qCDebug(lcLipstickCoreLog) << "Trace written to" << file.fileName();
+        return message.createReply();
+    });
+}
+
+void TraceService::clear()
+{
+    CallerCredentials::instance()->runPrivileged(*this, this, [] {
+        Tracing::clear();
+    });
+}
@@ -0,0 +1,64 @@
+/***************************************************************************
+**
+** Copyright (c) 2021 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#ifndef TRACESERVICE_H
+#define TRACESERVICE_H
+
+#include "lipstickdbus.h"
+#include <QDBusContext>
+#include <QObject>
+
+/*!
+ * \class TraceService
+ *
+ * \brief Controls the tracing of lipstick over D-Bus.
+ *
+ * Only privileged callers may enable tracing or write out the recorded
+ * events. The traces are written to the lipstick-trace directory in the
+ * runtime directory of lipstick. For example:
+ *
+ *   gdbus call -e -d org.nemomobile.lipstick -o /org/nemomobile/lipstick/trace \
+ *       -m org.nemomobile.lipstick.Trace.dump lipstick.json chrome
+ *
+ * writes $XDG_RUNTIME_DIR/lipstick-trace/lipstick.json.
+ */
+class TraceService : public QObject, protected QDBusContext
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", LIPSTICK_DBUS_TRACE_INTERFACE)
+
+public:
+    explicit TraceService(QObject *parent = 0);
+
+public slots:
+    /*!
+     * Starts or stops recording events. Events recorded earlier are kept.
+     */
+    void setEnabled(bool enabled);
+
+    /*!
+     * Writes the recorded events to the file \a name in the trace directory
+     * in \a format, which is either "chrome" for the Chrome trace event JSON
+     * format or "systrace" for the systrace text format. A D-Bus caller gets
+     * a Failed error if the file can not be written.
+     */
+    void dump(const QString &name, const QString &format);
+
+    /*!
+     * Discards the recorded events.
+     */
+    void clear();
+};
+
+#endif // TRACESERVICE_H
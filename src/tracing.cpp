@@ -0,0 +1,297 @@
+/***************************************************************************
+**
+** Copyright (c) 2021 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#include "tracing.h"
+
+#include <QIODevice>
+#include <QList>
+#include <QMutex>
+#include <QVector>
+#include <algorithm>
+#include <sys/prctl.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace Tracing {
+
+std::atomic<bool> g_enabled(qEnvironmentVariableIsSet("LIPSTICK_TRACE"));
+
+namespace {
+
+// Events kept per thread, the oldest ones are overwritten
+const quint32 BufferCapacity = 16384;
+
+struct Event
+{
+    const char *category;
+    const char *name;
+    quint64 start;
+    quint64 duration;
+    bool instant;
+};
+
+// Only the owning thread modifies a buffer. Readers copy the events and then
+// discard the ones whose slots the owner started to overwrite meanwhile.
+struct ThreadBuffer
+{
+    pid_t tid;
+    char threadName[16];
+    // Number of events whose slot the owner has started to write
+    std::atomic<quint64> claimed;
+    // Number of events written completely
+    std::atomic<quint64> count;
+    // Index of the first event recorded since the epoch of the buffer
+    std::atomic<quint64> first;
+    std::atomic<quint64> epoch;
+    Event events[BufferCapacity];
+};
+
+// Buffers of all threads that have recorded something. They are never freed
+// so that the events of threads that have already finished can be written out.
+QMutex buffersMutex;
+QList<ThreadBuffer *> buffers;
+
+// Bumped by clear(). Events of a buffer whose owner has not recorded anything
+// since are all older than the clear.
+std::atomic<quint64> clearEpoch(0);
+
+thread_local ThreadBuffer *threadBuffer = nullptr;
+
+ThreadBuffer *currentThreadBuffer()
+{
+    if (!threadBuffer) {
+        ThreadBuffer *buffer = new ThreadBuffer;
+        buffer->tid = ::syscall(SYS_gettid);
+        buffer->threadName[0] = '\0';
+        ::prctl(PR_GET_NAME, buffer->threadName);
+        buffer->claimed = 0;
+        buffer->count = 0;
+        buffer->first = 0;
+        buffer->epoch = clearEpoch.load(std::memory_order_relaxed);
+
+        QMutexLocker locker(&buffersMutex);
+        buffers.append(buffer);
+        threadBuffer = buffer;
+    }
+    return threadBuffer;
+}
+
+void record(const char *category, const char *name, quint64 start, quint64 duration, bool instant)
+{
+    // A scope may end after tracing has been disabled
+    if (!isEnabled()) {
+        return;
+    }
+
+    ThreadBuffer *buffer = currentThreadBuffer();
+    const quint64 index = buffer->count.load(std::memory_order_relaxed);
+
+    const quint64 epoch = clearEpoch.load(std::memory_order_relaxed);
+    if (buffer->epoch.load(std::memory_order_relaxed) != epoch) {
+        // Drop the events recorded before the buffer was cleared
+        buffer->first.store(index, std::memory_order_relaxed);
+        buffer->epoch.store(epoch, std::memory_order_release);
+    }
+
+    // Claim the slot before overwriting the event in it, see collectEvents()
+    buffer->claimed.store(index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    Event &event = buffer->events[index % BufferCapacity];
+    event.category = category;
+    event.name = name;
+    event.start = start;
+    event.duration = duration;
+    event.instant = instant;
+    buffer->count.store(index + 1, std::memory_order_release);
+}
+
+struct ThreadEvent
+{
+    const ThreadBuffer *thread;
+    Event event;
+};
+
+QVector<ThreadEvent> collectEvents()
+{
+    QVector<ThreadEvent> events;
+
+    QMutexLocker locker(&buffersMutex);
+    const quint64 epoch = clearEpoch.load(std::memory_order_relaxed);
+    foreach (const ThreadBuffer *buffer, buffers) {
+        if (buffer->epoch.load(std::memory_order_acquire) != epoch) {
+            // Nothing has been recorded since the last clear
+            continue;
+        }
+
+        const quint64 count = buffer->count.load(std::memory_order_acquire);
+        const quint64 first = qMax(buffer->first.load(std::memory_order_relaxed),
+                                   count > BufferCapacity ? count - BufferCapacity : 0);
+        const int copied = events.count();
+        for (quint64 i = first; i < count; ++i) {
+            ThreadEvent threadEvent = { buffer, buffer->events[i % BufferCapacity] };
+            events.append(threadEvent);
+        }
+
+        // The owner may have kept recording while the events were copied.
+        // Discard the copies of the slots it has claimed since.
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const quint64 claimed = buffer->claimed.load(std::memory_order_relaxed);
+        if (claimed > first + BufferCapacity) {
+            const int overwritten = int(qMin(claimed - BufferCapacity - first, count - first));
+            events.remove(copied, overwritten);
+        }
+    }
+
+    // Enclosing scopes are recorded after the events inside them, but have to come first
+    std::sort(events.begin(), events.end(), [](const ThreadEvent &lhs, const ThreadEvent &rhs) {
+        if (lhs.event.start != rhs.event.start) {
+            return lhs.event.start < rhs.event.start;
+        }
+        return lhs.event.duration > rhs.event.duration;
+    });
+    return events;
+}
+
+QByteArray jsonString(const char *string)
+{
+    QByteArray escaped(string);
+    escaped.replace('\\', "\\\\").replace('"', "\\\"");
+    return '"' + escaped + '"';
+}
+
+QByteArray microseconds(quint64 nsecs)
+{
+    return QByteArray::number(nsecs / 1000) + '.' + QByteArray::number(nsecs % 1000).rightJustified(3, '0');
+}
+
+QByteArray seconds(quint64 nsecs)
+{
+    return QByteArray::number(nsecs / 1000000000) + '.' + QByteArray::number((nsecs / 1000) % 1000000).rightJustified(6, '0');
+}
+
+bool writeChromeJson(QIODevice *device, const QVector<ThreadEvent> &events)
+{
+    const QByteArray pid(QByteArray::number(::getpid()));
+    QByteArray data("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+
+    bool first = true;
+    {
+        QMutexLocker locker(&buffersMutex);
+        foreach (const ThreadBuffer *buffer, buffers) {
+            data += QByteArray(first ? "" : ",")
+                    + "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" + pid
+                    + ",\"tid\":" + QByteArray::number(buffer->tid)
+                    + ",\"args\":{\"name\":" + jsonString(buffer->threadName) + "}}";
+            first = false;
+        }
+    }
+
+    foreach (const ThreadEvent &threadEvent, events) {
+        const Event &event = threadEvent.event;
+        data += QByteArray(first ? "" : ",")
+                + "\n{\"name\":" + jsonString(event.name)
+                + ",\"cat\":" + jsonString(event.category)
+                + (event.instant ? QByteArray(",\"ph\":\"i\",\"s\":\"t\"") : ",\"ph\":\"X\",\"dur\":" + microseconds(event.duration))
+                + ",\"ts\":" + microseconds(event.start)
+                + ",\"pid\":" + pid
+                + ",\"tid\":" + QByteArray::number(threadEvent.thread->tid) + "}";
+        first = false;
+    }
+    data += "\n]}\n";
+
+    return device->write(data) == data.size();
+}
+
+bool writeSystrace(QIODevice *device, const QVector<ThreadEvent> &events)
+{
+    const QByteArray pid(QByteArray::number(::getpid()));
+
+    // Slices are written as begin and end markers, which have to be in time order
+    struct Marker
+    {
+        quint64 time;
+        const ThreadBuffer *thread;
+        QByteArray text;
+    };
+    QVector<Marker> markers;
+    markers.reserve(events.count() * 2);
+    foreach (const ThreadEvent &threadEvent, events) {
+        // Instant events become slices without a duration, not every systrace parser knows the instant marker
+        const Event &event = threadEvent.event;
+        Marker begin = { event.start, threadEvent.thread, "B|" + pid + '|' + event.name };
+        Marker end = { event.start + event.duration, threadEvent.thread, "E|" + pid };
+        markers.append(begin);
+        markers.append(end);
+    }
+    std::stable_sort(markers.begin(), markers.end(), [](const Marker &lhs, const Marker &rhs) {
+        return lhs.time < rhs.time;
+    });
+
+    QByteArray data("# tracer: nop\n#\n");
+    foreach (const Marker &marker, markers) {
+        data += QByteArray(marker.thread->threadName) + '-' + QByteArray::number(marker.thread->tid)
+                + " [000] ...1 " + seconds(marker.time) + ": tracing_mark_write: " + marker.text + '\n';
+    }
+
+    return device->write(data) == data.size();
+}
+
+}
+
+void setEnabled(bool enabled)
+{
+    g_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+quint64 now()
+{
+    struct timespec time;
+    ::clock_gettime(CLOCK_MONOTONIC, &time);
+    return quint64(time.tv_sec) * 1000000000 + time.tv_nsec;
+}
+
+void recordScope(const char *category, const char *name, quint64 start)
+{
+    const quint64 end = now();
+    record(category, name, start, end - start, false);
+}
+
+void recordInstant(const char *category, const char *name)
+{
+    record(category, name, now(), 0, true);
+}
+
+bool write(QIODevice *device, Format format)
+{
+    const QVector<ThreadEvent> events(collectEvents());
+
+    switch (format) {
+    case ChromeJson:
+        return writeChromeJson(device, events);
+    case Systrace:
+        return writeSystrace(device, events);
+    }
+    return false;
+}
+
+void clear()
+{
+    // The buffers are only modified by their owners, which apply the new
+    // epoch when they record the next event
+    clearEpoch.fetch_add(1, std::memory_order_relaxed);
+}
+
+}
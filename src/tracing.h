@@ -0,0 +1,106 @@
+/***************************************************************************
+**
+** Copyright (c) 2021 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#ifndef LIPSTICK_TRACING_H
+#define LIPSTICK_TRACING_H
+
+#include <QtGlobal>
+#include <atomic>
+
+class QIODevice;
+
+/*
+ * Lightweight tracing of lipstick's latency sensitive paths.
+ *
+ * Scopes and instant events are named with string literals, so recording
+ * an event only stores two pointers and a timestamp into a ring buffer of
+ * the calling thread without locking or formatting. When tracing is
+ * disabled a scope costs a single relaxed atomic load.
+ *
+ * Tracing is enabled with the LIPSTICK_TRACE environment variable or
+ * through the trace D-Bus service, which also writes out the recorded
+ * events in the Chrome trace event JSON format, understood by Perfetto and
+ * chrome://tracing, or in the systrace text format.
+ */
+namespace Tracing {
+
+enum Format {
+    ChromeJson,
+    Systrace
+};
+
+extern std::atomic<bool> g_enabled;
+
+inline bool isEnabled()
+{
+    return g_enabled.load(std::memory_order_relaxed);
+}
+
+void setEnabled(bool enabled);
+
+//! Returns the CLOCK_MONOTONIC time in nanoseconds
+quint64 now();
+
+//! Records an event lasting from \a start until now
+void recordScope(const char *category, const char *name, quint64 start);
+//! Records an event without a duration
+void recordInstant(const char *category, const char *name);
+
+//! Writes the recorded events of all threads in \a format
+bool write(QIODevice *device, Format format);
+//! Discards the recorded events
+void clear();
+
+class Scope
+{
+public:
+    Scope(const char *category, const char *name)
+        : m_category(category)
+        , m_name(name)
+        , m_start(isEnabled() ? now() : 0)
+    {
+    }
+
+    ~Scope()
+    {
+        if (m_start) {
+            recordScope(m_category, m_name, m_start);
+        }
+    }
+
+private:
+    Q_DISABLE_COPY(Scope)
+
+    const char *m_category;
+    const char *m_name;
+    quint64 m_start;
+};
+
+}
+
+#define LIPSTICK_TRACE_CONCAT_(a, b) a##b
+#define LIPSTICK_TRACE_CONCAT(a, b) LIPSTICK_TRACE_CONCAT_(a, b)
+
+// Traces the rest of the enclosing block. The category and the name must be string literals.
+#define LIPSTICK_TRACE_SCOPE(category, name) \
+    Tracing::Scope LIPSTICK_TRACE_CONCAT(lipstickTraceScope, __LINE__)(category, name)
+
+// Traces a single point in time. The category and the name must be string literals.
+#define LIPSTICK_TRACE_INSTANT(category, name) \
+    do { \
+        if (Tracing::isEnabled()) \
+            Tracing::recordInstant(category, name); \
+    } while (0)
+
+#endif
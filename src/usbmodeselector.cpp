@@ -18,7 +18,6 @@
 #include <QQmlContext>
 #include <QScreen>
 #include <qusbmoded.h>
-#include "utilities/closeeventeater.h"
 #include "notifications/notificationmanager.h"
 #include "notifications/lipsticknotification.h"
 #include "usbmodeselector.h"
@@ -26,15 +25,26 @@
 
 #include <nemo-devicelock/devicelock.h>
 
+namespace {
+// Time the USB state must stay unchanged before it is handled
+const int StateSettleDelay = 250;
+}
+
 USBModeSelector::USBModeSelector(NemoDeviceLock::DeviceLock *deviceLock, QObject *parent) :
     QObject(parent),
     m_usbMode(new QUsbModed(this)),
     m_deviceLock(deviceLock),
     m_windowVisible(false),
-    m_preparingMode()
+    m_preparingMode(),
+    m_stateNotification(Notification::Invalid),
+    m_modeRequested(false)
 {
+    m_stateSettleTimer.setSingleShot(true);
+    m_stateSettleTimer.setInterval(StateSettleDelay);
+    connect(&m_stateSettleTimer, &QTimer::timeout, this, &USBModeSelector::handleUSBState);
+
     connect(m_usbMode, &QUsbModed::eventReceived, this, &USBModeSelector::handleUSBEvent);
-    connect(m_usbMode, &QUsbModed::currentModeChanged, this, &USBModeSelector::handleUSBState);
+    connect(m_usbMode, &QUsbModed::currentModeChanged, this, &USBModeSelector::scheduleUSBStateHandling);
     connect(m_usbMode, &QUsbModed::targetModeChanged, this, &USBModeSelector::updateModePreparing);
     connect(m_usbMode, SIGNAL(usbStateError(QString)), this, SIGNAL(showError(QString)));
     connect(m_usbMode, SIGNAL(supportedModesChanged()), this, SIGNAL(supportedModesChanged()));
@@ -88,16 +98,37 @@ void USBModeSelector::handleUSBEvent(const QString &event)
             emit dialogShown();
             emit showNotification(Notification::Locked);
         }
+    } else if (event == QUsbModed::Mode::Disconnected) {
+        // The next connection is notified about even if it ends up in the same mode
+        m_stateNotification = Notification::Invalid;
     } else if (event == QUsbModed::Mode::ModeRequest) {
-        setWindowVisible(true);
+        // Shown once the state has settled, unless a mode gets selected meanwhile
+        m_modeRequested = true;
+        m_stateSettleTimer.start();
     } else if (event == QUsbMode::Mode::ChargerConnected) {
         // Hide the mode selection dialog and show a mode notification
+        m_modeRequested = false;
         setWindowVisible(false);
     }
 }
 
+void USBModeSelector::scheduleUSBStateHandling()
+{
+    // The preparing state is cheap to update and shown as progress, keep it current
+    updateModePreparing();
+
+    if (m_usbMode->currentMode() == QUsbModed::Mode::Busy) {
+        // Entering a mode again after switching is notified about again
+        m_stateNotification = Notification::Invalid;
+    }
+
+    m_stateSettleTimer.start();
+}
+
 void USBModeSelector::handleUSBState()
 {
+    m_stateSettleTimer.stop();
+
     // States (from usb_moded-modes.h):
     //
     // Undefined, Ask, MassStorage, Developer, MTP, Host, ConnectionSharing,
@@ -105,6 +136,8 @@ void USBModeSelector::handleUSBState()
 
     QString mode = m_usbMode->currentMode();
     USBModeSelector::Notification type = Notification::Invalid;
+    const bool modeRequested = m_modeRequested;
+    m_modeRequested = false;
 
     updateModePreparing();
 
@@ -112,17 +145,28 @@ void USBModeSelector::handleUSBState()
         // This probably isn't necessary, as it'll be handled by ModeRequest
         setWindowVisible(true);
     } else if (mode == QUsbMode::Mode::ChargingFallback) {
-        // Do nothing
+        // Only the dialog requested by usb_moded is shown
+        if (modeRequested)
+            setWindowVisible(true);
     } else if (mode == QUsbMode::Mode::Charging) {
         // Hide the mode selection dialog and show a mode notification
         setWindowVisible(false);
+        type = Notification::Charging;
     } else if (QUsbMode::isFinalState(mode)) {
         // Hide the mode selection dialog and show a mode notification
         setWindowVisible(false);
         type = convertModeToNotification(mode);
+    } else if (modeRequested) {
+        setWindowVisible(true);
     }
 
-    if (type != Notification::Invalid && type != Notification::Charging)
+    // Returning to the state that was already notified about does not need a new notification
+    if (type == Notification::Invalid || type == m_stateNotification)
+        return;
+
+    m_stateNotification = type;
+
+    if (type != Notification::Charging)
         emit showNotification(type);
 }
 
@@ -19,6 +19,7 @@
 
 #include <QObject>
 #include <QStringList>
+#include <QTimer>
 #include "lipstickglobal.h"
 
 class QUsbModed;
@@ -166,9 +167,19 @@ private:
      */
     void handleUSBEvent(const QString &event);
 
+    /*!
+     * Schedule handling of a USB state change in QUsbModed. The state is
+     * handled once it has stayed unchanged for a moment, so that quick
+     * plug and unplug cycles do not cause a burst of notifications and
+     * dialog changes.
+     */
+    void scheduleUSBStateHandling();
+
     /*!
      * Handle a USB state change in QUsbModed. Triggers notification
-     * and dialogue signals.
+     * and dialogue signals. A notification is requested only once for
+     * each settled state, until the cable is disconnected or usb_moded
+     * switches modes.
      *
      * \param mode the USB mode to show UI elements for
      */
@@ -204,6 +215,15 @@ private:
     //! State indicating whether the device is preparing a USB mode or not
     QString m_preparingMode;
 
+    //! Timer for waiting the USB state to settle before handling it
+    QTimer m_stateSettleTimer;
+
+    //! The notification requested for the latest settled USB state
+    Notification m_stateNotification;
+
+    //! Whether usb_moded has asked for the mode selection dialog since the last settled state
+    bool m_modeRequested;
+
 #ifdef UNIT_TEST
     friend class Ut_USBModeSelector;
 #endif
@@ -0,0 +1,259 @@
+/***************************************************************************
+**
+** Copyright (c) 2021 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#include <QCoreApplication>
+#include <QDBusArgument>
+#include <QDBusContext>
+#include <QDBusPendingCallWatcher>
+#include <QDBusPendingReply>
+#include <QDBusServiceWatcher>
+#include <grp.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "logging.h"
+#include "callercredentials.h"
+
+namespace {
+
+const char * const PrivilegedGroupName = "privileged";
+const char * const ConnectionProperty = "callerCredentialsConnection";
+const char * const ServiceProperty = "callerCredentialsService";
+
+QList<uint> groupIds(const QVariant &value)
+{
+    if (value.canConvert<QDBusArgument>()) {
+        return qdbus_cast<QList<uint> >(value.value<QDBusArgument>());
+    }
+    return value.value<QList<uint> >();
+}
+
+bool credentialsArePrivileged(const QVariantMap &credentials)
+{
+    bool ok = false;
+    const uint uid = credentials.value(QStringLiteral("UnixUserID")).toUInt(&ok);
+    if (ok && uid == 0) {
+        return true;
+    }
+
+    const gid_t privilegedGid = CallerCredentials::privilegedGroupId();
+    if (privilegedGid != gid_t(-1) && groupIds(credentials.value(QStringLiteral("UnixGroupIDs"))).contains(privilegedGid)) {
+        return true;
+    }
+
+    // Setgid binaries are privileged through their effective group, which
+    // is not necessarily listed among the groups reported by the bus
+    const uint pid = credentials.value(QStringLiteral("ProcessID")).toUInt(&ok);
+    return ok && CallerCredentials::processIsPrivileged(pid);
+}
+
+}
+
+CallerCredentials *CallerCredentials::instance()
+{
+    static CallerCredentials *callerCredentials = 0;
+    if (!callerCredentials) {
+        callerCredentials = new CallerCredentials(qApp);
+    }
+    return callerCredentials;
+}
+
+CallerCredentials::CallerCredentials(QObject *parent)
+    : QObject(parent)
+{
+}
+
+gid_t CallerCredentials::privilegedGroupId()
+{
+    static gid_t gid = gid_t(-1);
+    static bool resolved = false;
+    if (!resolved) {
+        resolved = true;
+        if (struct group *g = getgrnam(PrivilegedGroupName)) {
+            gid = g->gr_gid;
+        }
+    }
+    return gid;
+}
+
+bool CallerCredentials::processIsPrivileged(pid_t pid)
+{
+    if (pid == getpid()) {
+        // Internal operations are considered privileged
+        return true;
+    } else if (pid <= 0) {
+        return false;
+    }
+
+    // The /proc/<pid> directory is owned by EUID:EGID of the process
+    struct stat st;
+    if (stat(QByteArray("/proc/").append(QByteArray::number(pid)).constData(), &st) != 0) {
+        return false;
+    }
+
+    const gid_t privilegedGid = privilegedGroupId();
+    return st.st_uid == 0 || (privilegedGid != gid_t(-1) && st.st_gid == privilegedGid);
+}
+
+void CallerCredentials::runPrivileged(const QDBusContext &context, QObject *guard, const std::function<void()> &action)
+{
+    runPrivileged(context, guard, [action](const QDBusMessage &message) {
+        action();
+        return message.createReply();
+    });
+}
+
+void CallerCredentials::runPrivileged(const QDBusContext &context, QObject *guard,
+                                      const std::function<QDBusMessage(const QDBusMessage &)> &action)
+{
+    if (!context.calledFromDBus()) {
+        // Local function calls are always privileged
+        action(QDBusMessage());
+        return;
+    }
+
+    const QDBusConnection connection = context.connection();
+    const QString service = context.message().service();
+    const QString key = cacheKey(connection.name(), service);
+
+    // The reply comes from the action, not from the return value of the method
+    context.setDelayedReply(true);
+    PendingCall call = { connection, context.message(), guard, action };
+
+    QHash<QString, bool>::const_iterator cached = m_privileged.constFind(key);
+    if (cached != m_privileged.constEnd()) {
+        finish(call, cached.value());
+        return;
+    }
+
+    QList<PendingCall> &calls = m_pendingCalls[key];
+    calls.append(call);
+    if (calls.count() > 1) {
+        // The credentials of the caller are already being resolved
+        return;
+    }
+
+    QDBusServiceWatcher *&watcher = m_serviceWatchers[connection.name()];
+    if (!watcher) {
+        watcher = new QDBusServiceWatcher(QString(), connection, QDBusServiceWatcher::WatchForUnregistration, this);
+        connect(watcher, &QDBusServiceWatcher::serviceUnregistered, this, &CallerCredentials::serviceUnregistered);
+    }
+    watcher->addWatchedService(service);
+
+    QDBusMessage request = QDBusMessage::createMethodCall("org.freedesktop.DBus", "/org/freedesktop/DBus", "org.freedesktop.DBus", "GetConnectionCredentials");
+    request << service;
+    QDBusPendingCallWatcher *callWatcher = new QDBusPendingCallWatcher(connection.asyncCall(request), this);
+    callWatcher->setProperty(ConnectionProperty, connection.name());
+    callWatcher->setProperty(ServiceProperty, service);
+    connect(callWatcher, &QDBusPendingCallWatcher::finished, this, &CallerCredentials::credentialsReply);
+}
+
+void CallerCredentials::credentialsReply(QDBusPendingCallWatcher *watcher)
+{
+    const QString connectionName = watcher->property(ConnectionProperty).toString();
+    const QString service = watcher->property(ServiceProperty).toString();
+    const QString key = cacheKey(connectionName, service);
+    QDBusPendingReply<QVariantMap> reply = *watcher;
+    watcher->deleteLater();
+
+    bool privileged = false;
+    if (reply.isError()) {
+        qWarning() << "CallerCredentials: GetConnectionCredentials failed:" << reply.error().name() << reply.error().message();
+        if (reply.error().type() == QDBusError::NameHasNoOwner) {
+            forgetService(connectionName, service);
+        }
+    } else {
+        privileged = credentialsArePrivileged(reply.value());
+        // Cached until the name disappears from the bus, unless it already
+        // did while the credentials were being resolved
+        QDBusServiceWatcher *serviceWatcher = m_serviceWatchers.value(connectionName);
+        if (serviceWatcher && serviceWatcher->watchedServices().contains(service)) {
+            m_privileged.insert(key, privileged);
+            verifyOwner(QDBusConnection(connectionName), service);
+        }
+    }
+    qCDebug(lcLipstickCoreLog) << "CallerCredentials:" << key << "-> privileged" << privileged;
+
+    const QList<PendingCall> calls = m_pendingCalls.take(key);
+    for (const PendingCall &call : calls) {
+        finish(call, privileged);
+    }
+}
+
+void CallerCredentials::verifyOwner(const QDBusConnection &connection, const QString &service)
+{
+    // The watcher does not report a name that left the bus before the watch
+    // took effect, so drop the entry if the name has no owner by now
+    QDBusMessage request = QDBusMessage::createMethodCall("org.freedesktop.DBus", "/org/freedesktop/DBus", "org.freedesktop.DBus", "NameHasOwner");
+    request << service;
+    QDBusPendingCallWatcher *callWatcher = new QDBusPendingCallWatcher(connection.asyncCall(request), this);
+    callWatcher->setProperty(ConnectionProperty, connection.name());
+    callWatcher->setProperty(ServiceProperty, service);
+    connect(callWatcher, &QDBusPendingCallWatcher::finished, this, &CallerCredentials::ownerReply);
+}
+
+void CallerCredentials::ownerReply(QDBusPendingCallWatcher *watcher)
+{
+    QDBusPendingReply<bool> reply = *watcher;
+    watcher->deleteLater();
+
+    if (reply.isError() || !reply.value()) {
+        forgetService(watcher->property(ConnectionProperty).toString(), watcher->property(ServiceProperty).toString());
+    }
+}
+
+void CallerCredentials::serviceUnregistered(const QString &service)
+{
+    QDBusServiceWatcher *watcher = qobject_cast<QDBusServiceWatcher *>(sender());
+    if (!watcher) {
+        return;
+    }
+
+    forgetService(watcher->connection().name(), service);
+}
+
+void CallerCredentials::forgetService(const QString &connectionName, const QString &service)
+{
+    if (QDBusServiceWatcher *watcher = m_serviceWatchers.value(connectionName)) {
+        watcher->removeWatchedService(service);
+    }
+    m_privileged.remove(cacheKey(connectionName, service));
+}
+
+void CallerCredentials::finish(const PendingCall &call, bool privileged)
+{
+    if (privileged && call.guard) {
+        sendReply(call.connection, call.message, call.action(call.message));
+    } else {
+        sendReply(call.connection, call.message,
+                  call.message.createErrorReply(QDBusError::AccessDenied,
+                                                QString("%1 is not in privileged group").arg(call.message.service())));
+    }
+}
+
+void CallerCredentials::sendReply(const QDBusConnection &connection, const QDBusMessage &message, const QDBusMessage &reply)
+{
+    if (!message.isReplyRequired()) {
+        return;
+    }
+
+#ifdef UNIT_TEST
+    m_sentReplies.append(reply);
+#endif
+    connection.send(reply);
+}
+
+QString CallerCredentials::cacheKey(const QString &connectionName, const QString &service)
+{
+    return connectionName + QLatin1Char('/') + service;
+}
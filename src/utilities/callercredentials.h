@@ -0,0 +1,118 @@
+/***************************************************************************
+**
+** Copyright (c) 2021 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+#ifndef CALLERCREDENTIALS_H
+#define CALLERCREDENTIALS_H
+
+#include <QDBusConnection>
+#include <QDBusMessage>
+#include <QHash>
+#include <QObject>
+#include <QPointer>
+#include <functional>
+#include <sys/types.h>
+
+class QDBusContext;
+class QDBusPendingCallWatcher;
+class QDBusServiceWatcher;
+
+/*!
+ * \class CallerCredentials
+ *
+ * \brief Checks whether the callers of D-Bus methods are privileged.
+ *
+ * A caller is privileged when it runs as root or belongs to the
+ * "privileged" group. The credentials of a bus name are resolved with an
+ * asynchronous GetConnectionCredentials call and cached until the name
+ * disappears from the bus.
+ */
+class CallerCredentials : public QObject
+{
+    Q_OBJECT
+
+public:
+    /*!
+     * Returns the shared instance.
+     */
+    static CallerCredentials *instance();
+
+    /*!
+     * Runs \a action if the caller of the D-Bus method currently handled
+     * through \a context is privileged, and sends an AccessDenied error
+     * otherwise. Local calls are always privileged.
+     *
+     * If the caller has not been resolved yet, the reply of the method call
+     * is delayed and \a action runs once the credentials are known, unless
+     * \a guard has been destroyed by then. The action must not rely on the
+     * D-Bus context in that case; an empty reply is sent after it has run.
+     *
+     * \param context the D-Bus context of the method call being handled
+     * \param guard object whose lifetime bounds \a action
+     * \param action the privileged operation
+     */
+    void runPrivileged(const QDBusContext &context, QObject *guard, const std::function<void()> &action);
+
+    /*!
+     * Like the above, but \a action returns the reply to the method call
+     * message it is given, such as a reply with the return values or an
+     * error reply. The reply is always sent by CallerCredentials, exactly
+     * once, so the method must not reply itself. For local calls the
+     * message is empty and the returned reply is discarded.
+     */
+    void runPrivileged(const QDBusContext &context, QObject *guard,
+                       const std::function<QDBusMessage(const QDBusMessage &)> &action);
+
+    /*!
+     * Returns whether the process \a pid is privileged. Internal operations
+     * are always privileged.
+     */
+    static bool processIsPrivileged(pid_t pid);
+
+    /*!
+     * Returns the numeric id of the "privileged" group or -1 if there is
+     * no such group.
+     */
+    static gid_t privilegedGroupId();
+
+private slots:
+    void credentialsReply(QDBusPendingCallWatcher *watcher);
+    void ownerReply(QDBusPendingCallWatcher *watcher);
+    void serviceUnregistered(const QString &service);
+
+private:
+    explicit CallerCredentials(QObject *parent = 0);
+
+    struct PendingCall {
+        QDBusConnection connection;
+        QDBusMessage message;
+        QPointer<QObject> guard;
+        std::function<QDBusMessage(const QDBusMessage &)> action;
+    };
+
+    void verifyOwner(const QDBusConnection &connection, const QString &service);
+    void forgetService(const QString &connectionName, const QString &service);
+    void finish(const PendingCall &call, bool privileged);
+    void sendReply(const QDBusConnection &connection, const QDBusMessage &message, const QDBusMessage &reply);
+    static QString cacheKey(const QString &connectionName, const QString &service);
+
+    QHash<QString, bool> m_privileged;
+    QHash<QString, QList<PendingCall> > m_pendingCalls;
+    QHash<QString, QDBusServiceWatcher *> m_serviceWatchers;
+
+#ifdef UNIT_TEST
+    QList<QDBusMessage> m_sentReplies;
+    friend class Ut_CallerCredentials;
+#endif
+};
+
+#endif // CALLERCREDENTIALS_H
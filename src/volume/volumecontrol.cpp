@@ -21,7 +21,6 @@
 #include <QScreen>
 #include <QKeyEvent>
 #include <MGConfItem>
-#include "utilities/closeeventeater.h"
 #include "pulseaudiocontrol.h"
 #include "volumecontrol.h"
 #include "lipstickqmlpath.h"
@@ -354,7 +353,7 @@ void VolumeControl::createWindow()
     m_window->setWindowTitle("Volume");
     m_window->setContextProperty("initialSize", QGuiApplication::primaryScreen()->size());
     m_window->setSource(QmlPath::to("volumecontrol/VolumeControl.qml"));
-    m_window->installEventFilter(new CloseEventEater(this));
+    m_window->setCloseEventsIgnored(true);
 }
 
 bool VolumeControl::eventFilter(QObject *, QEvent *event)
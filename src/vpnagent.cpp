@@ -23,7 +23,6 @@
 #include <QTimer>
 #include <QDBusArgument>
 #include <QDBusConnection>
-#include "utilities/closeeventeater.h"
 #include "lipstickqmlpath.h"
 
 VpnAgent::VpnAgent(QObject *parent) :
@@ -48,7 +47,7 @@ void VpnAgent::createWindow()
     m_window->setContextProperty("vpnAgent", this);
     m_window->setContextProperty("initialSize", QGuiApplication::primaryScreen()->size());
     m_window->setSource(QmlPath::to("connectivity/VpnAgent.qml"));
-    m_window->installEventFilter(new CloseEventEater(this));
+    m_window->setCloseEventsIgnored(true);
 }
 
 void VpnAgent::setWindowVisible(bool visible)
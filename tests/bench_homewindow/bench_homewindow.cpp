@@ -0,0 +1,94 @@
+/***************************************************************************
+**
+** Copyright (c) 2021 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QCloseEvent>
+#include <QQuickWindow>
+
+#include "bench_homewindow.h"
+#include "homequickwindow_p.h"
+#include "utilities/closeeventeater.h"
+
+namespace {
+
+enum Suppression {
+    EventFilter,
+    WindowEvent
+};
+
+const int FloodSize = 10000;
+
+QQuickWindow *createWindow(Suppression suppression)
+{
+    if (suppression == EventFilter) {
+        QQuickWindow *window = new QQuickWindow;
+        window->installEventFilter(new CloseEventEater(window));
+        return window;
+    }
+
+    HomeQuickWindow *window = new HomeQuickWindow;
+    window->closeEventsIgnored = true;
+    return window;
+}
+
+void addRows()
+{
+    QTest::addColumn<int>("suppression");
+
+    QTest::newRow("event filter") << int(EventFilter);
+    QTest::newRow("window event") << int(WindowEvent);
+}
+
+}
+
+void Bench_HomeWindow::testCloseEventsIgnored_data()
+{
+    addRows();
+}
+
+void Bench_HomeWindow::testCloseEventsIgnored()
+{
+    QFETCH(int, suppression);
+
+    QScopedPointer<QQuickWindow> window(createWindow(Suppression(suppression)));
+    QSignalSpy closingSpy(window.data(), SIGNAL(closing(QQuickCloseEvent*)));
+
+    QCloseEvent event;
+    QCoreApplication::sendEvent(window.data(), &event);
+
+    QCOMPARE(closingSpy.count(), 0);
+}
+
+void Bench_HomeWindow::benchmarkEventFlood_data()
+{
+    addRows();
+}
+
+void Bench_HomeWindow::benchmarkEventFlood()
+{
+    QFETCH(int, suppression);
+
+    QScopedPointer<QQuickWindow> window(createWindow(Suppression(suppression)));
+
+    // An event type the window does not handle, so that the dispatch path
+    // is all that is measured
+    QEvent event(QEvent::User);
+    QBENCHMARK {
+        for (int i = 0; i < FloodSize; ++i) {
+            QCoreApplication::sendEvent(window.data(), &event);
+        }
+    }
+}
+
+QTEST_MAIN(Bench_HomeWindow)
@@ -0,0 +1,40 @@
+/***************************************************************************
+**
+** Copyright (c) 2021 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#ifndef BENCH_HOMEWINDOW_H
+#define BENCH_HOMEWINDOW_H
+
+#include <QObject>
+
+/*
+ * Benchmarks of the event dispatch of a home window that ignores close
+ * events. A flood of synthetic events is delivered to the window both with
+ * the CloseEventEater event filter that used to be installed on it and with
+ * the close events dropped in the event() override of the window.
+ *
+ * Use the QtTest output options to store the results for comparison, e.g.
+ *   bench_homewindow -o results.xml,xml
+ */
+class Bench_HomeWindow : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testCloseEventsIgnored_data();
+    void testCloseEventsIgnored();
+    void benchmarkEventFlood_data();
+    void benchmarkEventFlood();
+};
+
+#endif
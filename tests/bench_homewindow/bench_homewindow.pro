@@ -0,0 +1,14 @@
+include(../common.pri)
+TARGET = bench_homewindow
+
+QT += quick
+
+# unit test and unit
+SOURCES += \
+    bench_homewindow.cpp \
+    $$UTILITYSRCDIR/closeeventeater.cpp \
+
+HEADERS += \
+    bench_homewindow.h \
+    $$SRCDIR/homequickwindow_p.h \
+    $$UTILITYSRCDIR/closeeventeater.h \
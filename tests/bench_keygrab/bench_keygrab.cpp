@@ -0,0 +1,118 @@
+/***************************************************************************
+**
+** Copyright (c) 2021 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QKeyEvent>
+#include <QTimerEvent>
+#include <QTouchEvent>
+
+#include "bench_keygrab.h"
+#include "keygrabtable.h"
+
+namespace {
+
+enum Routing {
+    GrabTable,
+    EventFilters
+};
+
+enum EventType {
+    Touch,
+    Timer
+};
+
+const int FloodSize = 10000;
+
+// A grabbing window as LipstickCompositorWindow was before the grab table,
+// checking every event of the application for the keys it grabs
+class FilteringWindow : public QObject
+{
+public:
+    explicit FilteringWindow(const QList<int> &grabbedKeys)
+        : m_grabbedKeys(grabbedKeys)
+    {
+    }
+
+protected:
+    bool eventFilter(QObject *, QEvent *event) override
+    {
+        if (event->type() == QEvent::KeyPress || event->type() == QEvent::KeyRelease) {
+            QKeyEvent *keyEvent = static_cast<QKeyEvent *>(event);
+            return m_grabbedKeys.contains(keyEvent->key()) && !keyEvent->isAutoRepeat();
+        }
+        return false;
+    }
+
+private:
+    QList<int> m_grabbedKeys;
+};
+
+}
+
+void Bench_KeyGrab::benchmarkEventDispatch_data()
+{
+    QTest::addColumn<int>("windowCount");
+    QTest::addColumn<int>("routing");
+    QTest::addColumn<int>("eventType");
+
+    foreach (int windowCount, QList<int>() << 1 << 10 << 100) {
+        QTest::newRow(qPrintable(QString("%1 grabbing windows, grab table, touch").arg(windowCount)))
+                << windowCount << int(GrabTable) << int(Touch);
+        QTest::newRow(qPrintable(QString("%1 grabbing windows, grab table, timer").arg(windowCount)))
+                << windowCount << int(GrabTable) << int(Timer);
+        QTest::newRow(qPrintable(QString("%1 grabbing windows, event filters, touch").arg(windowCount)))
+                << windowCount << int(EventFilters) << int(Touch);
+        QTest::newRow(qPrintable(QString("%1 grabbing windows, event filters, timer").arg(windowCount)))
+                << windowCount << int(EventFilters) << int(Timer);
+    }
+}
+
+void Bench_KeyGrab::benchmarkEventDispatch()
+{
+    QFETCH(int, windowCount);
+    QFETCH(int, routing);
+    QFETCH(int, eventType);
+
+    // Every window grabs the volume keys and a key of its own
+    QList<QObject *> windows;
+    KeyGrabTable<QObject> table;
+    for (int i = 0; i < windowCount; ++i) {
+        const QList<int> keys = QList<int>() << Qt::Key_VolumeUp << Qt::Key_VolumeDown << Qt::Key_F1 + i;
+        if (routing == GrabTable) {
+            windows.append(new QObject);
+            table.setGrabbedKeys(windows.last(), keys);
+        } else {
+            windows.append(new FilteringWindow(keys));
+            qApp->installEventFilter(windows.last());
+        }
+    }
+
+    // The compositor only looks up the grab table for the key events it gets itself, so
+    // touch and timer events for anything else should not depend on the grabbing windows.
+    // Events for an item that does not handle them, so that the dispatch path is all that is measured
+    QObject receiver;
+    QTouchEvent touchEvent(QEvent::TouchUpdate);
+    QTimerEvent timerEvent(0);
+    QEvent *event = eventType == Touch ? static_cast<QEvent *>(&touchEvent) : static_cast<QEvent *>(&timerEvent);
+
+    QBENCHMARK {
+        for (int i = 0; i < FloodSize; ++i) {
+            QCoreApplication::sendEvent(&receiver, event);
+        }
+    }
+
+    qDeleteAll(windows);
+}
+
+QTEST_MAIN(Bench_KeyGrab)
@@ -0,0 +1,38 @@
+/***************************************************************************
+**
+** Copyright (c) 2021 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#ifndef BENCH_KEYGRAB_H
+#define BENCH_KEYGRAB_H
+
+#include <QObject>
+
+/*
+ * Benchmarks of the event dispatch in lipstick while windows grab keys.
+ * Touch and timer events are delivered with 1, 10 and 100 grabbing windows,
+ * both with the grabs in the KeyGrabTable of the compositor and with the
+ * application-wide event filter each grabbing window used to install.
+ *
+ * Use the QtTest output options to store the results for comparison, e.g.
+ *   bench_keygrab -o results.xml,xml
+ */
+class Bench_KeyGrab : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void benchmarkEventDispatch_data();
+    void benchmarkEventDispatch();
+};
+
+#endif
@@ -0,0 +1,12 @@
+include(../common.pri)
+TARGET = bench_keygrab
+INCLUDEPATH += $$COMPOSITORSRCDIR
+
+# benchmark
+SOURCES += \
+    bench_keygrab.cpp
+
+# benchmark and unit
+HEADERS += \
+    bench_keygrab.h \
+    $$COMPOSITORSRCDIR/keygrabtable.h
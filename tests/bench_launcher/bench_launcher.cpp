@@ -0,0 +1,383 @@
+/***************************************************************************
+**
+** Copyright (c) 2021 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QImage>
+#include "bench_launcher.h"
+#include "allocationcounter.h"
+
+#include "launcheritem.h"
+#include "launchermodel.h"
+#include "launcherfoldermodel.h"
+
+namespace {
+
+enum Metric {
+    WallTime,
+    Allocations,
+    Signals
+};
+
+// Number of desktop files touched at once by a package update
+const int StormSize = 30;
+
+class BenchLauncherModel : public LauncherModel
+{
+public:
+    BenchLauncherModel(const QString &applicationsDir, const QString &iconsDir)
+        : LauncherModel(DeferInitialization)
+    {
+        setDirectories(QStringList() << applicationsDir);
+        setIconDirectories(QStringList() << iconsDir);
+    }
+
+    using LauncherModel::initialize;
+};
+
+class BenchFolderModel : public LauncherFolderModel
+{
+public:
+    BenchFolderModel(const QString &applicationsDir, const QString &iconsDir)
+        : LauncherFolderModel(DeferInitialization)
+    {
+        setDirectories(QStringList() << applicationsDir);
+        setIconDirectories(QStringList() << iconsDir);
+        initialize();
+    }
+};
+
+QString applicationName(int index)
+{
+    return QString("bench-app%1").arg(index);
+}
+
+QList<QObject *> modelAndItems(QObjectListModel *model)
+{
+    QList<QObject *> objects;
+    objects.append(model);
+    for (int i = 0; i < model->itemCount(); ++i) {
+        objects.append(model->get(i));
+    }
+    return objects;
+}
+
+// Groups the items at the start of the model into folders of five, one folder for every ten items.
+// Each folder is created from the first item not in a folder yet and takes the four items after it.
+void createFolders(LauncherFolderModel *model)
+{
+    const int folderCount = model->itemCount() / 10;
+    for (int i = 0; i < folderCount; ++i) {
+        LauncherFolderItem *folder = model->createFolder(i, QString("Folder %1").arg(i));
+        folder->saveDirectoryFile();
+        for (int j = 0; j < 4 && i + 1 < model->itemCount(); ++j) {
+            model->moveToFolder(model->get(i + 1), folder);
+        }
+    }
+}
+
+}
+
+SignalCounter::SignalCounter(QObject *parent)
+    : QObject(parent)
+    , m_count(0)
+{
+}
+
+void SignalCounter::observe(QObject *object)
+{
+    const QMetaMethod slot = staticMetaObject.method(staticMetaObject.indexOfSlot("signalEmitted()"));
+    const QMetaObject *metaObject = object->metaObject();
+    for (int i = 0; i < metaObject->methodCount(); ++i) {
+        const QMetaMethod method = metaObject->method(i);
+        if (method.methodType() == QMetaMethod::Signal && method.name() != "destroyed") {
+            connect(object, method, this, slot);
+        }
+    }
+}
+
+int SignalCounter::count() const
+{
+    return m_count;
+}
+
+void SignalCounter::signalEmitted()
+{
+    ++m_count;
+}
+
+void Bench_Launcher::initTestCase()
+{
+    QVERIFY(m_root.isValid());
+
+    // Keep the launcher order, the folder configuration and the application directories out of the home directory
+    const QString root = m_root.path();
+    qputenv("XDG_CONFIG_HOME", QFile::encodeName(root + "/config"));
+    qputenv("XDG_DATA_HOME", QFile::encodeName(root + "/data"));
+    qputenv("XDG_DATA_DIRS", QFile::encodeName(root + "/system"));
+    LauncherFolderModel::setConfigDir(root + "/config/lipstick/");
+
+    m_applicationsDir = root + "/data/applications/";
+    m_iconsDir = root + "/icons/";
+}
+
+void Bench_Launcher::cleanup()
+{
+    const QString root = m_root.path();
+    QDir(root + "/config").removeRecursively();
+    QDir(m_applicationsDir).removeRecursively();
+    QDir(m_iconsDir).removeRecursively();
+}
+
+void Bench_Launcher::addRows()
+{
+    QTest::addColumn<int>("count");
+    QTest::addColumn<int>("metric");
+
+    foreach (int count, QList<int>() << 50 << 300 << 1000) {
+        QTest::newRow(qPrintable(QString("%1 apps, wall time").arg(count))) << count << int(WallTime);
+        QTest::newRow(qPrintable(QString("%1 apps, allocations").arg(count))) << count << int(Allocations);
+        QTest::newRow(qPrintable(QString("%1 apps, signals").arg(count))) << count << int(Signals);
+    }
+}
+
+void Bench_Launcher::measure(const std::function<void()> &operation, const QList<QObject *> &observed)
+{
+    QFETCH(int, metric);
+
+    SignalCounter counter;
+    if (metric == Signals) {
+        foreach (QObject *object, observed) {
+            counter.observe(object);
+        }
+    }
+
+    const quint64 allocations = allocationCount();
+    QElapsedTimer timer;
+    timer.start();
+    operation();
+    const qint64 elapsed = timer.nsecsElapsed();
+
+    switch (metric) {
+    case WallTime:
+        QTest::setBenchmarkResult(elapsed / 1000000.0, QTest::WalltimeMilliseconds);
+        break;
+    case Allocations:
+        QTest::setBenchmarkResult(allocationCount() - allocations, QTest::Events);
+        break;
+    case Signals:
+        QTest::setBenchmarkResult(counter.count(), QTest::Events);
+        break;
+    }
+}
+
+QStringList Bench_Launcher::writeDesktopFiles(int first, int count, const QString &variant)
+{
+    QDir().mkpath(m_applicationsDir);
+
+    QStringList paths;
+    for (int i = first; i < first + count; ++i) {
+        const QString name(applicationName(i));
+        const QString path(m_applicationsDir + name + ".desktop");
+        QFile file(path);
+        if (!file.open(QIODevice::WriteOnly)) {
+            qWarning() << "Cannot write" << path;
+            continue;
+        }
+
+        QTextStream stream(&file);
+        stream.setCodec("UTF-8");
+        stream << "[Desktop Entry]\n"
+               << "Type=Application\n"
+               << "Name=Application " << i << variant << "\n"
+               << "Name[de]=Anwendung " << i << variant << "\n"
+               << "Name[fi]=Sovellus " << i << variant << "\n"
+               << "Name[fr]=Application " << i << variant << "\n"
+               << QStringLiteral("Name[ru]=Приложение ") << i << variant << "\n"
+               << QStringLiteral("Name[zh_CN]=应用 ") << i << variant << "\n"
+               << "Comment=Synthetic application for benchmarking\n"
+               << "Icon=" << name << "\n"
+               << "Exec=/usr/bin/" << name << "\n"
+               << "Categories=Utility;Office;\n"
+               << "MimeType=text/plain;x-scheme-handler/" << name << ";\n"
+               << "X-Nemo-Application-Type=silica-qt5\n"
+               << "X-Maemo-Service=org.example." << name << "\n"
+               << "X-Maemo-Object-Path=/\n"
+               << "X-Maemo-Method=org.example." << name << ".activate\n"
+               << "\n"
+               << "[X-Sailjail]\n"
+               << "Permissions=Internet;Pictures;Documents\n"
+               << "OrganizationName=org.example\n"
+               << "ApplicationName=" << name << "\n";
+        paths.append(path);
+    }
+    return paths;
+}
+
+QStringList Bench_Launcher::writeIcons(int count)
+{
+    QDir().mkpath(m_iconsDir);
+
+    QImage image(86, 86, QImage::Format_ARGB32);
+    image.fill(Qt::darkCyan);
+
+    QStringList paths;
+    for (int i = 0; i < count; ++i) {
+        const QString path(m_iconsDir + applicationName(i) + ".png");
+        if (image.save(path)) {
+            paths.append(path);
+        }
+    }
+    return paths;
+}
+
+void Bench_Launcher::processChanges(LauncherModel *model, const QString &directory, const QStringList &modified)
+{
+    // Report what the file system watcher would, and flush without waiting for the holdback timer
+    LauncherMonitor *monitor = &model->m_launcherMonitor;
+    QMetaObject::invokeMethod(monitor, "onDirectoryChanged", Q_ARG(QString, directory));
+    foreach (const QString &path, modified) {
+        QMetaObject::invokeMethod(monitor, "onFileChanged", Q_ARG(QString, path));
+    }
+    monitor->start();
+}
+
+void Bench_Launcher::benchmarkColdScan_data()
+{
+    addRows();
+}
+
+void Bench_Launcher::benchmarkColdScan()
+{
+    QFETCH(int, count);
+
+    writeDesktopFiles(0, count);
+    writeIcons(count);
+    BenchLauncherModel model(m_applicationsDir, m_iconsDir);
+
+    measure([&model] { model.initialize(); }, QList<QObject *>() << &model);
+    QCOMPARE(model.itemCount(), count);
+}
+
+void Bench_Launcher::benchmarkAddStorm_data()
+{
+    addRows();
+}
+
+void Bench_Launcher::benchmarkAddStorm()
+{
+    QFETCH(int, count);
+
+    writeDesktopFiles(0, count);
+    BenchLauncherModel model(m_applicationsDir, m_iconsDir);
+    model.initialize();
+
+    writeDesktopFiles(count, StormSize);
+    measure([this, &model] { processChanges(&model, m_applicationsDir); }, modelAndItems(&model));
+    QCOMPARE(model.itemCount(), count + StormSize);
+}
+
+void Bench_Launcher::benchmarkRemoveStorm_data()
+{
+    addRows();
+}
+
+void Bench_Launcher::benchmarkRemoveStorm()
+{
+    QFETCH(int, count);
+
+    const QStringList paths(writeDesktopFiles(0, count));
+    BenchLauncherModel model(m_applicationsDir, m_iconsDir);
+    model.initialize();
+
+    for (int i = 0; i < StormSize; ++i) {
+        QFile::remove(paths.at(i));
+    }
+    measure([this, &model] { processChanges(&model, m_applicationsDir); }, modelAndItems(&model));
+    QCOMPARE(model.itemCount(), count - StormSize);
+}
+
+void Bench_Launcher::benchmarkModifyStorm_data()
+{
+    addRows();
+}
+
+void Bench_Launcher::benchmarkModifyStorm()
+{
+    QFETCH(int, count);
+
+    writeDesktopFiles(0, count);
+    BenchLauncherModel model(m_applicationsDir, m_iconsDir);
+    model.initialize();
+
+    const QStringList modified(writeDesktopFiles(0, StormSize, " (updated)"));
+    measure([this, &model, &modified] { processChanges(&model, m_applicationsDir, modified); }, modelAndItems(&model));
+    QCOMPARE(model.itemCount(), count);
+}
+
+void Bench_Launcher::benchmarkIconResolution_data()
+{
+    addRows();
+}
+
+void Bench_Launcher::benchmarkIconResolution()
+{
+    QFETCH(int, count);
+
+    writeDesktopFiles(0, count);
+    BenchLauncherModel model(m_applicationsDir, m_iconsDir);
+    model.initialize();
+
+    // Icons installed after the applications, as when the icon theme package is updated
+    writeIcons(count);
+    measure([this, &model] { processChanges(&model, m_iconsDir); }, modelAndItems(&model));
+    QVERIFY(!static_cast<LauncherItem *>(model.get(0))->iconFilename().isEmpty());
+}
+
+void Bench_Launcher::benchmarkFolderSave_data()
+{
+    addRows();
+}
+
+void Bench_Launcher::benchmarkFolderSave()
+{
+    QFETCH(int, count);
+
+    writeDesktopFiles(0, count);
+    BenchFolderModel model(m_applicationsDir, m_iconsDir);
+    createFolders(&model);
+
+    measure([&model] { model.save(); }, QList<QObject *>() << &model);
+    QVERIFY(QFile::exists(LauncherFolderModel::configFile()));
+}
+
+void Bench_Launcher::benchmarkFolderLoad_data()
+{
+    addRows();
+}
+
+void Bench_Launcher::benchmarkFolderLoad()
+{
+    QFETCH(int, count);
+
+    writeDesktopFiles(0, count);
+    BenchFolderModel model(m_applicationsDir, m_iconsDir);
+    createFolders(&model);
+    model.save();
+    const int itemCount = model.itemCount();
+
+    measure([&model] { model.load(); }, modelAndItems(&model));
+    QCOMPARE(model.itemCount(), itemCount);
+}
+
+QTEST_MAIN(Bench_Launcher)
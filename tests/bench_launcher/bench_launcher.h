@@ -0,0 +1,85 @@
+/***************************************************************************
+**
+** Copyright (c) 2021 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+#ifndef BENCH_LAUNCHER_H
+#define BENCH_LAUNCHER_H
+
+#include <QObject>
+#include <QStringList>
+#include <QTemporaryDir>
+#include <functional>
+
+class LauncherModel;
+
+// Counts the signals emitted by a set of objects
+class SignalCounter : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SignalCounter(QObject *parent = 0);
+
+    void observe(QObject *object);
+    int count() const;
+
+private slots:
+    void signalEmitted();
+
+private:
+    int m_count;
+};
+
+/*
+ * Benchmarks of the launcher models against synthetic desktop file trees
+ * created in a temporary directory. Every operation is measured for wall
+ * time, allocations and emitted signals, each reported as a row of its own.
+ *
+ * Use the QtTest output options to store the results for comparison, e.g.
+ *   bench_launcher -o results.xml,xml
+ */
+class Bench_Launcher : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanup();
+
+    void benchmarkColdScan_data();
+    void benchmarkColdScan();
+    void benchmarkAddStorm_data();
+    void benchmarkAddStorm();
+    void benchmarkRemoveStorm_data();
+    void benchmarkRemoveStorm();
+    void benchmarkModifyStorm_data();
+    void benchmarkModifyStorm();
+    void benchmarkIconResolution_data();
+    void benchmarkIconResolution();
+    void benchmarkFolderSave_data();
+    void benchmarkFolderSave();
+    void benchmarkFolderLoad_data();
+    void benchmarkFolderLoad();
+
+private:
+    void addRows();
+    void measure(const std::function<void()> &operation, const QList<QObject *> &observed);
+    QStringList writeDesktopFiles(int first, int count, const QString &variant = QString());
+    QStringList writeIcons(int count);
+    void processChanges(LauncherModel *model, const QString &directory, const QStringList &modified = QStringList());
+
+    QTemporaryDir m_root;
+    QString m_applicationsDir;
+    QString m_iconsDir;
+};
+
+#endif
@@ -0,0 +1,45 @@
+include(../common.pri)
+TARGET = bench_launcher
+
+INCLUDEPATH += $$COMPONENTSSRCDIR
+INCLUDEPATH += $$UTILITYSRCDIR
+INCLUDEPATH += $$3RDPARTYSRCDIR
+INCLUDEPATH += $$COMMONDIR
+
+QT += dbus qml
+PKGCONFIG += glib-2.0
+
+packagesExist(contentaction5) {
+    PKGCONFIG += contentaction5
+    DEFINES += HAVE_CONTENTACTION
+} else {
+    PKGCONFIG += \
+        gio-2.0
+}
+
+# benchmark and units
+SOURCES += \
+    bench_launcher.cpp \
+    $$COMMONDIR/allocationcounter.cpp \
+    $$COMPONENTSSRCDIR/launchermodel.cpp \
+    $$COMPONENTSSRCDIR/launchermonitor.cpp \
+    $$COMPONENTSSRCDIR/launcheritem.cpp \
+    $$COMPONENTSSRCDIR/launcherfoldermodel.cpp \
+    $$COMPONENTSSRCDIR/launcherdbus.cpp \
+    $$UTILITYSRCDIR/qobjectlistmodel.cpp \
+    $$SRCDIR/logging.cpp \
+    $$SRCDIR/tracing.cpp \
+
+# benchmark and units
+HEADERS += \
+    bench_launcher.h \
+    $$COMMONDIR/allocationcounter.h \
+    $$COMPONENTSSRCDIR/launchermodel.h \
+    $$COMPONENTSSRCDIR/launchermonitor.h \
+    $$COMPONENTSSRCDIR/launcheritem.h \
+    $$COMPONENTSSRCDIR/launcherfoldermodel.h \
+    $$COMPONENTSSRCDIR/launcherdbus.h \
+    $$UTILITYSRCDIR/qobjectlistmodel.h \
+    $$3RDPARTYSRCDIR/synchronizelists.h \
+    $$SRCDIR/logging.h \
+    $$SRCDIR/tracing.h \
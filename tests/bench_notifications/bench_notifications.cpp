@@ -0,0 +1,342 @@
+/***************************************************************************
+**
+** Copyright (c) 2021 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include "bench_notifications.h"
+#include "allocationcounter.h"
+#include "aboutsettings_stub.h"
+
+#include "notificationmanager.h"
+#include "notificationmanageradaptor_stub.h"
+#include "notificationlistmodel.h"
+#include "lipsticknotification.h"
+#include "categorydefinitionstore.h"
+#include "androidprioritystore_stub.h"
+
+// Defined in notificationmanager.cpp
+extern int MaxNotificationRestoreCount;
+
+namespace {
+
+// Number of category definition files installed for the run
+const int CategoryDefinitionCount = 200;
+
+// Number of category definitions the notification manager keeps in memory
+const uint MaxStoredCategoryDefinitions = 100;
+
+// Number of notifications added to an empty manager per measurement
+const int NotifyBatchSize = 1000;
+
+QString categoryName(int index)
+{
+    return QString("bench.category%1").arg(index);
+}
+
+QVariantHash notificationHints(int index, int count)
+{
+    // Spread the timestamps so that the notifications are not already in model order
+    const QDateTime timestamp(QDateTime(QDate(2021, 1, 1), QTime(0, 0), Qt::UTC).addSecs((index * 7919) % count));
+
+    QVariantHash hints;
+    hints.insert(LipstickNotification::HINT_CATEGORY, categoryName(index % CategoryDefinitionCount));
+    hints.insert(LipstickNotification::HINT_TIMESTAMP, timestamp.toString(Qt::ISODate));
+    hints.insert(LipstickNotification::HINT_PREVIEW_SUMMARY, QString("Preview summary %1").arg(index));
+    hints.insert(LipstickNotification::HINT_PREVIEW_BODY, QString("Preview body %1").arg(index));
+    return hints;
+}
+
+}
+
+void Bench_Notifications::initTestCase()
+{
+    QVERIFY(m_dataDir.isValid());
+    QVERIFY(m_categoryDir.isValid());
+
+    m_maxRestoreCount = MaxNotificationRestoreCount;
+
+    // The notification database is created in the generic data location
+    qputenv("XDG_DATA_HOME", QFile::encodeName(m_dataDir.path()));
+
+    for (int i = 0; i < CategoryDefinitionCount; ++i) {
+        QFile file(m_categoryDir.path() + "/" + categoryName(i) + ".conf");
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write("appName=Benchmark\n"
+                   "app_icon=icon-lock-information\n"
+                   "urgency=1\n"
+                   "priority=100\n"
+                   "x-nemo-feedback=chat\n"
+                   "x-nemo-display-on=true\n");
+    }
+}
+
+void Bench_Notifications::cleanup()
+{
+    MaxNotificationRestoreCount = m_maxRestoreCount;
+    destroyManager();
+    removeDatabase();
+}
+
+NotificationManager *Bench_Notifications::createManager()
+{
+    NotificationManager *manager = NotificationManager::instance();
+
+    // Read the category definitions installed by the benchmark instead of the system ones
+    delete manager->m_categoryDefinitionStore;
+    manager->m_categoryDefinitionStore = new CategoryDefinitionStore(m_categoryDir.path(), MaxStoredCategoryDefinitions, manager);
+
+    return manager;
+}
+
+void Bench_Notifications::destroyManager()
+{
+    delete NotificationManager::s_instance;
+    NotificationManager::s_instance = 0;
+}
+
+void Bench_Notifications::removeDatabase()
+{
+    NotificationManager::removeDatabaseFile(m_dataDir.path() + "/system/privileged/Notifications/notifications.db");
+}
+
+QList<uint> Bench_Notifications::populate(int count, int expireTimeout)
+{
+    NotificationManager *manager = NotificationManager::instance();
+
+    QList<uint> ids;
+    ids.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        ids.append(manager->Notify("bench", 0, QString(), QString("Summary %1").arg(i), QString("Body %1").arg(i),
+                                   QStringList(), notificationHints(i, count), expireTimeout));
+    }
+    manager->commit();
+
+    return ids;
+}
+
+void Bench_Notifications::benchmarkNotify()
+{
+    const QVariantHash hints(notificationHints(0, 1));
+
+    // Every measurement starts from an empty manager so that the later
+    // iterations do not measure a larger one. Includes the creation and
+    // destruction of the manager.
+    QBENCHMARK {
+        NotificationManager *manager = createManager();
+        for (int i = 0; i < NotifyBatchSize; ++i) {
+            manager->Notify("bench", 0, QString(), "Summary", "Body", QStringList(), hints, -1);
+        }
+        destroyManager();
+        removeDatabase();
+    }
+}
+
+void Bench_Notifications::benchmarkNotifyAllocations()
+{
+    const int iterations = 1000;
+    NotificationManager *manager = createManager();
+    const QVariantHash hints(notificationHints(0, 1));
+
+    // Load the category definition and prepare the database queries outside of the measurement
+    manager->Notify("bench", 0, QString(), "Summary", "Body", QStringList(), hints, -1);
+
+    const quint64 before = allocationCount();
+    for (int i = 0; i < iterations; ++i) {
+        manager->Notify("bench", 0, QString(), "Summary", "Body", QStringList(), hints, -1);
+    }
+    QTest::setBenchmarkResult(qreal(allocationCount() - before) / iterations, QTest::Events);
+}
+
+void Bench_Notifications::benchmarkHintProcessing()
+{
+    NotificationManager *manager = createManager();
+
+    // A notification using most of the hints a messaging application would send
+    QVariantHash hints(notificationHints(0, 1));
+    hints.insert(LipstickNotification::HINT_TIMESTAMP, "2021-01-01T12:00:00+02:00");
+    hints.insert(LipstickNotification::HINT_ITEM_COUNT, 5);
+    hints.insert(LipstickNotification::HINT_PRIORITY, 120);
+    hints.insert(LipstickNotification::HINT_URGENCY, 2);
+    hints.insert(LipstickNotification::HINT_USER_REMOVABLE, true);
+    hints.insert(LipstickNotification::HINT_ORIGIN_PACKAGE, "org.example.messaging");
+    QStringList actions;
+    for (int i = 0; i < 5; ++i) {
+        const QString name(QString("action%1").arg(i));
+        actions << name << QString("Action %1").arg(i);
+        hints.insert(QString(LipstickNotification::HINT_REMOTE_ACTION_PREFIX) + name,
+                     QString("org.example.messaging / org.example.messaging %1 \"%2\"").arg(name).arg(i));
+    }
+
+    uint id = manager->Notify("bench", 0, QString(), "Summary", "Body", actions, hints, -1);
+    QVERIFY(id != 0);
+
+    // Replace the same notification so that the number of notifications stays constant
+    QBENCHMARK {
+        manager->Notify("bench", id, QString(), "Summary", "Body", actions, hints, -1);
+    }
+}
+
+void Bench_Notifications::benchmarkCategoryLookup_data()
+{
+    QTest::addColumn<int>("categories");
+
+    QTest::newRow("cached") << 10;
+    QTest::newRow("evicting") << CategoryDefinitionCount;
+}
+
+void Bench_Notifications::benchmarkCategoryLookup()
+{
+    QFETCH(int, categories);
+
+    CategoryDefinitionStore store(m_categoryDir.path(), MaxStoredCategoryDefinitions);
+    QStringList names;
+    for (int i = 0; i < categories; ++i) {
+        names.append(categoryName(i));
+    }
+
+    QBENCHMARK {
+        foreach (const QString &name, names) {
+            store.categoryParameters(name);
+        }
+    }
+}
+
+void Bench_Notifications::benchmarkModelInsert_data()
+{
+    QTest::addColumn<int>("count");
+
+    QTest::newRow("100") << 100;
+    QTest::newRow("1000") << 1000;
+    QTest::newRow("5000") << 5000;
+}
+
+void Bench_Notifications::benchmarkModelInsert()
+{
+    QFETCH(int, count);
+
+    createManager();
+    const QList<uint> ids(populate(count));
+
+    // Notifications arriving one by one into an empty model, each inserted at its sorted position
+    QBENCHMARK {
+        NotificationListModel model;
+        model.updateNotifications(ids);
+    }
+}
+
+void Bench_Notifications::benchmarkModelSort_data()
+{
+    QTest::addColumn<int>("count");
+
+    QTest::newRow("1000") << 1000;
+    QTest::newRow("10000") << 10000;
+    QTest::newRow("50000") << 50000;
+}
+
+void Bench_Notifications::benchmarkModelSort()
+{
+    QFETCH(int, count);
+
+    createManager();
+    populate(count);
+
+    // Initial population of the model, which sorts all the notifications at once
+    QBENCHMARK {
+        NotificationListModel model;
+        model.init();
+    }
+}
+
+void Bench_Notifications::benchmarkRestore_data()
+{
+    QTest::addColumn<int>("count");
+
+    QTest::newRow("1000") << 1000;
+    QTest::newRow("10000") << 10000;
+    QTest::newRow("50000") << 50000;
+}
+
+void Bench_Notifications::benchmarkRestore()
+{
+    QFETCH(int, count);
+
+    // Restore everything instead of culling the oldest notifications
+    MaxNotificationRestoreCount = count;
+
+    createManager();
+    populate(count);
+    destroyManager();
+
+    // Includes the destruction of the manager, which is small compared to reading the database
+    QBENCHMARK {
+        NotificationManager *manager = createManager();
+        QCOMPARE(manager->notificationIds().count(), count);
+        destroyManager();
+    }
+}
+
+void Bench_Notifications::benchmarkRestoredHeap_data()
+{
+    QTest::addColumn<int>("count");
+
+    QTest::newRow("1000") << 1000;
+    QTest::newRow("10000") << 10000;
+}
+
+void Bench_Notifications::benchmarkRestoredHeap()
+{
+    QFETCH(int, count);
+
+    // Restore everything instead of culling the oldest notifications
+    MaxNotificationRestoreCount = count;
+
+    createManager();
+    populate(count);
+    destroyManager();
+
+    // Heap held by the restored notifications, plus the constant cost of the manager and its database connection
+    const quint64 before = heapUsage();
+    NotificationManager *manager = createManager();
+    QCOMPARE(manager->notificationIds().count(), count);
+    QTest::setBenchmarkResult(heapUsage() - before, QTest::BytesAllocated);
+}
+
+void Bench_Notifications::benchmarkExpiration_data()
+{
+    QTest::addColumn<int>("count");
+
+    QTest::newRow("1000") << 1000;
+    QTest::newRow("10000") << 10000;
+    QTest::newRow("50000") << 50000;
+}
+
+void Bench_Notifications::benchmarkExpiration()
+{
+    QFETCH(int, count);
+
+    NotificationManager *manager = createManager();
+    foreach (uint id, populate(count, 1)) {
+        manager->markNotificationDisplayed(id);
+    }
+
+    // Expire everything in one go instead of from the timer
+    manager->m_expirationTimer.stop();
+    QTest::qSleep(10);
+
+    QBENCHMARK_ONCE {
+        manager->expire();
+    }
+    QCOMPARE(manager->notificationIds().count(), 0);
+}
+
+QTEST_MAIN(Bench_Notifications)
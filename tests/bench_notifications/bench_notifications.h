@@ -0,0 +1,65 @@
+/***************************************************************************
+**
+** Copyright (c) 2021 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+#ifndef BENCH_NOTIFICATIONS_H
+#define BENCH_NOTIFICATIONS_H
+
+#include <QObject>
+#include <QTemporaryDir>
+
+class NotificationManager;
+
+/*
+ * Benchmarks of the notification pipeline. The notification database is
+ * kept in a temporary directory for the duration of the run.
+ *
+ * Use the QtTest output options to store the results for comparison, e.g.
+ *   bench_notifications -o results.xml,xml
+ *   bench_notifications -csv -o results.csv
+ */
+class Bench_Notifications : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanup();
+
+    void benchmarkNotify();
+    void benchmarkNotifyAllocations();
+    void benchmarkHintProcessing();
+    void benchmarkCategoryLookup_data();
+    void benchmarkCategoryLookup();
+    void benchmarkModelInsert_data();
+    void benchmarkModelInsert();
+    void benchmarkModelSort_data();
+    void benchmarkModelSort();
+    void benchmarkRestore_data();
+    void benchmarkRestore();
+    void benchmarkRestoredHeap_data();
+    void benchmarkRestoredHeap();
+    void benchmarkExpiration_data();
+    void benchmarkExpiration();
+
+private:
+    NotificationManager *createManager();
+    void destroyManager();
+    void removeDatabase();
+    QList<uint> populate(int count, int expireTimeout = -1);
+
+    int m_maxRestoreCount;
+    QTemporaryDir m_dataDir;
+    QTemporaryDir m_categoryDir;
+};
+
+#endif
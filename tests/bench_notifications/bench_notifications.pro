@@ -0,0 +1,40 @@
+include(../common.pri)
+TARGET = bench_notifications
+INCLUDEPATH += $$NOTIFICATIONSRCDIR
+INCLUDEPATH += $$UTILITYSRCDIR
+INCLUDEPATH += $$3RDPARTYSRCDIR
+INCLUDEPATH += $$COMMONDIR
+CONFIG += link_pkgconfig
+QT += sql dbus qml
+PKGCONFIG += mlite5
+
+# benchmark and units
+SOURCES += \
+    bench_notifications.cpp \
+    $$COMMONDIR/allocationcounter.cpp \
+    $$NOTIFICATIONSRCDIR/notificationmanager.cpp \
+    $$NOTIFICATIONSRCDIR/notificationlistmodel.cpp \
+    $$NOTIFICATIONSRCDIR/lipsticknotification.cpp \
+    $$NOTIFICATIONSRCDIR/categorydefinitionstore.cpp \
+    $$UTILITYSRCDIR/qobjectlistmodel.cpp \
+    $$UTILITYSRCDIR/callercredentials.cpp \
+    $$SRCDIR/logging.cpp \
+    $$SRCDIR/tracing.cpp \
+    $$STUBSDIR/stubbase.cpp \
+
+# benchmark and units
+HEADERS += \
+    bench_notifications.h \
+    $$COMMONDIR/allocationcounter.h \
+    $$NOTIFICATIONSRCDIR/notificationmanager.h \
+    $$NOTIFICATIONSRCDIR/notificationlistmodel.h \
+    $$NOTIFICATIONSRCDIR/lipsticknotification.h \
+    $$NOTIFICATIONSRCDIR/categorydefinitionstore.h \
+    $$UTILITYSRCDIR/qobjectlistmodel.h \
+    $$UTILITYSRCDIR/callercredentials.h \
+    $$NOTIFICATIONSRCDIR/notificationmanageradaptor.h \
+    $$NOTIFICATIONSRCDIR/androidprioritystore.h \
+    $$3RDPARTYSRCDIR/synchronizelists.h \
+    /usr/include/systemsettings/aboutsettings.h
+
+QMAKE_CXXFLAGS += `pkg-config --cflags-only-I systemsettings`
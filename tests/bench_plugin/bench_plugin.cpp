@@ -0,0 +1,101 @@
+/***************************************************************************
+**
+** Copyright (c) 2021 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QQmlComponent>
+#include <QQmlEngine>
+#include "bench_plugin.h"
+#include "allocationcounter.h"
+
+namespace {
+
+enum Metric {
+    WallTime,
+    Allocations,
+    HeapUsage
+};
+
+const char *const ImportOnly =
+        "import QtQuick 2.0\n"
+        "import org.nemomobile.lipstick 0.1\n"
+        "QtObject {}\n";
+
+const char *const LipstickSingleton =
+        "import QtQuick 2.0\n"
+        "import org.nemomobile.lipstick 0.1\n"
+        "QtObject { property string name: Lipstick.notificationSystemApplicationName }\n";
+
+// Returns false if the source fails to load. The heap used by the engine
+// and the created object is stored in \a heap if given.
+bool load(const char *source, quint64 *heap = 0)
+{
+    const quint64 before = heapUsage();
+    QQmlEngine engine;
+    QQmlComponent component(&engine);
+    component.setData(source, QUrl());
+    QObject *object = component.create();
+    if (!object) {
+        qWarning("%s", qPrintable(component.errorString()));
+        return false;
+    }
+    if (heap) {
+        *heap = heapUsage() - before;
+    }
+    delete object;
+    return true;
+}
+}
+
+void Bench_Plugin::benchmarkFirstImport()
+{
+    // Must run first, the plugin library stays loaded for the rest of the process
+    QBENCHMARK_ONCE {
+        QVERIFY(load(ImportOnly));
+    }
+}
+
+void Bench_Plugin::benchmarkImport_data()
+{
+    QTest::addColumn<QByteArray>("source");
+    QTest::addColumn<int>("metric");
+
+    QTest::newRow("import only, wall time") << QByteArray(ImportOnly) << int(WallTime);
+    QTest::newRow("import only, allocations") << QByteArray(ImportOnly) << int(Allocations);
+    QTest::newRow("Lipstick singleton, wall time") << QByteArray(LipstickSingleton) << int(WallTime);
+    QTest::newRow("import only, heap usage") << QByteArray(ImportOnly) << int(HeapUsage);
+    QTest::newRow("Lipstick singleton, allocations") << QByteArray(LipstickSingleton) << int(Allocations);
+    QTest::newRow("Lipstick singleton, heap usage") << QByteArray(LipstickSingleton) << int(HeapUsage);
+}
+
+void Bench_Plugin::benchmarkImport()
+{
+    QFETCH(QByteArray, source);
+    QFETCH(int, metric);
+
+    if (metric == WallTime) {
+        QBENCHMARK {
+            QVERIFY(load(source.constData()));
+        }
+    } else if (metric == Allocations) {
+        const quint64 allocations = allocationCount();
+        QVERIFY(load(source.constData()));
+        QTest::setBenchmarkResult(allocationCount() - allocations, QTest::Events);
+    } else {
+        quint64 heap = 0;
+        QVERIFY(load(source.constData(), &heap));
+        QTest::setBenchmarkResult(heap, QTest::BytesAllocated);
+    }
+}
+
+QTEST_MAIN(Bench_Plugin)
@@ -0,0 +1,41 @@
+/***************************************************************************
+**
+** Copyright (c) 2021 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+#ifndef BENCH_PLUGIN_H
+#define BENCH_PLUGIN_H
+
+#include <QObject>
+
+/*
+ * Benchmarks of a minimal QML consumer of the installed
+ * org.nemomobile.lipstick plugin, such as a settings page running outside
+ * of the home screen. The first import loads the plugin library and
+ * registers the types once per process; later imports only pay for the
+ * engine side. Each import is measured as wall time, as the number of
+ * heap allocations made while loading and as the heap in use once the
+ * component has been created.
+ *
+ * Use the QtTest output options to store the results for comparison, e.g.
+ *   bench_plugin -o results.xml,xml
+ */
+class Bench_Plugin : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void benchmarkFirstImport();
+    void benchmarkImport_data();
+    void benchmarkImport();
+};
+
+#endif
@@ -0,0 +1,15 @@
+include(../common.pri)
+TARGET = bench_plugin
+
+INCLUDEPATH += $$COMMONDIR
+
+QT += qml
+
+# The installed plugin is imported, nothing is built from the sources
+SOURCES += \
+    bench_plugin.cpp \
+    $$COMMONDIR/allocationcounter.cpp \
+
+HEADERS += \
+    bench_plugin.h \
+    $$COMMONDIR/allocationcounter.h \
@@ -0,0 +1,64 @@
+/***************************************************************************
+**
+** Copyright (c) 2021 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#include <atomic>
+#include <cstdlib>
+#include <malloc.h>
+#include <new>
+#include "allocationcounter.h"
+
+namespace {
+
+std::atomic<quint64> allocations(0);
+
+}
+
+quint64 allocationCount()
+{
+    return allocations;
+}
+
+quint64 heapUsage()
+{
+#if __GLIBC_PREREQ(2, 33)
+    return mallinfo2().uordblks;
+#else
+    return quint64(unsigned(mallinfo().uordblks));
+#endif
+}
+
+// The replacements must be visible to the shared libraries for their allocations to be counted
+__attribute__((visibility("default"))) void *operator new(std::size_t size)
+{
+    ++allocations;
+    if (void *p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+__attribute__((visibility("default"))) void *operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+__attribute__((visibility("default"))) void operator delete(void *p) noexcept
+{
+    std::free(p);
+}
+
+__attribute__((visibility("default"))) void operator delete[](void *p) noexcept
+{
+    std::free(p);
+}
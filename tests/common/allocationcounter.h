@@ -0,0 +1,31 @@
+/***************************************************************************
+**
+** Copyright (c) 2021 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+#ifndef ALLOCATIONCOUNTER_H
+#define ALLOCATIONCOUNTER_H
+
+#include <QtGlobal>
+
+/*
+ * Linking allocationcounter.cpp into a benchmark replaces the global
+ * operator new so that the allocations of the whole process, including
+ * the Qt libraries, are counted.
+ */
+
+//! Returns the number of allocations made with operator new so far
+quint64 allocationCount();
+
+//! Returns the number of bytes currently in use on the heap, as reported by malloc
+quint64 heapUsage();
+
+#endif
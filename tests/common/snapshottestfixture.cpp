@@ -0,0 +1,118 @@
+/***************************************************************************
+**
+** Copyright (c) 2021 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#include <QColor>
+#include <QOffscreenSurface>
+#include <QOpenGLContext>
+#include <QOpenGLFramebufferObject>
+#include <QOpenGLFunctions>
+#include <QQuickRenderControl>
+#include <QQuickWindow>
+#include "snapshottestfixture.h"
+
+SnapshotTestFixture::SnapshotTestFixture()
+    : m_surface(0)
+    , m_context(0)
+    , m_renderControl(0)
+    , m_window(0)
+    , m_renderTarget(0)
+    , m_initialized(false)
+{
+}
+
+SnapshotTestFixture::~SnapshotTestFixture()
+{
+    delete m_window;
+    delete m_renderControl;
+    delete m_renderTarget;
+    if (m_context)
+        m_context->doneCurrent();
+    delete m_context;
+    delete m_surface;
+}
+
+bool SnapshotTestFixture::create()
+{
+    m_surface = new QOffscreenSurface;
+    m_surface->create();
+    m_context = new QOpenGLContext;
+    if (!m_context->create() || !m_context->makeCurrent(m_surface))
+        return false;
+
+    m_renderControl = new QQuickRenderControl;
+    m_window = new QQuickWindow(m_renderControl);
+    m_window->resize(SnapshotSize);
+    m_renderControl->initialize(m_context);
+    m_initialized = true;
+
+    m_renderTarget = new QOpenGLFramebufferObject(SnapshotSize, QOpenGLFramebufferObject::CombinedDepthStencil);
+    m_window->setRenderTarget(m_renderTarget);
+    return true;
+}
+
+void SnapshotTestFixture::render()
+{
+    if (!m_initialized) {
+        m_renderControl->initialize(m_context);
+        m_window->setRenderTarget(m_renderTarget);
+        m_initialized = true;
+    }
+
+    m_renderControl->polishItems();
+    m_renderControl->sync();
+    m_renderControl->render();
+    m_context->functions()->glFinish();
+}
+
+void SnapshotTestFixture::invalidate()
+{
+    m_renderControl->invalidate();
+    m_initialized = false;
+}
+
+QOpenGLFramebufferObject *SnapshotTestFixture::createFramebuffer(const QColor &color) const
+{
+    QOpenGLFramebufferObject *fbo = new QOpenGLFramebufferObject(SnapshotSize);
+    fbo->bind();
+    QOpenGLFunctions *functions = m_context->functions();
+    functions->glClearColor(color.redF(), color.greenF(), color.blueF(), color.alphaF());
+    functions->glClear(GL_COLOR_BUFFER_BIT);
+    fbo->release();
+    return fbo;
+}
+
+void SnapshotTestFixture::addBenchmarkRows(const QString &items, const QStringList &metrics, const QStringList &variants)
+{
+    QTest::addColumn<int>("count");
+    QTest::addColumn<int>("variant");
+    QTest::addColumn<int>("metric");
+
+    foreach (int count, QList<int>() << 1 << 5 << 10) {
+        for (int variant = 0; variant < qMax(1, variants.count()); ++variant) {
+            for (int metric = 0; metric < metrics.count(); ++metric) {
+                QStringList name = QStringList() << QString("%1 %2").arg(count).arg(items);
+                if (!variants.isEmpty())
+                    name << variants.at(variant);
+                name << metrics.at(metric);
+                QTest::newRow(qPrintable(name.join(QStringLiteral(", ")))) << count << variant << metric;
+            }
+        }
+    }
+}
+
+void SnapshotTestFixture::setBenchmarkResult(int metric, const QVector<BenchmarkResult> &results)
+{
+    const BenchmarkResult &result = results.at(metric);
+    QTest::setBenchmarkResult(result.first, result.second);
+}
@@ -0,0 +1,76 @@
+/***************************************************************************
+**
+** Copyright (c) 2021 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+#ifndef SNAPSHOTTESTFIXTURE_H
+#define SNAPSHOTTESTFIXTURE_H
+
+#include <QPair>
+#include <QSize>
+#include <QStringList>
+#include <QTest>
+#include <QVector>
+
+class QColor;
+class QOffscreenSurface;
+class QOpenGLContext;
+class QOpenGLFramebufferObject;
+class QQuickRenderControl;
+class QQuickWindow;
+
+// The size of a full screen cover on a typical phone
+const QSize SnapshotSize(540, 960);
+
+/*
+ * An offscreen scene graph for the tests of window snapshots, which need
+ * an OpenGL context but no display. The window renders into a framebuffer
+ * object of SnapshotSize through a QQuickRenderControl.
+ */
+class SnapshotTestFixture
+{
+public:
+    typedef QPair<qreal, QTest::QBenchmarkMetric> BenchmarkResult;
+
+    SnapshotTestFixture();
+    ~SnapshotTestFixture();
+
+    //! Creates the context and the window, returns false if OpenGL is not available
+    bool create();
+
+    QOpenGLContext *context() const { return m_context; }
+    QQuickRenderControl *renderControl() const { return m_renderControl; }
+    QQuickWindow *window() const { return m_window; }
+
+    //! Returns a new framebuffer object of SnapshotSize cleared to \a color
+    QOpenGLFramebufferObject *createFramebuffer(const QColor &color) const;
+
+    //! Renders a frame of the window and waits for it to finish, rebuilding the scene graph if needed
+    void render();
+    //! Tears down the scene graph like hiding a window with a non-persistent scene graph does
+    void invalidate();
+
+    //! Adds the count, variant and metric columns, and rows for 1, 5 and 10 \a items in each variant and metric
+    static void addBenchmarkRows(const QString &items, const QStringList &metrics,
+                                 const QStringList &variants = QStringList());
+    //! Reports the result of \a metric, \a results holds one for each metric given to addBenchmarkRows()
+    static void setBenchmarkResult(int metric, const QVector<BenchmarkResult> &results);
+
+private:
+    QOffscreenSurface *m_surface;
+    QOpenGLContext *m_context;
+    QQuickRenderControl *m_renderControl;
+    QQuickWindow *m_window;
+    QOpenGLFramebufferObject *m_renderTarget;
+    bool m_initialized;
+};
+
+#endif
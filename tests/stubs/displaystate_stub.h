@@ -34,6 +34,7 @@ public:
     virtual void DisplayStateMonitorConstructor(QObject *parent);
     virtual void DisplayStateMonitorDestructor();
     virtual DeviceState::DisplayStateMonitor::DisplayState get() const;
+    virtual DeviceState::DisplayStateMonitor::DisplayState lastKnown() const;
     virtual bool set(DeviceState::DisplayStateMonitor::DisplayState state);
     virtual void connectNotify(const QMetaMethod &signal);
     virtual void disconnectNotify(const QMetaMethod &signal);
@@ -57,6 +58,16 @@ DeviceState::DisplayStateMonitor::DisplayState DisplayStateMonitorStub::get() co
     return stubReturnValue<DeviceState::DisplayStateMonitor::DisplayState>("get");
 }
 
+DeviceState::DisplayStateMonitor::DisplayState DisplayStateMonitorStub::lastKnown() const
+{
+    stubMethodEntered("lastKnown");
+    if (!stubReturnValue("lastKnown")) {
+        // Nothing is known about the display unless a test says otherwise
+        return DeviceState::DisplayStateMonitor::Unknown;
+    }
+    return stubReturnValue<DeviceState::DisplayStateMonitor::DisplayState>("lastKnown");
+}
+
 bool DisplayStateMonitorStub::set(DeviceState::DisplayStateMonitor::DisplayState state)
 {
     QList<ParameterBase *> params;
@@ -108,6 +119,11 @@ DeviceState::DisplayStateMonitor::DisplayState DisplayStateMonitor::get() const
     return gDisplayStateMonitorStub->get();
 }
 
+DeviceState::DisplayStateMonitor::DisplayState DisplayStateMonitor::lastKnown() const
+{
+    return gDisplayStateMonitorStub->lastKnown();
+}
+
 bool DisplayStateMonitor::set(DisplayState state)
 {
     return gDisplayStateMonitorStub->set(state);
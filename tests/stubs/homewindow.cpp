@@ -24,10 +24,12 @@ public:
     HomeWindowPrivate();
     QString category;
     bool isVisible;
+    bool closeEventsIgnored;
 };
 
 HomeWindowPrivate::HomeWindowPrivate()
     : isVisible(false)
+    , closeEventsIgnored(false)
 {
 }
 
@@ -102,6 +104,16 @@ void HomeWindow::setCategory(const QString &category)
     d->category = category;
 }
 
+bool HomeWindow::closeEventsIgnored() const
+{
+    return d->closeEventsIgnored;
+}
+
+void HomeWindow::setCloseEventsIgnored(bool ignored)
+{
+    d->closeEventsIgnored = ignored;
+}
+
 void HomeWindow::resize(const QSize &s)
 {
     d->resize(s);
@@ -41,6 +41,8 @@ public:
     virtual void setFullscreenSurface(QWaylandSurface *surface);
     virtual void setTopmostWindowId(int id);
     virtual void setTopmostWindowOrientation(Qt::ScreenOrientation topmostWindowOrientation);
+    virtual Qt::ScreenOrientations topmostWindowAllowedOrientations() const;
+    virtual void setTopmostWindowAllowedOrientations(Qt::ScreenOrientations orientations);
     virtual void setScreenOrientation(Qt::ScreenOrientation screenOrientation);
     virtual bool displayDimmed() const;
     virtual LipstickKeymap *keymap() const;
@@ -52,8 +54,11 @@ public:
     virtual void closeClientForWindowId(int);
     virtual void clearKeyboardFocus();
     virtual void setDisplayOff();
+    virtual QVariantMap snapshotStatistics() const;
+    virtual QVariantMap frameStatistics();
     virtual LipstickCompositorProcWindow *mapProcWindow(const QString &title, const QString &category, const QRect &);
     virtual QWaylandSurface *surfaceForId(int) const;
+    virtual uint notificationPreviewsDisabled(int windowId, uint defaultValue) const;
     virtual void surfaceMapped();
     virtual void surfaceUnmapped();
     virtual void surfaceSizeChanged();
@@ -180,6 +185,19 @@ void LipstickCompositorStub::setTopmostWindowOrientation(Qt::ScreenOrientation t
     stubMethodEntered("setTopmostWindowOrientation", params);
 }
 
+Qt::ScreenOrientations LipstickCompositorStub::topmostWindowAllowedOrientations() const
+{
+    stubMethodEntered("topmostWindowAllowedOrientations");
+    return stubReturnValue<Qt::ScreenOrientations>("topmostWindowAllowedOrientations");
+}
+
+void LipstickCompositorStub::setTopmostWindowAllowedOrientations(Qt::ScreenOrientations orientations)
+{
+    QList<ParameterBase *> params;
+    params.append(new Parameter<Qt::ScreenOrientations >(orientations));
+    stubMethodEntered("setTopmostWindowAllowedOrientations", params);
+}
+
 void LipstickCompositorStub::setScreenOrientation(Qt::ScreenOrientation screenOrientation)
 {
     QList<ParameterBase *> params;
@@ -248,6 +266,18 @@ void LipstickCompositorStub::setDisplayOff()
     stubMethodEntered("setDisplayOff");
 }
 
+QVariantMap LipstickCompositorStub::snapshotStatistics() const
+{
+    stubMethodEntered("snapshotStatistics");
+    return stubReturnValue<QVariantMap>("snapshotStatistics");
+}
+
+QVariantMap LipstickCompositorStub::frameStatistics()
+{
+    stubMethodEntered("frameStatistics");
+    return stubReturnValue<QVariantMap>("frameStatistics");
+}
+
 LipstickCompositorProcWindow *LipstickCompositorStub::mapProcWindow(const QString &title, const QString &category, const QRect &rect)
 {
     QList<ParameterBase *> params;
@@ -266,6 +296,15 @@ QWaylandSurface *LipstickCompositorStub::surfaceForId(int id) const
     return stubReturnValue<QWaylandSurface *>("surfaceForId");
 }
 
+uint LipstickCompositorStub::notificationPreviewsDisabled(int windowId, uint defaultValue) const
+{
+    QList<ParameterBase *> params;
+    params.append(new Parameter<int >(windowId));
+    params.append(new Parameter<uint >(defaultValue));
+    stubMethodEntered("notificationPreviewsDisabled", params);
+    return stubReturnValue("notificationPreviewsDisabled") ? stubReturnValue<uint>("notificationPreviewsDisabled") : defaultValue;
+}
+
 void LipstickCompositorStub::surfaceMapped()
 {
     stubMethodEntered("surfaceMapped");
@@ -478,6 +517,16 @@ void LipstickCompositor::setTopmostWindowOrientation(Qt::ScreenOrientation topmo
     gLipstickCompositorStub->setTopmostWindowOrientation(topmostWindowOrientation);
 }
 
+Qt::ScreenOrientations LipstickCompositor::topmostWindowAllowedOrientations() const
+{
+    return gLipstickCompositorStub->topmostWindowAllowedOrientations();
+}
+
+void LipstickCompositor::setTopmostWindowAllowedOrientations(Qt::ScreenOrientations orientations)
+{
+    gLipstickCompositorStub->setTopmostWindowAllowedOrientations(orientations);
+}
+
 void LipstickCompositor::setScreenOrientation(Qt::ScreenOrientation screenOrientation)
 {
     gLipstickCompositorStub->setScreenOrientation(screenOrientation);
@@ -498,6 +547,10 @@ void LipstickCompositor::setKeymap(LipstickKeymap *keymap)
     gLipstickCompositorStub->setKeymap(keymap);
 }
 
+void LipstickCompositor::scheduleKeymapUpdate()
+{
+}
+
 void LipstickCompositor::updateKeymap()
 {
     gLipstickCompositorStub->updateKeymap();
@@ -533,6 +586,16 @@ void LipstickCompositor::setDisplayOff()
     gLipstickCompositorStub->setDisplayOff();
 }
 
+QVariantMap LipstickCompositor::snapshotStatistics() const
+{
+    return gLipstickCompositorStub->snapshotStatistics();
+}
+
+QVariantMap LipstickCompositor::frameStatistics()
+{
+    return gLipstickCompositorStub->frameStatistics();
+}
+
 LipstickCompositorProcWindow *LipstickCompositor::mapProcWindow(const QString &title, const QString &category, const QRect &rect)
 {
     return gLipstickCompositorStub->mapProcWindow(title, category, rect);
@@ -543,6 +606,11 @@ QWaylandSurface *LipstickCompositor::surfaceForId(int id) const
     return gLipstickCompositorStub->surfaceForId(id);
 }
 
+uint LipstickCompositor::notificationPreviewsDisabled(int windowId, uint defaultValue) const
+{
+    return gLipstickCompositorStub->notificationPreviewsDisabled(windowId, defaultValue);
+}
+
 void LipstickCompositor::surfaceMapped()
 {
     gLipstickCompositorStub->surfaceMapped();
@@ -656,4 +724,8 @@ void LipstickCompositor::processQueuedSetUpdatesEnabledCalls()
 {
 }
 
+void LipstickCompositor::updateLowPowerMode()
+{
+}
+
 #endif
@@ -16,6 +16,7 @@
 #define NOTIFICATIONMANAGER_STUB
 
 #include "notificationmanager.h"
+#include "systemnotification.h"
 #include <stubbase.h>
 
 // 1. DECLARE STUB
@@ -30,6 +31,7 @@ public:
     virtual QStringList GetCapabilities();
     virtual uint Notify(const QString &appName, uint replacesId, const QString &appIcon, const QString &summary, const QString &body, const QStringList &actions, const QVariantHash &hints, int expireTimeout);
     virtual void CloseNotification(uint id, NotificationManager::NotificationClosedReason closeReason);
+    virtual uint publishSystemNotification(const SystemNotification &notification, uint replacesId);
     virtual void markNotificationDisplayed(uint id);
     virtual QString GetServerInformation(QString &name, QString &vendor, QString &version);
     virtual NotificationList GetNotifications(const QString &appName);
@@ -102,6 +104,15 @@ void NotificationManagerStub::CloseNotification(uint id, NotificationManager::No
     stubMethodEntered("CloseNotification", params);
 }
 
+uint NotificationManagerStub::publishSystemNotification(const SystemNotification &notification, uint replacesId)
+{
+    QList<ParameterBase *> params;
+    params.append( new Parameter<SystemNotification >(notification));
+    params.append( new Parameter<uint >(replacesId));
+    stubMethodEntered("publishSystemNotification", params);
+    return stubReturnValue<uint>("publishSystemNotification");
+}
+
 void NotificationManagerStub::markNotificationDisplayed(uint id)
 {
     QList<ParameterBase *> params;
@@ -249,6 +260,11 @@ void NotificationManager::CloseNotification(uint id, NotificationClosedReason cl
     gNotificationManagerStub->CloseNotification(id, closeReason);
 }
 
+uint NotificationManager::publishSystemNotification(const SystemNotification &notification, uint replacesId)
+{
+    return gNotificationManagerStub->publishSystemNotification(notification, replacesId);
+}
+
 void NotificationManager::markNotificationDisplayed(uint id)
 {
     gNotificationManagerStub->markNotificationDisplayed(id);
@@ -319,7 +335,7 @@ NotificationManager::~NotificationManager()
     gNotificationManagerStub->NotificationManagerDestructor();
 }
 
-QString NotificationManager::systemApplicationName() const
+QString NotificationManager::systemApplicationName()
 {
     return QString();
 }
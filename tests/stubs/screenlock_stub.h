@@ -50,6 +50,9 @@ public:
     virtual bool isLowPowerMode() const;
     virtual QString blankingPolicy() const;
     virtual bool touchBlocked() const;
+    virtual void setLockScreenWindow(QQuickWindow *window);
+    virtual void handleLockScreenFrameSwapped();
+    virtual void sendPendingReplies();
 };
 
 // 2. IMPLEMENT STUB
@@ -219,6 +222,23 @@ bool ScreenLockStub::touchBlocked() const
     return stubReturnValue<bool>("touchBlocked");
 }
 
+void ScreenLockStub::setLockScreenWindow(QQuickWindow *window)
+{
+    QList<ParameterBase *> params;
+    params.append(new Parameter<QQuickWindow *>(window));
+    stubMethodEntered("setLockScreenWindow", params);
+}
+
+void ScreenLockStub::handleLockScreenFrameSwapped()
+{
+    stubMethodEntered("handleLockScreenFrameSwapped");
+}
+
+void ScreenLockStub::sendPendingReplies()
+{
+    stubMethodEntered("sendPendingReplies");
+}
+
 // 3. CREATE A STUB INSTANCE
 ScreenLockStub gDefaultScreenLockStub;
 ScreenLockStub *gScreenLockStub = &gDefaultScreenLockStub;
@@ -340,4 +360,19 @@ bool ScreenLock::touchBlocked() const
 {
     return gScreenLockStub->touchBlocked();
 }
+
+void ScreenLock::setLockScreenWindow(QQuickWindow *window)
+{
+    gScreenLockStub->setLockScreenWindow(window);
+}
+
+void ScreenLock::handleLockScreenFrameSwapped()
+{
+    gScreenLockStub->handleLockScreenFrameSwapped();
+}
+
+void ScreenLock::sendPendingReplies()
+{
+    gScreenLockStub->sendPendingReplies();
+}
 #endif
@@ -27,8 +27,6 @@ public:
     virtual void ThermalConstructor(QObject *parent);
     virtual void ThermalDestructor();
     virtual DeviceState::Thermal::ThermalState get() const;
-    virtual void connectNotify(const QMetaMethod &signal);
-    virtual void disconnectNotify(const QMetaMethod &signal);
 };
 
 // 2. IMPLEMENT STUB
@@ -46,18 +44,6 @@ DeviceState::Thermal::ThermalState ThermalStub::get() const
     stubMethodEntered("get");
     return stubReturnValue<DeviceState::Thermal::ThermalState>("get");
 }
-void ThermalStub::connectNotify(const QMetaMethod &signal)
-{
-    QList<ParameterBase *> params;
-    params.append( new Parameter<const QMetaMethod &>(signal));
-    stubMethodEntered("connectNotify", params);
-}
-void ThermalStub::disconnectNotify(const QMetaMethod &signal)
-{
-    QList<ParameterBase *> params;
-    params.append( new Parameter<const QMetaMethod &>(signal));
-    stubMethodEntered("disconnectNotify", params);
-}
 
 
 
@@ -83,16 +69,6 @@ DeviceState::Thermal::ThermalState Thermal::get() const
     return gThermalStub->get();
 }
 
-void Thermal::connectNotify(const QMetaMethod &signal)
-{
-    gThermalStub->connectNotify(signal);
-}
-
-void Thermal::disconnectNotify(const QMetaMethod &signal)
-{
-    gThermalStub->disconnectNotify(signal);
-}
-
 }
 
 #endif
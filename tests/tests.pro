@@ -1,6 +1,14 @@
 TEMPLATE = subdirs
 SUBDIRS = \
+          bench_homewindow \
+          bench_keygrab \
+          bench_launcher \
+          bench_notifications \
+          bench_plugin \
+          ut_callercredentials \
           ut_closeeventeater \
+          ut_framestatistics \
+          ut_keygrabtable \
           ut_launchermodel \
           ut_lipsticksettings \
           ut_lipsticknotification \
@@ -8,13 +16,22 @@ SUBDIRS = \
           ut_notificationlistmodel \
           ut_notificationmanager \
           ut_notificationpreviewpresenter \
+          ut_orientationmonitor \
+          ut_processterminator \
           ut_qobjectlistmodel \
           ut_screenlock \
+          ut_setupdatesenabledbatch \
           ut_shutdownscreen \
+          ut_snapshotcapture \
+          ut_snapshotstore \
+          ut_statesnapshot \
+          ut_thermal \
           ut_thermalnotifier \
           ut_touchscreen \
+          ut_tracing \
           ut_usbmodeselector \
           ut_volumecontrol \
+          ut_windowpropertycache \
 
 support_files.commands += $$PWD/gen-tests-xml.sh > $$OUT_PWD/tests.xml
 support_files.target = support_files
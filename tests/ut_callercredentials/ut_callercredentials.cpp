@@ -0,0 +1,296 @@
+/***************************************************************************
+**
+** Copyright (c) 2021 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QDBusConnection>
+#include <QDBusPendingCallWatcher>
+#include <QDBusServiceWatcher>
+#include <unistd.h>
+#include "callercredentials.h"
+#include "ut_callercredentials.h"
+
+namespace {
+
+const char * const ServicePath = "/ut_callercredentials";
+const char * const ServiceInterface = "org.nemomobile.lipstick.test.PrivilegedService";
+
+enum Cache {
+    Cached,
+    Resolved
+};
+
+}
+
+PrivilegedService::PrivilegedService()
+{
+    reset();
+}
+
+void PrivilegedService::reset()
+{
+    actionCount = 0;
+    ranImmediately = false;
+    guard = this;
+    called = nullptr;
+}
+
+void PrivilegedService::run()
+{
+    const int count = actionCount;
+    CallerCredentials::instance()->runPrivileged(*this, guard, [this] {
+        ++actionCount;
+    });
+    ranImmediately = actionCount > count;
+    if (called) {
+        called(message());
+    }
+}
+
+QString PrivilegedService::runWithReply()
+{
+    const int count = actionCount;
+    CallerCredentials::instance()->runPrivileged(*this, guard, [this](const QDBusMessage &message) {
+        ++actionCount;
+        return message.createReply(QStringLiteral("result"));
+    });
+    ranImmediately = actionCount > count;
+    if (called) {
+        called(message());
+    }
+    // Not sent, the reply comes from the action
+    return QString();
+}
+
+void Ut_CallerCredentials::initTestCase()
+{
+    QDBusConnection bus = QDBusConnection::sessionBus();
+    m_busAvailable = bus.isConnected() && bus.registerObject(ServicePath, &m_service, QDBusConnection::ExportAllSlots);
+}
+
+void Ut_CallerCredentials::init()
+{
+    // The caller is another connection of the test process, which is
+    // always privileged
+    static int callerCount = 0;
+    m_callerName = QString("ut_callercredentials_caller%1").arg(++callerCount);
+    if (m_busAvailable) {
+        QDBusConnection::connectToBus(QDBusConnection::SessionBus, m_callerName);
+    }
+    m_service.reset();
+    CallerCredentials::instance()->m_sentReplies.clear();
+}
+
+void Ut_CallerCredentials::cleanup()
+{
+    QDBusConnection::disconnectFromBus(m_callerName);
+}
+
+QDBusMessage Ut_CallerCredentials::callService(const QString &method)
+{
+    QDBusMessage message = QDBusMessage::createMethodCall(QDBusConnection::sessionBus().baseService(),
+                                                          ServicePath, ServiceInterface, method);
+    // The service is handled by the event loop of this thread, so the
+    // call can not block
+    QDBusPendingCallWatcher watcher(QDBusConnection(m_callerName).asyncCall(message));
+    if (!watcher.isFinished()) {
+        QEventLoop loop;
+        connect(&watcher, &QDBusPendingCallWatcher::finished, &loop, &QEventLoop::quit);
+        loop.exec();
+    }
+    return watcher.reply();
+}
+
+QString Ut_CallerCredentials::cacheKey() const
+{
+    return CallerCredentials::cacheKey(QDBusConnection::sessionBus().name(),
+                                       QDBusConnection(m_callerName).baseService());
+}
+
+void Ut_CallerCredentials::testOwnProcessIsPrivileged()
+{
+    QVERIFY(CallerCredentials::processIsPrivileged(getpid()));
+}
+
+void Ut_CallerCredentials::testInvalidProcessIsNotPrivileged()
+{
+    QVERIFY(!CallerCredentials::processIsPrivileged(0));
+    QVERIFY(!CallerCredentials::processIsPrivileged(-1));
+}
+
+void Ut_CallerCredentials::testLocalCallsArePrivileged()
+{
+    QDBusContext context;
+    bool actionRun = false;
+
+    CallerCredentials::instance()->runPrivileged(context, this, [&actionRun] {
+        actionRun = true;
+    });
+    QCOMPARE(actionRun, true);
+}
+
+void Ut_CallerCredentials::testFirstCallIsDelayed()
+{
+    if (!m_busAvailable) {
+        QSKIP("No session bus");
+    }
+
+    QCOMPARE(callService().type(), QDBusMessage::ReplyMessage);
+    QCOMPARE(m_service.ranImmediately, false);
+    QCOMPARE(m_service.actionCount, 1);
+    QCOMPARE(CallerCredentials::instance()->m_privileged.value(cacheKey(), false), true);
+    QVERIFY(CallerCredentials::instance()->m_pendingCalls.isEmpty());
+}
+
+void Ut_CallerCredentials::testCachedCallIsNotDelayed()
+{
+    if (!m_busAvailable) {
+        QSKIP("No session bus");
+    }
+
+    callService();
+    QCOMPARE(callService().type(), QDBusMessage::ReplyMessage);
+    QCOMPARE(m_service.ranImmediately, true);
+    QCOMPARE(m_service.actionCount, 2);
+}
+
+void Ut_CallerCredentials::testCacheInvalidatedWhenNameUnregistered()
+{
+    if (!m_busAvailable) {
+        QSKIP("No session bus");
+    }
+
+    callService();
+    const QString key = cacheKey();
+    QVERIFY(CallerCredentials::instance()->m_privileged.contains(key));
+
+    QDBusConnection::disconnectFromBus(m_callerName);
+    QTRY_VERIFY(!CallerCredentials::instance()->m_privileged.contains(key));
+}
+
+void Ut_CallerCredentials::testNameUnregisteredBeforeCredentials()
+{
+    if (!m_busAvailable) {
+        QSKIP("No session bus");
+    }
+
+    // Deliver the unregistration before the credentials reply
+    m_service.called = [](const QDBusMessage &message) {
+        QDBusServiceWatcher *watcher = CallerCredentials::instance()->m_serviceWatchers.value(QDBusConnection::sessionBus().name());
+        QVERIFY(watcher);
+        emit watcher->serviceUnregistered(message.service());
+    };
+
+    QCOMPARE(callService().type(), QDBusMessage::ReplyMessage);
+    QCOMPARE(m_service.actionCount, 1);
+    QVERIFY(!CallerCredentials::instance()->m_privileged.contains(cacheKey()));
+}
+
+void Ut_CallerCredentials::testNameWithoutOwnerIsForgotten()
+{
+    if (!m_busAvailable) {
+        QSKIP("No session bus");
+    }
+
+    QCOMPARE(callService().type(), QDBusMessage::ReplyMessage);
+    QVERIFY(CallerCredentials::instance()->m_privileged.contains(cacheKey()));
+
+    // A name whose unregistration was missed by the watcher
+    const QDBusConnection bus = QDBusConnection::sessionBus();
+    const QString service = QStringLiteral(":0.0");
+    const QString key = CallerCredentials::cacheKey(bus.name(), service);
+    CallerCredentials::instance()->m_privileged.insert(key, true);
+    CallerCredentials::instance()->verifyOwner(bus, service);
+    CallerCredentials::instance()->verifyOwner(bus, QDBusConnection(m_callerName).baseService());
+
+    QTRY_VERIFY(!CallerCredentials::instance()->m_privileged.contains(key));
+    QVERIFY(CallerCredentials::instance()->m_privileged.contains(cacheKey()));
+}
+
+void Ut_CallerCredentials::testDestroyedGuardDeniesDelayedCall()
+{
+    if (!m_busAvailable) {
+        QSKIP("No session bus");
+    }
+
+    m_service.guard = new QObject;
+    m_service.called = [this](const QDBusMessage &) {
+        delete m_service.guard;
+    };
+
+    const QDBusMessage reply = callService();
+    QCOMPARE(reply.type(), QDBusMessage::ErrorMessage);
+    QCOMPARE(reply.errorName(), QDBusError::errorString(QDBusError::AccessDenied));
+    QCOMPARE(m_service.ranImmediately, false);
+    QCOMPARE(m_service.actionCount, 0);
+    QCOMPARE(CallerCredentials::instance()->m_sentReplies.count(), 1);
+}
+
+void Ut_CallerCredentials::testOneReplyPerCall_data()
+{
+    QTest::addColumn<QString>("method");
+    QTest::addColumn<QVariantList>("arguments");
+
+    QTest::newRow("empty reply") << QString("run") << QVariantList();
+    QTest::newRow("reply from action") << QString("runWithReply") << (QVariantList() << QString("result"));
+}
+
+void Ut_CallerCredentials::testOneReplyPerCall()
+{
+    if (!m_busAvailable) {
+        QSKIP("No session bus");
+    }
+
+    QFETCH(QString, method);
+    QFETCH(QVariantList, arguments);
+    const QList<QDBusMessage> &sent = CallerCredentials::instance()->m_sentReplies;
+
+    // Resolved first, then from the cache
+    for (int i = 1; i <= 2; ++i) {
+        const QDBusMessage reply = callService(method);
+        QCOMPARE(reply.type(), QDBusMessage::ReplyMessage);
+        QCOMPARE(reply.arguments(), arguments);
+        QCOMPARE(m_service.ranImmediately, i == 2);
+        QCOMPARE(m_service.actionCount, i);
+        QCOMPARE(sent.count(), i);
+        QCOMPARE(sent.last().arguments(), arguments);
+    }
+}
+
+void Ut_CallerCredentials::benchmarkPrivilegedCall_data()
+{
+    QTest::addColumn<int>("cache");
+
+    QTest::newRow("cached") << int(Cached);
+    QTest::newRow("resolved") << int(Resolved);
+}
+
+void Ut_CallerCredentials::benchmarkPrivilegedCall()
+{
+    if (!m_busAvailable) {
+        QSKIP("No session bus");
+    }
+
+    QFETCH(int, cache);
+
+    callService();
+    QBENCHMARK {
+        if (cache == Resolved) {
+            CallerCredentials::instance()->m_privileged.clear();
+        }
+        callService();
+    }
+    QVERIFY(m_service.actionCount > 1);
+}
+
+QTEST_MAIN(Ut_CallerCredentials)
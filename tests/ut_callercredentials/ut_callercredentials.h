@@ -0,0 +1,80 @@
+/***************************************************************************
+**
+** Copyright (c) 2021 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#ifndef UT_CALLERCREDENTIALS_H
+#define UT_CALLERCREDENTIALS_H
+
+#include <QObject>
+#include <QDBusContext>
+#include <QDBusMessage>
+#include <functional>
+
+// Object whose D-Bus method runs a privileged action
+class PrivilegedService : public QObject, protected QDBusContext
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "org.nemomobile.lipstick.test.PrivilegedService")
+
+public:
+    PrivilegedService();
+
+    void reset();
+
+    int actionCount;
+    bool ranImmediately;
+    QObject *guard;
+    std::function<void(const QDBusMessage &)> called;
+
+public slots:
+    void run();
+    QString runWithReply();
+};
+
+class Ut_CallerCredentials : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    // Called before the first testfunction is executed
+    void initTestCase();
+    // Called before each testfunction is executed
+    void init();
+    // Called after every testfunction
+    void cleanup();
+
+    // Test cases
+    void testOwnProcessIsPrivileged();
+    void testInvalidProcessIsNotPrivileged();
+    void testLocalCallsArePrivileged();
+    void testFirstCallIsDelayed();
+    void testCachedCallIsNotDelayed();
+    void testCacheInvalidatedWhenNameUnregistered();
+    void testNameUnregisteredBeforeCredentials();
+    void testNameWithoutOwnerIsForgotten();
+    void testDestroyedGuardDeniesDelayedCall();
+    void testOneReplyPerCall_data();
+    void testOneReplyPerCall();
+    void benchmarkPrivilegedCall_data();
+    void benchmarkPrivilegedCall();
+
+private:
+    QDBusMessage callService(const QString &method = QStringLiteral("run"));
+    QString cacheKey() const;
+
+    PrivilegedService m_service;
+    bool m_busAvailable;
+    QString m_callerName;
+};
+
+#endif
@@ -0,0 +1,16 @@
+include(../common.pri)
+TARGET = ut_callercredentials
+
+INCLUDEPATH += $$UTILITYSRCDIR
+QT += dbus
+
+# unit test and unit
+SOURCES += \
+    ut_callercredentials.cpp \
+    $$UTILITYSRCDIR/callercredentials.cpp \
+    $$SRCDIR/logging.cpp
+
+# unit test and unit
+HEADERS += \
+    ut_callercredentials.h \
+    $$UTILITYSRCDIR/callercredentials.h
@@ -0,0 +1,146 @@
+/***************************************************************************
+**
+** Copyright (c) 2021 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include "ut_framestatistics.h"
+#include "framestatistics.h"
+
+namespace {
+
+const qint64 Millisecond = 1000;
+const qint64 Second = 1000000;
+const QSize BufferSize(540, 960);
+
+void commitFrames(FrameStatistics *statistics, qint64 start, int count, qint64 interval, qint64 damagedArea = 0)
+{
+    for (int i = 0; i < count; ++i)
+        statistics->commit(start + i * interval, damagedArea, BufferSize, FrameStatistics::ShmBuffer);
+}
+
+}
+
+void Ut_FrameStatistics::testEmpty()
+{
+    FrameStatistics statistics;
+
+    QCOMPARE(statistics.commitCount(), quint64(0));
+    QCOMPARE(statistics.commitRate(Second), qreal(0));
+    QCOMPARE(statistics.averageDamagedArea(), qint64(0));
+    QCOMPARE(statistics.averageFrameCallbackLatency(), qint64(-1));
+    QCOMPARE(statistics.maximumFrameCallbackLatency(), qint64(-1));
+    QCOMPARE(statistics.bufferType(), FrameStatistics::NoBuffer);
+
+    statistics.frameCallbacksSent(Second);
+    QCOMPARE(statistics.averageFrameCallbackLatency(), qint64(-1));
+}
+
+void Ut_FrameStatistics::testCommitRate()
+{
+    FrameStatistics statistics;
+
+    // 25 frames per second for two seconds, read between two frames
+    commitFrames(&statistics, 0, 50, Second / 25);
+    QCOMPARE(statistics.commitCount(), quint64(50));
+    QCOMPARE(statistics.commitRate(2 * Second - Second / 50), qreal(25));
+
+    // A window that stopped committing
+    QCOMPARE(statistics.commitRate(10 * Second), qreal(0));
+}
+
+void Ut_FrameStatistics::testCommitRateAboveCapacity()
+{
+    FrameStatistics statistics;
+
+    // More commits during the last second than are kept
+    const int count = FrameStatistics::Capacity * 2;
+    commitFrames(&statistics, 0, count, Second / count);
+    const qreal rate = statistics.commitRate(Second);
+    QVERIFY2(rate > count * 0.9 && rate < count * 1.1, qPrintable(QString::number(rate)));
+}
+
+void Ut_FrameStatistics::testDamagedArea()
+{
+    FrameStatistics statistics;
+
+    statistics.commit(0, 100, BufferSize, FrameStatistics::ShmBuffer);
+    statistics.commit(Millisecond, 300, BufferSize, FrameStatistics::ShmBuffer);
+    QCOMPARE(statistics.averageDamagedArea(), qint64(200));
+}
+
+void Ut_FrameStatistics::testFrameCallbackLatency()
+{
+    FrameStatistics statistics;
+
+    statistics.commit(0, 0, BufferSize, FrameStatistics::EglBuffer);
+    statistics.commit(2 * Millisecond, 0, BufferSize, FrameStatistics::EglBuffer);
+    QCOMPARE(statistics.averageFrameCallbackLatency(), qint64(-1));
+
+    // Both commits were waiting for the same frame
+    statistics.frameCallbacksSent(10 * Millisecond);
+    QCOMPARE(statistics.averageFrameCallbackLatency(), 9 * Millisecond);
+    QCOMPARE(statistics.maximumFrameCallbackLatency(), 10 * Millisecond);
+
+    // Commits that have already got their frame callbacks are not affected by later frames
+    statistics.frameCallbacksSent(100 * Millisecond);
+    QCOMPARE(statistics.maximumFrameCallbackLatency(), 10 * Millisecond);
+
+    statistics.commit(100 * Millisecond, 0, BufferSize, FrameStatistics::EglBuffer);
+    QCOMPARE(statistics.averageFrameCallbackLatency(), 9 * Millisecond);
+    statistics.frameCallbacksSent(130 * Millisecond);
+    QCOMPARE(statistics.averageFrameCallbackLatency(), 16 * Millisecond);
+    QCOMPARE(statistics.maximumFrameCallbackLatency(), 30 * Millisecond);
+}
+
+void Ut_FrameStatistics::testOnlyRecentCommitsKept()
+{
+    FrameStatistics statistics;
+
+    // Slow frames with a large damage, followed by enough small ones to push them out
+    commitFrames(&statistics, 0, 10, 100 * Millisecond, 10000);
+    statistics.frameCallbacksSent(Second);
+    commitFrames(&statistics, 2 * Second, FrameStatistics::Capacity, Millisecond, 10);
+    statistics.frameCallbacksSent(2 * Second + FrameStatistics::Capacity * Millisecond);
+
+    QCOMPARE(statistics.commitCount(), quint64(FrameStatistics::Capacity + 10));
+    QCOMPARE(statistics.averageDamagedArea(), qint64(10));
+    QCOMPARE(statistics.maximumFrameCallbackLatency(), FrameStatistics::Capacity * Millisecond);
+}
+
+void Ut_FrameStatistics::testBuffer()
+{
+    FrameStatistics statistics;
+
+    statistics.commit(0, 0, QSize(100, 100), FrameStatistics::ShmBuffer);
+    QCOMPARE(statistics.bufferSize(), QSize(100, 100));
+    QCOMPARE(statistics.bufferType(), FrameStatistics::ShmBuffer);
+
+    // The most recent buffer is reported
+    statistics.commit(Millisecond, 0, BufferSize, FrameStatistics::EglBuffer);
+    QCOMPARE(statistics.bufferSize(), BufferSize);
+    QCOMPARE(statistics.bufferType(), FrameStatistics::EglBuffer);
+}
+
+void Ut_FrameStatistics::benchmarkCommit()
+{
+    // Recording a frame of a window, as done for every commit and every frame of the compositor
+    FrameStatistics statistics;
+    qint64 time = 0;
+    QBENCHMARK {
+        statistics.commit(time, 1000, BufferSize, FrameStatistics::EglBuffer);
+        time += 16 * Millisecond;
+        statistics.frameCallbacksSent(time);
+    }
+}
+
+QTEST_MAIN(Ut_FrameStatistics)
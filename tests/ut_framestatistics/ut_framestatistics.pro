@@ -0,0 +1,13 @@
+include(../common.pri)
+TARGET = ut_framestatistics
+INCLUDEPATH += $$COMPOSITORSRCDIR
+
+# unit test and unit
+SOURCES += \
+    ut_framestatistics.cpp \
+    $$COMPOSITORSRCDIR/framestatistics.cpp
+
+# unit test and unit
+HEADERS += \
+    ut_framestatistics.h \
+    $$COMPOSITORSRCDIR/framestatistics.h
@@ -0,0 +1,157 @@
+/***************************************************************************
+**
+** Copyright (c) 2021 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include "ut_keygrabtable.h"
+#include "keygrabtable.h"
+
+namespace {
+
+struct Window
+{
+    int id;
+};
+
+typedef KeyGrabTable<Window> Table;
+
+}
+
+void Ut_KeyGrabTable::testUngrabbedKey()
+{
+    Table table;
+    Window window = { 1 };
+    table.setGrabbedKeys(&window, QList<int>() << Qt::Key_VolumeUp);
+
+    QVERIFY(!table.grabber(Qt::Key_VolumeDown));
+    QVERIFY(!table.press(Qt::Key_VolumeDown));
+    QVERIFY(!table.release(Qt::Key_VolumeDown));
+}
+
+void Ut_KeyGrabTable::testMostRecentGrabberTakesPrecedence()
+{
+    Table table;
+    Window first = { 1 };
+    Window second = { 2 };
+    table.setGrabbedKeys(&first, QList<int>() << Qt::Key_VolumeUp << Qt::Key_VolumeDown);
+    table.setGrabbedKeys(&second, QList<int>() << Qt::Key_VolumeDown);
+
+    QCOMPARE(table.grabber(Qt::Key_VolumeUp), &first);
+    QCOMPARE(table.grabber(Qt::Key_VolumeDown), &second);
+
+    table.setGrabbedKeys(&second, QList<int>());
+    QCOMPARE(table.grabber(Qt::Key_VolumeDown), &first);
+
+    table.setGrabbedKeys(&first, QList<int>());
+    QVERIFY(table.isEmpty());
+}
+
+void Ut_KeyGrabTable::testPrecedenceKeptWhenGrabChanges()
+{
+    Table table;
+    Window first = { 1 };
+    Window second = { 2 };
+    table.setGrabbedKeys(&first, QList<int>() << Qt::Key_VolumeUp);
+    table.setGrabbedKeys(&second, QList<int>() << Qt::Key_VolumeUp);
+
+    // Changing the keys of a window that is grabbing does not make it the most recent grabber
+    table.setGrabbedKeys(&first, QList<int>() << Qt::Key_VolumeUp << Qt::Key_VolumeDown);
+    QCOMPARE(table.grabber(Qt::Key_VolumeUp), &second);
+    QCOMPARE(table.grabber(Qt::Key_VolumeDown), &first);
+
+    table.setGrabbedKeys(&second, QList<int>() << Qt::Key_VolumeUp << Qt::Key_VolumeDown);
+    QCOMPARE(table.grabber(Qt::Key_VolumeDown), &second);
+}
+
+void Ut_KeyGrabTable::testRegrabTakesPrecedence()
+{
+    Table table;
+    Window first = { 1 };
+    Window second = { 2 };
+    table.setGrabbedKeys(&first, QList<int>() << Qt::Key_VolumeUp);
+    table.setGrabbedKeys(&second, QList<int>() << Qt::Key_VolumeUp);
+
+    table.setGrabbedKeys(&first, QList<int>());
+    table.setGrabbedKeys(&first, QList<int>() << Qt::Key_VolumeUp);
+    QCOMPARE(table.grabber(Qt::Key_VolumeUp), &first);
+}
+
+void Ut_KeyGrabTable::testReleaseGoesToPressedWindow()
+{
+    Table table;
+    Window first = { 1 };
+    Window second = { 2 };
+    table.setGrabbedKeys(&first, QList<int>() << Qt::Key_VolumeUp);
+
+    QCOMPARE(table.press(Qt::Key_VolumeUp), &first);
+    table.setGrabbedKeys(&second, QList<int>() << Qt::Key_VolumeUp);
+    QCOMPARE(table.release(Qt::Key_VolumeUp), &first);
+    QCOMPARE(table.release(Qt::Key_VolumeUp), &second);
+
+    // The release follows the press even when the window no longer grabs the key
+    QCOMPARE(table.press(Qt::Key_VolumeUp), &second);
+    table.setGrabbedKeys(&second, QList<int>());
+    QVERIFY(!table.isEmpty());
+    QCOMPARE(table.release(Qt::Key_VolumeUp), &second);
+    QCOMPARE(table.grabber(Qt::Key_VolumeUp), &first);
+}
+
+void Ut_KeyGrabTable::testRemoveWindow()
+{
+    Table table;
+    Window first = { 1 };
+    Window second = { 2 };
+    table.setGrabbedKeys(&first, QList<int>() << Qt::Key_VolumeUp);
+    table.setGrabbedKeys(&second, QList<int>() << Qt::Key_VolumeUp << Qt::Key_Camera);
+
+    QCOMPARE(table.press(Qt::Key_VolumeUp), &second);
+    table.removeWindow(&second);
+    QCOMPARE(table.release(Qt::Key_VolumeUp), &first);
+    QVERIFY(!table.grabber(Qt::Key_Camera));
+
+    table.removeWindow(&first);
+    QVERIFY(table.isEmpty());
+}
+
+void Ut_KeyGrabTable::benchmarkDispatch_data()
+{
+    QTest::addColumn<int>("windowCount");
+
+    QTest::newRow("1 grabbing window") << 1;
+    QTest::newRow("10 grabbing windows") << 10;
+    QTest::newRow("100 grabbing windows") << 100;
+}
+
+void Ut_KeyGrabTable::benchmarkDispatch()
+{
+    QFETCH(int, windowCount);
+
+    // Every window grabs the volume keys and a key of its own
+    QVector<Window> windows(windowCount);
+    Table table;
+    for (int i = 0; i < windowCount; ++i) {
+        windows[i].id = i;
+        table.setGrabbedKeys(&windows[i], QList<int>() << Qt::Key_VolumeUp << Qt::Key_VolumeDown << Qt::Key_F1 + i);
+    }
+
+    Window *last = &windows[windowCount - 1];
+    QBENCHMARK {
+        // The keys pressed while the grab is active, and one nobody is grabbing
+        QCOMPARE(table.press(Qt::Key_VolumeUp), last);
+        QCOMPARE(table.release(Qt::Key_VolumeUp), last);
+        QVERIFY(!table.press(Qt::Key_Home));
+        QVERIFY(!table.release(Qt::Key_Home));
+    }
+}
+
+QTEST_MAIN(Ut_KeyGrabTable)
@@ -0,0 +1,35 @@
+/***************************************************************************
+**
+** Copyright (c) 2021 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+#ifndef UT_KEYGRABTABLE_H
+#define UT_KEYGRABTABLE_H
+
+#include <QObject>
+
+class Ut_KeyGrabTable : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    // Test cases
+    void testUngrabbedKey();
+    void testMostRecentGrabberTakesPrecedence();
+    void testPrecedenceKeptWhenGrabChanges();
+    void testRegrabTakesPrecedence();
+    void testReleaseGoesToPressedWindow();
+    void testRemoveWindow();
+    void benchmarkDispatch_data();
+    void benchmarkDispatch();
+};
+
+#endif
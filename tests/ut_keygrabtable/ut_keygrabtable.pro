@@ -0,0 +1,12 @@
+include(../common.pri)
+TARGET = ut_keygrabtable
+INCLUDEPATH += $$COMPOSITORSRCDIR
+
+# unit test
+SOURCES += \
+    ut_keygrabtable.cpp
+
+# unit test and unit
+HEADERS += \
+    ut_keygrabtable.h \
+    $$COMPOSITORSRCDIR/keygrabtable.h
@@ -26,6 +26,7 @@ SOURCES += \
     $$STUBSDIR/stubbase.cpp \
     $$UTILITYSRCDIR/qobjectlistmodel.cpp \
     $$SRCDIR/logging.cpp \
+    $$SRCDIR/tracing.cpp \
 
 HEADERS += \
     ut_launchermodel.h \
@@ -36,5 +37,6 @@ HEADERS += \
     $$UTILITYSRCDIR/qobjectlistmodel.h \
     $$3RDPARTYSRCDIR/synchronizelists.h \
     $$SRCDIR/logging.h \
+    $$SRCDIR/tracing.h \
     /usr/include/mlite5/mdesktopentry.h \
 
@@ -232,4 +232,76 @@ void Ut_Notification::testSerialization()
     QVERIFY(n2.disambiguatedAppName() != n1.appName());
 }
 
+void Ut_Notification::testStringsAreShared()
+{
+    // Equal strings constructed separately
+    const QString appName1 = QString("ut_lipsticknotification.") + QString::number(1);
+    const QString appName2 = QString("ut_lipsticknotification.") + QString::number(1);
+    QVERIFY(appName1.constData() != appName2.constData());
+
+    LipstickNotification first(appName1, appName1, appName1, 1, QString(), "summary", "body", QStringList(), QVariantHash(), -1);
+    LipstickNotification second(appName2, appName2, appName2, 2, QString(), "summary", "body", QStringList(), QVariantHash(), -1);
+    QCOMPARE(second.appName(), first.appName());
+    QCOMPARE(second.appName().constData(), first.appName().constData());
+}
+
+void Ut_Notification::testDeserializedStringsAreShared()
+{
+    const QString appName = QString("ut_lipsticknotification.") + QString::number(3);
+    QVariantHash hints;
+    hints.insert(LipstickNotification::HINT_CATEGORY, QString("ut_lipsticknotification.category"));
+    LipstickNotification first(appName, appName, appName, 1, QString(), "summary", "body", QStringList(), hints, -1);
+    LipstickNotification second;
+
+    QDBusArgument arg;
+    arg << LipstickNotification(QString(appName.constData(), appName.length()), QString(), QString(), 2, QString(),
+                                "summary", "body", QStringList(), hints, -1);
+    arg >> second;
+
+    QCOMPARE(second.appName(), first.appName());
+    QCOMPARE(second.appName().constData(), first.appName().constData());
+    QCOMPARE(second.category().constData(), first.category().constData());
+}
+
+void Ut_Notification::testHintValues()
+{
+    QVariantHash hints;
+    hints.insert(LipstickNotification::HINT_PRIORITY, 1);
+    hints.insert(LipstickNotification::HINT_CATEGORY, "category");
+    hints.insert("x-ut-hint", "value1");
+    LipstickNotification notification("appName", "", "", 1, "appIcon", "summary", "body", QStringList(), hints, 1);
+
+    // Hints represented by other properties are filtered out
+    QVariantMap expected;
+    expected.insert("x-ut-hint", "value1");
+    QCOMPARE(notification.hintValues(), expected);
+    QCOMPARE(notification.hintValues(), expected);
+
+    hints.insert("x-ut-hint", "value2");
+    notification.setHints(hints);
+    expected.insert("x-ut-hint", "value2");
+    QCOMPARE(notification.hintValues(), expected);
+}
+
+void Ut_Notification::testUnusedStringsAreReleased()
+{
+    QString appName;
+    {
+        LipstickNotification notification(QString("ut_lipsticknotification.") + QString::number(2),
+                                          QString(), QString(), 1, QString(), "summary", "body",
+                                          QStringList(), QVariantHash(), -1);
+        appName = notification.appName();
+    }
+    // Still shared with the pool
+    QVERIFY(!appName.isDetached());
+
+    // Intern enough strings used by no notification to make the pool prune itself
+    for (int i = 0; i < 10000; ++i) {
+        LipstickNotification notification(QString("ut_lipsticknotification.unused") + QString::number(i),
+                                          QString(), QString(), 1, QString(), "summary", "body",
+                                          QStringList(), QVariantHash(), -1);
+    }
+    QVERIFY(appName.isDetached());
+}
+
 QTEST_MAIN(Ut_Notification)
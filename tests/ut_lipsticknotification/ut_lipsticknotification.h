@@ -26,6 +26,10 @@ private slots:
     void testIcon();
     void testSignals();
     void testSerialization();
+    void testStringsAreShared();
+    void testDeserializedStringsAreShared();
+    void testHintValues();
+    void testUnusedStringsAreReleased();
 };
 
 #endif
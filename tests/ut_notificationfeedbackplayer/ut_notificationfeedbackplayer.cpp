@@ -122,12 +122,6 @@ LipstickNotification *createNotification(uint id, int urgency = 0, QVariant prio
     return notification;
 }
 
-QVariantMap qWaylandSurfaceWindowProperties;
-QVariantMap QWaylandSurface::windowProperties() const
-{
-    return qWaylandSurfaceWindowProperties;
-}
-
 void QTimer::singleShot(int, const QObject *receiver, const char *member)
 {
     // The "member" string is of form "1member()", so remove the trailing 1 and the ()
@@ -153,7 +147,7 @@ void Ut_NotificationFeedbackPlayer::cleanup()
     delete player;
 
     gClientStub->stubReset();
-    gLipstickCompositorStub->stubSetReturnValue("surfaceForId", (QWaylandSurface *)0);
+    gLipstickCompositorStub->stubSetReturnValue("notificationPreviewsDisabled", uint(0));
 }
 
 void Ut_NotificationFeedbackPlayer::testAddAndRemoveNotification()
@@ -356,8 +350,9 @@ void Ut_NotificationFeedbackPlayer::testNotificationPreviewsDisabled()
     QFETCH(int, urgency);
     QFETCH(int, playCount);
 
-    gLipstickCompositorStub->stubSetReturnValue("surfaceForId", surface);
-    qWaylandSurfaceWindowProperties = windowProperties;
+    // The compositor reports the default mode for windows without a surface or the property
+    const uint mode = surface ? windowProperties.value("NOTIFICATION_PREVIEWS_DISABLED", 0).toUInt() : 0;
+    gLipstickCompositorStub->stubSetReturnValue("notificationPreviewsDisabled", mode);
 
     createNotification(1, urgency);
     player->addNotification(1);
@@ -19,6 +19,7 @@
 #include "notificationmanager.h"
 #include "notificationmanageradaptor_stub.h"
 #include "lipsticknotification.h"
+#include "systemnotification.h"
 #include "categorydefinitionstore_stub.h"
 #include "androidprioritystore_stub.h"
 #include <QSqlQuery>
@@ -379,4 +380,70 @@ void Ut_NotificationManager::testImmediateExpiration()
     QCOMPARE(closedSpy.last().at(1).toUInt(), static_cast<uint>(NotificationManager::NotificationExpired));
 }
 
+void Ut_NotificationManager::testPublishingSystemNotification()
+{
+    NotificationManager *manager = NotificationManager::instance();
+    QSignalSpy addedSpy(manager, SIGNAL(notificationAdded(uint)));
+
+    uint id = manager->publishSystemNotification(SystemNotification("body").setIcon("icon").setFeedback("feedback"));
+    QCOMPARE(addedSpy.count(), 1);
+    QCOMPARE(addedSpy.last().at(0).toUInt(), id);
+
+    LipstickNotification *notification = manager->notification(id);
+    QVERIFY(notification != 0);
+    QCOMPARE(notification->appName(), manager->systemApplicationName());
+    QCOMPARE(notification->appIcon(), QString("icon"));
+    QCOMPARE(notification->body(), QString("body"));
+    QCOMPARE(notification->previewBody(), QString("body"));
+    QCOMPARE(notification->urgency(), static_cast<int>(LipstickNotification::Critical));
+    QCOMPARE(notification->isTransient(), true);
+    QCOMPARE(notification->hints().value(LipstickNotification::HINT_FEEDBACK).toString(), QString("feedback"));
+
+    // Replacing keeps the ID and reports a modification
+    QSignalSpy modifiedSpy(manager, SIGNAL(notificationModified(uint)));
+    QCOMPARE(manager->publishSystemNotification(SystemNotification("other body"), id), id);
+    QCOMPARE(modifiedSpy.count(), 1);
+    QCOMPARE(manager->notification(id)->body(), QString("other body"));
+
+    manager->closeNotifications(manager->notificationIds());
+}
+
+static int storedNotificationCount(NotificationManager *manager, uint id)
+{
+    QSqlQuery query(*manager->m_database);
+    query.prepare("SELECT COUNT(*) FROM notifications WHERE id=?");
+    query.addBindValue(id);
+    if (!query.exec() || !query.next()) {
+        return -1;
+    }
+    return query.value(0).toInt();
+}
+
+void Ut_NotificationManager::testTransientSystemNotificationIsNotStored()
+{
+    NotificationManager *manager = NotificationManager::instance();
+    if (!manager->m_database->isOpen()) {
+        QSKIP("The notification database could not be opened");
+    }
+
+    const uint transientId = manager->publishSystemNotification(SystemNotification("transient"));
+    QCOMPARE(storedNotificationCount(manager, transientId), 0);
+
+    const uint persistentId = manager->publishSystemNotification(SystemNotification("persistent").setTransient(false));
+    QCOMPARE(storedNotificationCount(manager, persistentId), 1);
+
+    manager->closeNotifications(manager->notificationIds());
+}
+
+void Ut_NotificationManager::testSystemNotificationProgressIsNotUserRemovable()
+{
+    NotificationManager *manager = NotificationManager::instance();
+
+    const uint id = manager->publishSystemNotification(SystemNotification("body")
+                                                       .setHint(LipstickNotification::HINT_PROGRESS, 0.5));
+    QCOMPARE(manager->notification(id)->isUserRemovable(), false);
+
+    manager->closeNotifications(manager->notificationIds());
+}
+
 QTEST_MAIN(Ut_NotificationManager)
@@ -37,6 +37,9 @@ private slots:
     void testRemoveUserRemovableNotifications();
     void testRemoveRequested();
     void testImmediateExpiration();
+    void testPublishingSystemNotification();
+    void testTransientSystemNotificationIsNotStored();
+    void testSystemNotificationProgressIsNotUserRemovable();
 
 signals:
     void actionInvoked(QString action);
@@ -10,6 +10,9 @@ SOURCES += \
     ut_notificationmanager.cpp \
     $$NOTIFICATIONSRCDIR/notificationmanager.cpp \
     $$NOTIFICATIONSRCDIR/lipsticknotification.cpp \
+    $$UTILITYSRCDIR/callercredentials.cpp \
+    $$SRCDIR/logging.cpp \
+    $$SRCDIR/tracing.cpp \
     $$STUBSDIR/stubbase.cpp \
 
 # unit test and unit
@@ -17,6 +20,7 @@ HEADERS += \
     ut_notificationmanager.h \
     $$NOTIFICATIONSRCDIR/notificationmanager.h \
     $$NOTIFICATIONSRCDIR/lipsticknotification.h \
+    $$UTILITYSRCDIR/callercredentials.h \
     $$NOTIFICATIONSRCDIR/notificationmanageradaptor.h \
     $$NOTIFICATIONSRCDIR/categorydefinitionstore.h \
     $$NOTIFICATIONSRCDIR/androidprioritystore.h \
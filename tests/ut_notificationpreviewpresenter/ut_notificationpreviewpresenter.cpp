@@ -23,7 +23,6 @@
 #include "notificationpreviewpresenter.h"
 #include "notificationfeedbackplayer_stub.h"
 #include "lipstickcompositor_stub.h"
-#include "closeeventeater_stub.h"
 #include "displaystate_stub.h"
 #include "lipstickqmlpath_stub.h"
 #include "lipsticksettings.h"
@@ -95,6 +94,12 @@ void HomeWindow::setCategory(const QString &category)
     homeWindowCategories[this] = category;
 }
 
+QHash<HomeWindow *, bool> homeWindowCloseEventsIgnored;
+void HomeWindow::setCloseEventsIgnored(bool ignored)
+{
+    homeWindowCloseEventsIgnored[this] = ignored;
+}
+
 LipstickSettings *LipstickSettings::instance()
 {
     return 0;
@@ -216,12 +221,6 @@ LipstickNotification *createNotification(uint id, Urgency urgency = Normal)
     return notification;
 }
 
-QVariantMap qWaylandSurfaceWindowProperties;
-QVariantMap QWaylandSurface::windowProperties() const
-{
-    return qWaylandSurfaceWindowProperties;
-}
-
 void Ut_NotificationPreviewPresenter::initTestCase()
 {
     qRegisterMetaType<LipstickNotification *>();
@@ -245,11 +244,13 @@ void Ut_NotificationPreviewPresenter::cleanup()
 
     homeWindows.clear();
     homeWindowVisible.clear();
+    homeWindowCloseEventsIgnored.clear();
     qDeleteAll(notificationManagerNotification);
     notificationManagerNotification.clear();
     notificationManagerCloseNotificationIds.clear();
     notificationManagerDisplayedNotificationIds.clear();
     gDisplayStateMonitorStub->stubReset();
+    gLipstickCompositorStub->stubSetReturnValue("notificationPreviewsDisabled", uint(0));
 }
 
 void Ut_NotificationPreviewPresenter::testAddNotificationWhenWindowNotOpen()
@@ -269,6 +270,7 @@ void Ut_NotificationPreviewPresenter::testAddNotificationWhenWindowNotOpen()
 
     // Check window properties
     QCOMPARE(homeWindowTitle[homeWindows.first()], QString("Notification"));
+    QCOMPARE(homeWindowCloseEventsIgnored.value(homeWindows.first()), true);
     QCOMPARE(homeWindowContextProperties[homeWindows.first()].value("initialSize").toSize(), QGuiApplication::primaryScreen()->size());
     QCOMPARE(homeWindowContextProperties[homeWindows.first()].value("notificationPreviewPresenter"), QVariant::fromValue(static_cast<QObject *>(&presenter)));
     QCOMPARE(homeWindowContextProperties[homeWindows.first()].value("notificationFeedbackPlayer"), QVariant::fromValue(static_cast<QObject *>(presenter.m_notificationFeedbackPlayer)));
@@ -616,8 +618,9 @@ void Ut_NotificationPreviewPresenter::testNotificationPreviewsDisabled()
     QFETCH(int, urgency);
     QFETCH(int, showCount);
 
-    gLipstickCompositorStub->stubSetReturnValue("surfaceForId", surface);
-    qWaylandSurfaceWindowProperties = windowProperties;
+    // The compositor reports the default mode for windows without a surface or the property
+    const uint mode = surface ? windowProperties.value("NOTIFICATION_PREVIEWS_DISABLED", 0).toUInt() : 0;
+    gLipstickCompositorStub->stubSetReturnValue("notificationPreviewsDisabled", mode);
 
     NotificationPreviewPresenter presenter(screenLock, deviceLock);
     createNotification(1, static_cast<Urgency>(urgency));
@@ -13,6 +13,8 @@ SOURCES += \
     $$NOTIFICATIONSRCDIR/lipsticknotification.cpp \
     $$SCREENLOCKSRCDIR/screenlock.cpp \
     $$TOUCHSCREENSRCDIR/touchscreen.cpp \
+    $$SRCDIR/logging.cpp \
+    $$SRCDIR/tracing.cpp \
     $$STUBSDIR/stubbase.cpp
 
 # unit test and unit
@@ -24,7 +26,6 @@ HEADERS += \
     $$NOTIFICATIONSRCDIR/lipsticknotification.h \
     $$SCREENLOCKSRCDIR/screenlock.h \
     $$TOUCHSCREENSRCDIR/touchscreen.h \
-    $$UTILITYSRCDIR/closeeventeater.h \
     $$COMPOSITORSRCDIR/lipstickcompositor.h \
     $$DEVICESTATE/displaystate.h \
     $$SRCDIR/homewindow.h \
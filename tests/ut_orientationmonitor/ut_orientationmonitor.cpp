@@ -0,0 +1,227 @@
+/***************************************************************************
+**
+** Copyright (c) 2021 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtSensors/QOrientationSensor>
+#include <QtSensors/QSensorBackend>
+#include <QtSensors/QSensorManager>
+#include "ut_orientationmonitor.h"
+#include "orientationmonitor.h"
+
+namespace {
+
+const char *FakeBackendId = "lipstick.test.orientation";
+
+// Stands in for the sensor daemon, counting how often the sensor is started
+class FakeOrientationBackend : public QSensorBackend
+{
+public:
+    static FakeOrientationBackend *instance;
+
+    explicit FakeOrientationBackend(QSensor *sensor)
+        : QSensorBackend(sensor)
+        , starts(0)
+        , running(false)
+    {
+        setReading<QOrientationReading>(&m_reading);
+        instance = this;
+    }
+
+    ~FakeOrientationBackend()
+    {
+        if (instance == this)
+            instance = 0;
+    }
+
+    void start()
+    {
+        ++starts;
+        running = true;
+    }
+
+    void stop()
+    {
+        running = false;
+    }
+
+    // Readings are only delivered while the sensor is running
+    void report(QOrientationReading::Orientation orientation)
+    {
+        if (running) {
+            m_reading.setOrientation(orientation);
+            newReadingAvailable();
+        }
+    }
+
+    int starts;
+    bool running;
+
+private:
+    QOrientationReading m_reading;
+};
+
+FakeOrientationBackend *FakeOrientationBackend::instance = 0;
+
+class FakeOrientationBackendFactory : public QSensorBackendFactory
+{
+public:
+    QSensorBackend *createBackend(QSensor *sensor)
+    {
+        return new FakeOrientationBackend(sensor);
+    }
+};
+
+FakeOrientationBackendFactory backendFactory;
+
+const Qt::ScreenOrientations PortraitAndLandscape = Qt::PortraitOrientation | Qt::LandscapeOrientation;
+
+}
+
+void Ut_OrientationMonitor::initTestCase()
+{
+    QSensorManager::registerBackend(QOrientationSensor::type, FakeBackendId, &backendFactory);
+    QSensorManager::setDefaultBackend(QOrientationSensor::type, FakeBackendId);
+}
+
+void Ut_OrientationMonitor::init()
+{
+    QVERIFY(!FakeOrientationBackend::instance);
+}
+
+void Ut_OrientationMonitor::testSensorStoppedWhileDisplayOff()
+{
+    OrientationMonitor monitor;
+    FakeOrientationBackend *backend = FakeOrientationBackend::instance;
+    QVERIFY(backend);
+    QVERIFY(monitor.isActive());
+    QCOMPARE(backend->starts, 1);
+
+    monitor.setDisplayOn(false);
+    QVERIFY(!monitor.isActive());
+    QVERIFY(!backend->running);
+
+    monitor.setDisplayOn(true);
+    QVERIFY(backend->running);
+    QCOMPARE(backend->starts, 2);
+}
+
+void Ut_OrientationMonitor::testSensorStoppedForSingleOrientation()
+{
+    OrientationMonitor monitor;
+    FakeOrientationBackend *backend = FakeOrientationBackend::instance;
+
+    monitor.setAllowedOrientations(Qt::PortraitOrientation);
+    QVERIFY(!backend->running);
+
+    monitor.setAllowedOrientations(PortraitAndLandscape);
+    QVERIFY(backend->running);
+    QCOMPARE(backend->starts, 2);
+
+    // Changing between orientation sets that both need the sensor does not restart it
+    monitor.setAllowedOrientations(0);
+    QVERIFY(backend->running);
+    QCOMPARE(backend->starts, 2);
+
+    monitor.setDisplayOn(false);
+    monitor.setAllowedOrientations(PortraitAndLandscape);
+    QVERIFY(!backend->running);
+}
+
+void Ut_OrientationMonitor::testFirstReadingTakenIntoUseRightAway()
+{
+    OrientationMonitor monitor;
+    monitor.setSettleTime(60000);
+    FakeOrientationBackend *backend = FakeOrientationBackend::instance;
+    QSignalSpy spy(&monitor, SIGNAL(orientationChanged()));
+
+    backend->report(QOrientationReading::RightUp);
+    QCOMPARE(monitor.orientation(), Qt::LandscapeOrientation);
+    QCOMPARE(spy.count(), 1);
+
+    // The device was turned while the display was off
+    monitor.setDisplayOn(false);
+    monitor.setDisplayOn(true);
+    backend->report(QOrientationReading::TopUp);
+    QCOMPARE(monitor.orientation(), Qt::PortraitOrientation);
+    QCOMPARE(spy.count(), 2);
+}
+
+void Ut_OrientationMonitor::testNewOrientationSettles()
+{
+    OrientationMonitor monitor;
+    FakeOrientationBackend *backend = FakeOrientationBackend::instance;
+    backend->report(QOrientationReading::TopUp);
+
+    monitor.setSettleTime(50);
+    QSignalSpy spy(&monitor, SIGNAL(orientationChanged()));
+    backend->report(QOrientationReading::RightUp);
+    QCOMPARE(monitor.orientation(), Qt::PortraitOrientation);
+    QCOMPARE(spy.count(), 0);
+
+    QTRY_COMPARE(monitor.orientation(), Qt::LandscapeOrientation);
+    QCOMPARE(spy.count(), 1);
+}
+
+void Ut_OrientationMonitor::testFaceUpKeepsOrientation()
+{
+    OrientationMonitor monitor;
+    monitor.setSettleTime(0);
+    FakeOrientationBackend *backend = FakeOrientationBackend::instance;
+    backend->report(QOrientationReading::LeftUp);
+
+    QSignalSpy spy(&monitor, SIGNAL(orientationChanged()));
+    backend->report(QOrientationReading::FaceUp);
+    backend->report(QOrientationReading::FaceDown);
+    QCOMPARE(monitor.orientation(), Qt::InvertedLandscapeOrientation);
+    QCOMPARE(spy.count(), 0);
+
+    backend->report(QOrientationReading::Undefined);
+    QCOMPARE(monitor.orientation(), Qt::PrimaryOrientation);
+    QCOMPARE(spy.count(), 1);
+}
+
+void Ut_OrientationMonitor::testBorderlineReadings_data()
+{
+    QTest::addColumn<int>("settleTime");
+    QTest::addColumn<int>("flaps");
+
+    QTest::newRow("No settle time") << 0 << 6;
+    QTest::newRow("Settle time") << 100 << 0;
+}
+
+void Ut_OrientationMonitor::testBorderlineReadings()
+{
+    QFETCH(int, settleTime);
+    QFETCH(int, flaps);
+
+    OrientationMonitor monitor;
+    FakeOrientationBackend *backend = FakeOrientationBackend::instance;
+    backend->report(QOrientationReading::TopUp);
+
+    // Held at an angle where the sensor cannot decide between portrait and landscape
+    monitor.setSettleTime(settleTime);
+    QSignalSpy spy(&monitor, SIGNAL(orientationChanged()));
+    for (int i = 0; i < 3; ++i) {
+        backend->report(QOrientationReading::RightUp);
+        QTest::qWait(settleTime / 4);
+        backend->report(QOrientationReading::TopUp);
+        QTest::qWait(settleTime / 4);
+    }
+    QTest::qWait(settleTime * 2);
+
+    QCOMPARE(spy.count(), flaps);
+    QCOMPARE(monitor.orientation(), Qt::PortraitOrientation);
+}
+
+QTEST_MAIN(Ut_OrientationMonitor)
@@ -0,0 +1,37 @@
+/***************************************************************************
+**
+** Copyright (c) 2021 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+#ifndef UT_ORIENTATIONMONITOR_H
+#define UT_ORIENTATIONMONITOR_H
+
+#include <QObject>
+
+class Ut_OrientationMonitor : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void init();
+
+    // Test cases
+    void testSensorStoppedWhileDisplayOff();
+    void testSensorStoppedForSingleOrientation();
+    void testFirstReadingTakenIntoUseRightAway();
+    void testNewOrientationSettles();
+    void testFaceUpKeepsOrientation();
+    void testBorderlineReadings_data();
+    void testBorderlineReadings();
+};
+
+#endif
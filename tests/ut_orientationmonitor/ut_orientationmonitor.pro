@@ -0,0 +1,14 @@
+include(../common.pri)
+TARGET = ut_orientationmonitor
+INCLUDEPATH += $$COMPOSITORSRCDIR
+QT += sensors
+
+# unit test and unit
+SOURCES += \
+    ut_orientationmonitor.cpp \
+    $$COMPOSITORSRCDIR/orientationmonitor.cpp
+
+# unit test and unit
+HEADERS += \
+    ut_orientationmonitor.h \
+    $$COMPOSITORSRCDIR/orientationmonitor.h
@@ -0,0 +1,305 @@
+/***************************************************************************
+**
+** Copyright (c) 2021 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <signal.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "ut_processterminator.h"
+#include "processterminator.h"
+
+#ifndef SYS_pidfd_open
+#define SYS_pidfd_open 434
+#endif
+
+void Ut_ProcessTerminator::initTestCase()
+{
+    const int pidfd = ::syscall(SYS_pidfd_open, ::getpid(), 0);
+    if (pidfd < 0)
+        QSKIP("The kernel does not support pidfds");
+    ::close(pidfd);
+}
+
+void Ut_ProcessTerminator::cleanup()
+{
+    foreach (pid_t pid, m_children) {
+        ::kill(pid, SIGKILL);
+        ::waitpid(pid, 0, 0);
+    }
+    m_children.clear();
+}
+
+pid_t Ut_ProcessTerminator::startChild(bool ignoreTerm)
+{
+    // The child inherits the ignored SIGTERM, so there is no window where it could still be terminated
+    struct sigaction action;
+    struct sigaction oldAction;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = ignoreTerm ? SIG_IGN : SIG_DFL;
+    ::sigaction(SIGTERM, &action, &oldAction);
+
+    const pid_t pid = ::fork();
+    if (pid == 0) {
+        for (;;)
+            ::pause();
+    }
+
+    ::sigaction(SIGTERM, &oldAction, 0);
+    if (pid > 0)
+        m_children.append(pid);
+    return pid;
+}
+
+int Ut_ProcessTerminator::openFileCount()
+{
+    return QDir(QStringLiteral("/proc/self/fd")).entryList(QDir::AllEntries | QDir::System | QDir::NoDotAndDotDot).count();
+}
+
+void Ut_ProcessTerminator::testTerminatedProcessExits()
+{
+    ProcessTerminator terminator;
+    QSignalSpy spy(&terminator, SIGNAL(processExited(qint64, qint64, bool)));
+
+    const pid_t pid = startChild(false);
+    QVERIFY(pid > 0);
+    terminator.terminate(pid, 10000);
+    QVERIFY(terminator.isTerminating(pid));
+
+    QTRY_COMPARE(spy.count(), 1);
+    QCOMPARE(spy.at(0).at(0).toLongLong(), qint64(pid));
+    QVERIFY(spy.at(0).at(1).toLongLong() < 10000);
+    QCOMPARE(spy.at(0).at(2).toBool(), false);
+    QVERIFY(!terminator.isTerminating(pid));
+
+    int status = 0;
+    QCOMPARE(::waitpid(pid, &status, 0), pid);
+    QVERIFY(WIFSIGNALED(status));
+    QCOMPARE(WTERMSIG(status), SIGTERM);
+    m_children.removeOne(pid);
+}
+
+void Ut_ProcessTerminator::testUnresponsiveProcessIsKilled()
+{
+    ProcessTerminator terminator;
+    QSignalSpy spy(&terminator, SIGNAL(processExited(qint64, qint64, bool)));
+
+    const pid_t pid = startChild(true);
+    QVERIFY(pid > 0);
+    terminator.terminate(pid, 100);
+
+    QTRY_COMPARE(spy.count(), 1);
+    QVERIFY(spy.at(0).at(1).toLongLong() >= 100);
+    QCOMPARE(spy.at(0).at(2).toBool(), true);
+
+    int status = 0;
+    QCOMPARE(::waitpid(pid, &status, 0), pid);
+    QVERIFY(WIFSIGNALED(status));
+    QCOMPARE(WTERMSIG(status), SIGKILL);
+    m_children.removeOne(pid);
+}
+
+void Ut_ProcessTerminator::testTerminatingAgainKeepsEarlierDeadline()
+{
+    ProcessTerminator terminator;
+    QSignalSpy spy(&terminator, SIGNAL(processExited(qint64, qint64, bool)));
+
+    const pid_t pid = startChild(true);
+    QVERIFY(pid > 0);
+    terminator.terminate(pid, 60000);
+    terminator.terminate(pid, 100);
+    terminator.terminate(pid, 60000);
+
+    QTRY_COMPARE(spy.count(), 1);
+    QCOMPARE(spy.at(0).at(2).toBool(), true);
+}
+
+void Ut_ProcessTerminator::testCloseAll()
+{
+    ProcessTerminator terminator;
+    QSignalSpy spy(&terminator, SIGNAL(processExited(qint64, qint64, bool)));
+
+    // Every other application ignores SIGTERM
+    QList<pid_t> pids;
+    for (int i = 0; i < 20; ++i) {
+        const pid_t pid = startChild(i % 2);
+        QVERIFY(pid > 0);
+        pids.append(pid);
+    }
+
+    foreach (pid_t pid, pids)
+        terminator.terminate(pid, 200);
+
+    QTRY_COMPARE(spy.count(), pids.count());
+
+    int killed = 0;
+    qint64 timeToExit = 0;
+    for (int i = 0; i < spy.count(); ++i) {
+        QVERIFY(pids.contains(pid_t(spy.at(i).at(0).toLongLong())));
+        timeToExit = qMax(timeToExit, spy.at(i).at(1).toLongLong());
+        if (spy.at(i).at(2).toBool())
+            ++killed;
+    }
+    QCOMPARE(killed, pids.count() / 2);
+
+    // The time from SIGTERM until the last application has exited, as reported by the terminator
+    QTest::setBenchmarkResult(timeToExit, QTest::WalltimeMilliseconds);
+}
+
+void Ut_ProcessTerminator::testWatchedProcessIsTerminated()
+{
+    ProcessTerminator terminator;
+    QSignalSpy spy(&terminator, SIGNAL(processExited(qint64, qint64, bool)));
+
+    const pid_t pid = startChild(false);
+    QVERIFY(pid > 0);
+    terminator.watch(pid);
+    QVERIFY(!terminator.isTerminating(pid));
+
+    terminator.terminate(pid, 10000);
+    QVERIFY(terminator.isTerminating(pid));
+    QTRY_COMPARE(spy.count(), 1);
+    QCOMPARE(spy.at(0).at(2).toBool(), false);
+    QVERIFY(!terminator.isTerminating(pid));
+
+    int status = 0;
+    QCOMPARE(::waitpid(pid, &status, 0), pid);
+    QCOMPARE(WTERMSIG(status), SIGTERM);
+    m_children.removeOne(pid);
+
+    // The window goes away after its process
+    terminator.cancel(pid, 0);
+    QVERIFY(!terminator.isTerminating(pid));
+}
+
+void Ut_ProcessTerminator::testCancelledProcessIsNotKilled()
+{
+    ProcessTerminator terminator;
+    QSignalSpy spy(&terminator, SIGNAL(processExited(qint64, qint64, bool)));
+
+    const pid_t pid = startChild(true);
+    QVERIFY(pid > 0);
+    QObject window;
+    terminator.watch(pid);
+    terminator.terminate(pid, 100, &window);
+
+    // The window went away before the kill timeout ran out
+    terminator.cancel(pid, &window);
+    QVERIFY(!terminator.isTerminating(pid));
+
+    QTest::qWait(300);
+    QCOMPARE(spy.count(), 0);
+    QCOMPARE(::waitpid(pid, 0, WNOHANG), pid_t(0));
+}
+
+void Ut_ProcessTerminator::testOtherWindowDoesNotCancelKill()
+{
+    ProcessTerminator terminator;
+    QSignalSpy spy(&terminator, SIGNAL(processExited(qint64, qint64, bool)));
+
+    const pid_t pid = startChild(true);
+    QVERIFY(pid > 0);
+    QObject window;
+    QObject cover;
+    terminator.watch(pid);
+    terminator.watch(pid);
+    terminator.terminate(pid, 100, &window);
+
+    // The cover is torn down while the closed window of the hung process remains
+    terminator.cancel(pid, &cover);
+    QVERIFY(terminator.isTerminating(pid));
+
+    QTRY_COMPARE(spy.count(), 1);
+    QCOMPARE(spy.at(0).at(2).toBool(), true);
+
+    int status = 0;
+    QCOMPARE(::waitpid(pid, &status, 0), pid);
+    QCOMPARE(WTERMSIG(status), SIGKILL);
+    m_children.removeOne(pid);
+
+    terminator.cancel(pid, &window);
+}
+
+void Ut_ProcessTerminator::testClosedWindowCancelsKill()
+{
+    ProcessTerminator terminator;
+    QSignalSpy spy(&terminator, SIGNAL(processExited(qint64, qint64, bool)));
+
+    const pid_t pid = startChild(true);
+    QVERIFY(pid > 0);
+    QObject window;
+    QObject cover;
+    terminator.watch(pid);
+    terminator.watch(pid);
+    terminator.terminate(pid, 100, &window);
+
+    // As with a timer of its own, the closed window takes the pending kill with it
+    terminator.cancel(pid, &window);
+    QVERIFY(!terminator.isTerminating(pid));
+
+    QTest::qWait(300);
+    QCOMPARE(spy.count(), 0);
+    QCOMPARE(::waitpid(pid, 0, WNOHANG), pid_t(0));
+
+    terminator.cancel(pid, &cover);
+}
+
+void Ut_ProcessTerminator::testExitedWatchedProcessIsNotSignalled()
+{
+    ProcessTerminator terminator;
+    QSignalSpy spy(&terminator, SIGNAL(processExited(qint64, qint64, bool)));
+
+    const pid_t pid = startChild(false);
+    QVERIFY(pid > 0);
+    terminator.watch(pid);
+
+    // Once reaped the pid is free for another process, the pidfd still refers to the old one
+    ::kill(pid, SIGKILL);
+    QCOMPARE(::waitpid(pid, 0, 0), pid);
+    m_children.removeOne(pid);
+
+    terminator.terminate(pid, 100);
+    QVERIFY(!terminator.isTerminating(pid));
+    QTest::qWait(200);
+    QCOMPARE(spy.count(), 0);
+
+    terminator.cancel(pid, 0);
+}
+
+void Ut_ProcessTerminator::testPidfdClosedWithLastWindow()
+{
+    ProcessTerminator terminator;
+
+    const pid_t pid = startChild(false);
+    QVERIFY(pid > 0);
+    const int files = openFileCount();
+
+    // Both windows of the process share the pidfd
+    terminator.watch(pid);
+    terminator.watch(pid);
+    QCOMPARE(openFileCount(), files + 1);
+
+    terminator.cancel(pid, 0);
+    QCOMPARE(openFileCount(), files + 1);
+    terminator.cancel(pid, 0);
+    QCOMPARE(openFileCount(), files);
+
+    // Cancelling windows that are no longer watched does nothing
+    terminator.cancel(pid, 0);
+    terminator.cancel(0, 0);
+    QCOMPARE(openFileCount(), files);
+}
+
+QTEST_MAIN(Ut_ProcessTerminator)
@@ -0,0 +1,49 @@
+/***************************************************************************
+**
+** Copyright (c) 2021 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#ifndef UT_PROCESSTERMINATOR_H
+#define UT_PROCESSTERMINATOR_H
+
+#include <QList>
+#include <QObject>
+#include <sys/types.h>
+
+class Ut_ProcessTerminator : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanup();
+
+    // Test cases
+    void testTerminatedProcessExits();
+    void testUnresponsiveProcessIsKilled();
+    void testTerminatingAgainKeepsEarlierDeadline();
+    void testCloseAll();
+    void testWatchedProcessIsTerminated();
+    void testCancelledProcessIsNotKilled();
+    void testOtherWindowDoesNotCancelKill();
+    void testClosedWindowCancelsKill();
+    void testExitedWatchedProcessIsNotSignalled();
+    void testPidfdClosedWithLastWindow();
+
+private:
+    pid_t startChild(bool ignoreTerm);
+    static int openFileCount();
+
+    QList<pid_t> m_children;
+};
+
+#endif
@@ -0,0 +1,14 @@
+include(../common.pri)
+TARGET = ut_processterminator
+INCLUDEPATH += $$COMPOSITORSRCDIR
+
+# unit test and unit
+SOURCES += \
+    ut_processterminator.cpp \
+    $$COMPOSITORSRCDIR/processterminator.cpp \
+    $$SRCDIR/logging.cpp
+
+# unit test and unit
+HEADERS += \
+    ut_processterminator.h \
+    $$COMPOSITORSRCDIR/processterminator.h
@@ -27,22 +27,11 @@
 #include "screenlock.h"
 #include "touchscreen/touchscreen.h"
 #include "homeapplication.h"
-#include "closeeventeater_stub.h"
 #include "displaystate_stub.h"
 #include "lipsticktest.h"
 
 TouchScreen *gTouchScreen = 0;
 
-void QTimer::singleShot(int, const QObject *receiver, const char *member)
-{
-    // The "member" string is of form "1member()", so remove the trailing 1 and the ()
-    int memberLength = strlen(member) - 3;
-    char modifiedMember[memberLength + 1];
-    strncpy(modifiedMember, member + 1, memberLength);
-    modifiedMember[memberLength] = 0;
-    QMetaObject::invokeMethod(const_cast<QObject *>(receiver), modifiedMember, Qt::DirectConnection);
-}
-
 HomeApplication::~HomeApplication()
 {
 }
@@ -189,6 +178,26 @@ void Ut_ScreenLock::testTkLockOpen()
     }
 }
 
+void Ut_ScreenLock::testRepeatedTkLockOpen()
+{
+    fakeDisplayOnAndReady();
+
+    QSignalSpy spy(screenLock, SIGNAL(screenLockedChanged(bool)));
+    screenLock->tklock_open(TEST_SERVICE, TEST_PATH, TEST_INTERFACE, TEST_METHOD, ScreenLock::TkLockModeEnable, false, false);
+    screenLock->tklock_open(TEST_SERVICE, TEST_PATH, TEST_INTERFACE, TEST_METHOD, ScreenLock::TkLockEnableVisual, false, false);
+    screenLock->tklock_open(TEST_SERVICE, TEST_PATH, TEST_INTERFACE, TEST_METHOD, ScreenLock::TkLockEnableLowPowerMode, false, false);
+
+    // The screen lock is shown without returning to the event loop, and only once
+    QCOMPARE(spy.count(), 1);
+    QCOMPARE(spy.last().at(0).toBool(), true);
+    QCOMPARE(screenLock->isScreenLocked(), true);
+
+    screenLock->tklock_close(false);
+    screenLock->tklock_close(false);
+    QCOMPARE(spy.count(), 2);
+    QCOMPARE(spy.last().at(0).toBool(), false);
+}
+
 void Ut_ScreenLock::testTkLockClose()
 {
     // Show the screen lock window and the event eater
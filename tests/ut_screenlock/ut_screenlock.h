@@ -38,6 +38,7 @@ private slots:
     void testUnlockScreenWhenNotLocked();
     void testTkLockOpen_data();
     void testTkLockOpen();
+    void testRepeatedTkLockOpen();
     void testTkLockClose();
 
 private:
@@ -8,11 +8,12 @@ SOURCES += ut_screenlock.cpp \
     $$SCREENLOCKSRCDIR/screenlock.cpp \
     $$TOUCHSCREENSRCDIR/touchscreen.cpp \
     $$STUBSDIR/homeapplication.cpp \
+    $$SRCDIR/logging.cpp \
+    $$SRCDIR/tracing.cpp \
     $$STUBSDIR/stubbase.cpp
 
 HEADERS += ut_screenlock.h \
     $$SCREENLOCKSRCDIR/screenlock.h \
     $$TOUCHSCREENSRCDIR/touchscreen.h \
     $$DEVICESTATE/displaystate.h \
-    $$SRCDIR/homeapplication.h \
-    $$UTILITYSRCDIR/closeeventeater.h
+    $$SRCDIR/homeapplication.h
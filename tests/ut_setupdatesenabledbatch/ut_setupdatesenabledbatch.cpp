@@ -0,0 +1,122 @@
+/***************************************************************************
+**
+** Copyright (c) 2021 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QDBusError>
+#include "setupdatesenabledbatch.h"
+#include "ut_setupdatesenabledbatch.h"
+
+namespace {
+
+const QString Mce = QStringLiteral(":1.10");
+const QString Other = QStringLiteral(":1.20");
+
+QueuedSetUpdatesEnabledCall call(const QString &caller, bool enable, int serial = 0)
+{
+    // The service of a method call made here is its destination, which stands in for the sender
+    QDBusMessage message = QDBusMessage::createMethodCall(caller, "/", "org.nemomobile.compositor", "setUpdatesEnabled");
+    message << enable << serial;
+    return QueuedSetUpdatesEnabledCall(QDBusConnection(QStringLiteral("ut_setupdatesenabledbatch")), message, enable);
+}
+
+QList<QueuedSetUpdatesEnabledCall> calls(const QString &caller, const QString &states)
+{
+    QList<QueuedSetUpdatesEnabledCall> calls;
+    for (int i = 0; i < states.length(); ++i)
+        calls.append(call(caller, states.at(i) == QLatin1Char('1'), i));
+    return calls;
+}
+
+int serial(const QueuedSetUpdatesEnabledCall &call)
+{
+    return call.m_message.arguments().at(1).toInt();
+}
+
+}
+
+void Ut_SetUpdatesEnabledBatch::testCollapse_data()
+{
+    // The states asked for by mce in the order of the calls, 1 for on and 0 for off
+    QTest::addColumn<QString>("states");
+    QTest::addColumn<bool>("enable");
+
+    QTest::newRow("off") << "0" << false;
+    QTest::newRow("on") << "1" << true;
+    QTest::newRow("off, on") << "01" << true;
+    QTest::newRow("on, off") << "10" << false;
+    QTest::newRow("off, on, off") << "010" << false;
+    QTest::newRow("on, off, on, off, on") << "10101" << true;
+    QTest::newRow("off, off, on, on") << "0011" << true;
+}
+
+void Ut_SetUpdatesEnabledBatch::testCollapse()
+{
+    QFETCH(QString, states);
+    QFETCH(bool, enable);
+
+    const SetUpdatesEnabledBatch batch = SetUpdatesEnabledBatch::collapse(calls(Mce, states), Mce);
+    QCOMPARE(batch.enable, enable);
+    QCOMPARE(batch.accepted.count(), states.length());
+    QVERIFY(batch.denied.isEmpty());
+}
+
+void Ut_SetUpdatesEnabledBatch::testRepliesInCallOrder()
+{
+    QList<QueuedSetUpdatesEnabledCall> queued;
+    queued << call(Mce, false, 0) << call(Other, true, 1) << call(Mce, true, 2)
+           << call(Other, false, 3) << call(Mce, false, 4);
+
+    const SetUpdatesEnabledBatch batch = SetUpdatesEnabledBatch::collapse(queued, Mce);
+    QCOMPARE(batch.enable, false);
+
+    QCOMPARE(batch.accepted.count(), 3);
+    QCOMPARE(serial(batch.accepted.at(0)), 0);
+    QCOMPARE(serial(batch.accepted.at(1)), 2);
+    QCOMPARE(serial(batch.accepted.at(2)), 4);
+
+    QCOMPARE(batch.denied.count(), 2);
+    QCOMPARE(serial(batch.denied.at(0)), 1);
+    QCOMPARE(serial(batch.denied.at(1)), 3);
+}
+
+void Ut_SetUpdatesEnabledBatch::testDeniedCaller()
+{
+    // The other caller does not change the state mce asked for
+    QList<QueuedSetUpdatesEnabledCall> queued;
+    queued << call(Mce, true) << call(Other, false);
+
+    const SetUpdatesEnabledBatch batch = SetUpdatesEnabledBatch::collapse(queued, Mce);
+    QCOMPARE(batch.enable, true);
+    QCOMPARE(batch.accepted.count(), 1);
+    QCOMPARE(batch.denied.count(), 1);
+
+    const QDBusMessage reply = SetUpdatesEnabledBatch::deniedReply(batch.denied.first().m_message);
+    QCOMPARE(reply.type(), QDBusMessage::ErrorMessage);
+    QCOMPARE(reply.errorName(), QDBusError::errorString(QDBusError::AccessDenied));
+
+    // Only denied callers
+    const SetUpdatesEnabledBatch deniedBatch = SetUpdatesEnabledBatch::collapse(calls(Other, "10"), Mce);
+    QVERIFY(deniedBatch.accepted.isEmpty());
+    QCOMPARE(deniedBatch.denied.count(), 2);
+}
+
+void Ut_SetUpdatesEnabledBatch::testUnknownMceNameOwner()
+{
+    // Nobody is mce before the name owner is known
+    const SetUpdatesEnabledBatch batch = SetUpdatesEnabledBatch::collapse(calls(Mce, "01"), QString());
+    QVERIFY(batch.accepted.isEmpty());
+    QCOMPARE(batch.denied.count(), 2);
+}
+
+QTEST_MAIN(Ut_SetUpdatesEnabledBatch)
@@ -0,0 +1,14 @@
+include(../common.pri)
+TARGET = ut_setupdatesenabledbatch
+INCLUDEPATH += $$COMPOSITORSRCDIR
+QT += dbus
+
+# unit test and unit
+SOURCES += \
+    ut_setupdatesenabledbatch.cpp \
+    $$COMPOSITORSRCDIR/setupdatesenabledbatch.cpp
+
+# unit test and unit
+HEADERS += \
+    ut_setupdatesenabledbatch.h \
+    $$COMPOSITORSRCDIR/setupdatesenabledbatch.h
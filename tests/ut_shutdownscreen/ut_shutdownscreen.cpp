@@ -22,7 +22,6 @@
 #include "ut_shutdownscreen.h"
 #include "notificationmanager_stub.h"
 #include "lipsticknotification.h"
-#include "closeeventeater_stub.h"
 #include "lipstickqmlpath_stub.h"
 
 QList<QQuickView *> qQuickViews;
@@ -72,7 +71,7 @@ void Ut_ShutdownScreen::init()
     shutdownScreen = new ShutdownScreen;
 
     gNotificationManagerStub->stubReset();
-    gNotificationManagerStub->stubSetReturnValue("Notify", (uint)1);
+    gNotificationManagerStub->stubSetReturnValue("publishSystemNotification", (uint)1);
 }
 
 void Ut_ShutdownScreen::cleanup()
@@ -93,21 +92,21 @@ void Ut_ShutdownScreen::testSystemState()
     QSignalSpy spy(shutdownScreen, SIGNAL(windowVisibleChanged()));
     shutdownScreen->applySystemState(DeviceState::DeviceState::ThermalStateFatal);
     QCOMPARE(qQuickViews.count(), 0);
-    QCOMPARE(gNotificationManagerStub->stubCallCount("Notify"), 1);
-    QCOMPARE(gNotificationManagerStub->stubLastCallTo("Notify").parameter<QString>(4), qtTrId("qtn_shut_high_temp"));
-    QCOMPARE(gNotificationManagerStub->stubLastCallTo("Notify").parameter<QString>(2), QString("icon-system-warning"));
+    QCOMPARE(gNotificationManagerStub->stubCallCount("publishSystemNotification"), 1);
+    QCOMPARE(gNotificationManagerStub->stubLastCallTo("publishSystemNotification").parameter<SystemNotification>(0).body(), qtTrId("qtn_shut_high_temp"));
+    QCOMPARE(gNotificationManagerStub->stubLastCallTo("publishSystemNotification").parameter<SystemNotification>(0).icon(), QString("icon-system-warning"));
 
     shutdownScreen->applySystemState(DeviceState::DeviceState::ShutdownDeniedUSB);
     QCOMPARE(qQuickViews.count(), 0);
-    QCOMPARE(gNotificationManagerStub->stubCallCount("Notify"), 2);
-    QCOMPARE(gNotificationManagerStub->stubLastCallTo("Notify").parameter<QString>(4), qtTrId("qtn_shut_unplug_usb"));
-    QCOMPARE(gNotificationManagerStub->stubLastCallTo("Notify").parameter<QString>(2), QString("icon-system-usb"));
+    QCOMPARE(gNotificationManagerStub->stubCallCount("publishSystemNotification"), 2);
+    QCOMPARE(gNotificationManagerStub->stubLastCallTo("publishSystemNotification").parameter<SystemNotification>(0).body(), qtTrId("qtn_shut_unplug_usb"));
+    QCOMPARE(gNotificationManagerStub->stubLastCallTo("publishSystemNotification").parameter<SystemNotification>(0).icon(), QString("icon-system-usb"));
 
     shutdownScreen->applySystemState(DeviceState::DeviceState::BatteryStateEmpty);
     QCOMPARE(qQuickViews.count(), 0);
-    QCOMPARE(gNotificationManagerStub->stubCallCount("Notify"), 3);
-    QCOMPARE(gNotificationManagerStub->stubLastCallTo("Notify").parameter<QString>(4), qtTrId("qtn_shut_batt_empty"));
-    QCOMPARE(gNotificationManagerStub->stubLastCallTo("Notify").parameter<QString>(2), QString("icon-system-battery"));
+    QCOMPARE(gNotificationManagerStub->stubCallCount("publishSystemNotification"), 3);
+    QCOMPARE(gNotificationManagerStub->stubLastCallTo("publishSystemNotification").parameter<SystemNotification>(0).body(), qtTrId("qtn_shut_batt_empty"));
+    QCOMPARE(gNotificationManagerStub->stubLastCallTo("publishSystemNotification").parameter<SystemNotification>(0).icon(), QString("icon-system-battery"));
 
     shutdownScreen->applySystemState(DeviceState::DeviceState::Shutdown);
     QCOMPARE(qQuickViews.count(), 1);
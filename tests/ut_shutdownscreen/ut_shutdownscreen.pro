@@ -18,6 +18,9 @@ SOURCES += \
     $$DEVICESTATE/displaystate.cpp \
     $$DEVICESTATE/thermal.cpp \
     $$DEVICESTATE/ipcinterface.cpp \
+    $$DEVICESTATE/statesnapshot.cpp \
+    $$UTILITYSRCDIR/callercredentials.cpp \
+    $$SRCDIR/logging.cpp \
     ut_shutdownscreen.cpp
 
 HEADERS += \
@@ -25,7 +28,6 @@ HEADERS += \
     $$NOTIFICATIONSRCDIR/notificationmanager.h \
     $$NOTIFICATIONSRCDIR/lipsticknotification.h \
     $$NOTIFICATIONSRCDIR/thermalnotifier.h \
-    $$UTILITYSRCDIR/closeeventeater.h \
     $$SRCDIR/homeapplication.h \
     $$SRCDIR/homewindow.h \
     $$DEVICESTATE/devicestate.h \
@@ -35,5 +37,7 @@ HEADERS += \
     $$DEVICESTATE/thermal.h \
     $$DEVICESTATE/thermal_p.h \
     $$DEVICESTATE/ipcinterface_p.h \
+    $$DEVICESTATE/statesnapshot_p.h \
+    $$UTILITYSRCDIR/callercredentials.h \
     $$STUBSDIR/nemo-devicelock/devicelock.h \
     ut_shutdownscreen.h
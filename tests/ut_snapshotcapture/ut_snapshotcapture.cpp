@@ -0,0 +1,223 @@
+/***************************************************************************
+**
+** Copyright (c) 2021 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QColor>
+#include <QOpenGLContext>
+#include <QOpenGLFramebufferObject>
+#include <QOpenGLFunctions>
+#include <QQuickRenderControl>
+#include <QQuickWindow>
+#include <QSGTexture>
+#include "ut_snapshotcapture.h"
+#include "snapshotcapture.h"
+#include "snapshotstore.h"
+
+namespace {
+
+enum Variant {
+    Batched,
+    Inline
+};
+
+}
+
+void Ut_SnapshotCapture::initTestCase()
+{
+    if (!m_fixture.create())
+        QSKIP("Snapshots need an OpenGL context, which is not available");
+
+    SnapshotStore::instance()->setBudget(1024 * 1024 * 1024);
+}
+
+void Ut_SnapshotCapture::cleanup()
+{
+    qDeleteAll(m_snapshots);
+    m_snapshots.clear();
+    qDeleteAll(m_sources);
+    m_sources.clear();
+    qDeleteAll(m_sourceFbos);
+    m_sourceFbos.clear();
+}
+
+QSGTexture *Ut_SnapshotCapture::createSource(const QColor &color)
+{
+    // Stands for the texture of a window that has just been unmapped
+    QOpenGLFramebufferObject *fbo = m_fixture.createFramebuffer(color);
+    m_sourceFbos.append(fbo);
+
+    QSGTexture *texture = m_fixture.window()->createTextureFromId(fbo->texture(), SnapshotSize, 0);
+    m_sources.append(texture);
+    return texture;
+}
+
+SnapshotTextureProvider *Ut_SnapshotCapture::createSnapshot()
+{
+    SnapshotTextureProvider *snapshot = new SnapshotTextureProvider;
+    m_snapshots.append(snapshot);
+    return snapshot;
+}
+
+void Ut_SnapshotCapture::renderFrame()
+{
+    QQuickRenderControl *renderControl = m_fixture.renderControl();
+    renderControl->polishItems();
+    renderControl->sync();
+    renderControl->render();
+}
+
+void Ut_SnapshotCapture::testCaptureRendersBeforeFrame()
+{
+    SnapshotCapture *capture = SnapshotCapture::instance(m_fixture.window());
+    QCOMPARE(SnapshotCapture::instance(m_fixture.window()), capture);
+
+    SnapshotTextureProvider *snapshot = createSnapshot();
+    QSignalSpy spy(snapshot, SIGNAL(textureChanged()));
+
+    // Nothing is rendered while the scene graph is synchronized
+    capture->capture(snapshot, createSource(Qt::red), SnapshotSize);
+    QVERIFY(!snapshot->texture());
+    QVERIFY(!capture->takeCaptured(snapshot));
+
+    renderFrame();
+    QCOMPARE(spy.count(), 1);
+    QVERIFY(snapshot->texture());
+    QCOMPARE(snapshot->texture()->textureSize(), SnapshotSize);
+    QCOMPARE(snapshot->fbo->toImage().pixel(SnapshotSize.width() / 2, SnapshotSize.height() / 2), QColor(Qt::red).rgba());
+
+    QVERIFY(capture->takeCaptured(snapshot));
+    QVERIFY(!capture->takeCaptured(snapshot));
+}
+
+void Ut_SnapshotCapture::testPreviousSnapshotShownUntilCaptured()
+{
+    SnapshotCapture *capture = SnapshotCapture::instance(m_fixture.window());
+    SnapshotTextureProvider *snapshot = createSnapshot();
+    capture->capture(snapshot, createSource(Qt::red), SnapshotSize);
+    renderFrame();
+    QSGTexture *previous = snapshot->texture();
+
+    // A window resized before it was closed again
+    const QSize size(SnapshotSize.height(), SnapshotSize.width());
+    capture->capture(snapshot, createSource(Qt::blue), size);
+    QCOMPARE(snapshot->texture(), previous);
+    QCOMPARE(snapshot->texture()->textureSize(), SnapshotSize);
+
+    renderFrame();
+    QCOMPARE(snapshot->texture()->textureSize(), size);
+    QCOMPARE(snapshot->fbo->toImage().pixel(size.width() / 2, size.height() / 2), QColor(Qt::blue).rgba());
+}
+
+void Ut_SnapshotCapture::testCapturesBatched()
+{
+    SnapshotCapture *capture = SnapshotCapture::instance(m_fixture.window());
+    QSignalSpy spy(capture, SIGNAL(captured()));
+
+    for (int i = 0; i < 3; ++i)
+        capture->capture(createSnapshot(), createSource(Qt::green), SnapshotSize);
+
+    renderFrame();
+    QCOMPARE(spy.count(), 1);
+    foreach (SnapshotTextureProvider *snapshot, m_snapshots)
+        QVERIFY(capture->takeCaptured(snapshot));
+
+    // No job without new requests
+    renderFrame();
+    QCOMPARE(spy.count(), 1);
+}
+
+void Ut_SnapshotCapture::testDestroyedSnapshotDropped()
+{
+    SnapshotCapture *capture = SnapshotCapture::instance(m_fixture.window());
+    QSignalSpy spy(capture, SIGNAL(captured()));
+
+    SnapshotTextureProvider *snapshot = new SnapshotTextureProvider;
+    capture->capture(snapshot, createSource(Qt::yellow), SnapshotSize);
+    delete snapshot;
+
+    renderFrame();
+    QCOMPARE(spy.count(), 0);
+}
+
+void Ut_SnapshotCapture::testInvalidateDropsRequests()
+{
+    SnapshotCapture *capture = SnapshotCapture::instance(m_fixture.window());
+    QSignalSpy spy(capture, SIGNAL(captured()));
+
+    // The scene graph is torn down before the render job has run, the job goes with it
+    SnapshotTextureProvider *snapshot = createSnapshot();
+    capture->capture(snapshot, createSource(Qt::red), SnapshotSize);
+    capture->invalidate();
+    QVERIFY(capture->m_requests.isEmpty());
+    QVERIFY(!capture->m_jobScheduled);
+
+    renderFrame();
+    QCOMPARE(spy.count(), 0);
+    QVERIFY(!snapshot->texture());
+
+    // A new request schedules a new job
+    capture->capture(snapshot, createSource(Qt::blue), SnapshotSize);
+    renderFrame();
+    QCOMPARE(spy.count(), 1);
+    QVERIFY(capture->takeCaptured(snapshot));
+}
+
+void Ut_SnapshotCapture::benchmarkMassClose_data()
+{
+    // Inline is the baseline of rendering each snapshot during the sync, as before the render job
+    SnapshotTestFixture::addBenchmarkRows("windows", QStringList() << "sync time" << "render time",
+                                          QStringList() << "batched" << "inline");
+}
+
+void Ut_SnapshotCapture::benchmarkMassClose()
+{
+    QFETCH(int, count);
+    QFETCH(int, variant);
+    QFETCH(int, metric);
+
+    SnapshotCapture *capture = SnapshotCapture::instance(m_fixture.window());
+    QQuickRenderControl *renderControl = m_fixture.renderControl();
+    QOpenGLFunctions *functions = m_fixture.context()->functions();
+    QList<QSGTexture *> sources;
+    for (int i = 0; i < count; ++i)
+        sources.append(createSource(QColor::fromHsv(i * 36, 255, 255)));
+    functions->glFinish();
+
+    // The windows are closed together, so their snapshots are requested during the same synchronization
+    renderControl->polishItems();
+    QElapsedTimer timer;
+    timer.start();
+    renderControl->sync();
+    foreach (QSGTexture *source, sources) {
+        capture->capture(createSnapshot(), source, SnapshotSize);
+        if (variant == Inline)
+            capture->render();
+    }
+    const qint64 syncTime = timer.nsecsElapsed();
+
+    // The GUI thread is no longer blocked while the snapshots are rendered
+    timer.start();
+    renderControl->render();
+    functions->glFinish();
+    const qint64 renderTime = timer.nsecsElapsed();
+
+    foreach (SnapshotTextureProvider *snapshot, m_snapshots)
+        QVERIFY(capture->takeCaptured(snapshot));
+
+    SnapshotTestFixture::setBenchmarkResult(metric, QVector<SnapshotTestFixture::BenchmarkResult>()
+            << qMakePair(syncTime / 1000000.0, QTest::WalltimeMilliseconds)
+            << qMakePair(renderTime / 1000000.0, QTest::WalltimeMilliseconds));
+}
+
+QTEST_MAIN(Ut_SnapshotCapture)
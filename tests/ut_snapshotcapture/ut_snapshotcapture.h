@@ -0,0 +1,57 @@
+/***************************************************************************
+**
+** Copyright (c) 2021 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#ifndef UT_SNAPSHOTCAPTURE_H
+#define UT_SNAPSHOTCAPTURE_H
+
+#include <QObject>
+#include <QList>
+#include "snapshottestfixture.h"
+
+class QColor;
+class QOpenGLFramebufferObject;
+class QSGTexture;
+class SnapshotTextureProvider;
+
+class Ut_SnapshotCapture : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanup();
+
+    // Test cases
+    void testCaptureRendersBeforeFrame();
+    void testPreviousSnapshotShownUntilCaptured();
+    void testCapturesBatched();
+    void testDestroyedSnapshotDropped();
+    void testInvalidateDropsRequests();
+
+    // Benchmarks of many windows closing at once
+    void benchmarkMassClose_data();
+    void benchmarkMassClose();
+
+private:
+    QSGTexture *createSource(const QColor &color);
+    SnapshotTextureProvider *createSnapshot();
+    void renderFrame();
+
+    SnapshotTestFixture m_fixture;
+    QList<QOpenGLFramebufferObject *> m_sourceFbos;
+    QList<QSGTexture *> m_sources;
+    QList<SnapshotTextureProvider *> m_snapshots;
+};
+
+#endif
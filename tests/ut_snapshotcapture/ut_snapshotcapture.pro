@@ -0,0 +1,20 @@
+include(../common.pri)
+TARGET = ut_snapshotcapture
+INCLUDEPATH += $$COMPOSITORSRCDIR $$COMMONDIR
+QT += quick
+
+# unit test and unit
+SOURCES += \
+    ut_snapshotcapture.cpp \
+    $$COMMONDIR/snapshottestfixture.cpp \
+    $$COMPOSITORSRCDIR/snapshotcapture.cpp \
+    $$COMPOSITORSRCDIR/snapshotstore.cpp \
+    $$SRCDIR/tracing.cpp
+
+# unit test and unit
+HEADERS += \
+    ut_snapshotcapture.h \
+    $$COMMONDIR/snapshottestfixture.h \
+    $$COMPOSITORSRCDIR/snapshotcapture.h \
+    $$COMPOSITORSRCDIR/snapshotstore.h \
+    $$SRCDIR/tracing.h
@@ -0,0 +1,286 @@
+/***************************************************************************
+**
+** Copyright (c) 2021 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QColor>
+#include <QOpenGLContext>
+#include <QOpenGLFramebufferObject>
+#include <QQuickItem>
+#include <QQuickWindow>
+#include <QSGSimpleTextureNode>
+#include <QSGTexture>
+#include "ut_snapshotstore.h"
+#include "snapshotstore.h"
+
+namespace {
+
+const qint64 SnapshotBytes = qint64(SnapshotSize.width()) * SnapshotSize.height() * 4;
+
+// Shows a snapshot like WindowPixmapItem does for a cover, restoring it when needed
+class CoverItem : public QQuickItem
+{
+public:
+    CoverItem(SnapshotTextureProvider *snapshot, QQuickItem *parent)
+        : QQuickItem(parent)
+        , m_snapshot(snapshot)
+    {
+        setFlag(ItemHasContents);
+        setSize(SnapshotSize);
+    }
+
+protected:
+    QSGNode *updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *) override
+    {
+        SnapshotStore::instance()->restore(m_snapshot, window());
+
+        QSGSimpleTextureNode *node = static_cast<QSGSimpleTextureNode *>(oldNode);
+        if (!node)
+            node = new QSGSimpleTextureNode;
+        node->setTexture(m_snapshot->texture());
+        node->setRect(boundingRect());
+        return node;
+    }
+
+private:
+    SnapshotTextureProvider *m_snapshot;
+};
+
+}
+
+void Ut_SnapshotStore::initTestCase()
+{
+    if (!m_fixture.create())
+        QSKIP("Snapshots need an OpenGL context, which is not available");
+}
+
+void Ut_SnapshotStore::init()
+{
+    SnapshotStore::instance()->setBudget(1024 * 1024 * 1024);
+}
+
+void Ut_SnapshotStore::cleanup()
+{
+    qDeleteAll(m_snapshots);
+    m_snapshots.clear();
+}
+
+SnapshotTextureProvider *Ut_SnapshotStore::takeSnapshot(const QColor &color, bool opaque)
+{
+    // Renders the snapshot the way WindowPixmapItem does, into a framebuffer object
+    SnapshotTextureProvider *snapshot = new SnapshotTextureProvider;
+    snapshot->fbo = m_fixture.createFramebuffer(color);
+    snapshot->t = m_fixture.window()->createTextureFromId(snapshot->fbo->texture(), SnapshotSize, 0);
+    m_snapshots.append(snapshot);
+
+    SnapshotStore *store = SnapshotStore::instance();
+    store->snapshotTaken(snapshot);
+    store->setDisplayed(snapshot, false, opaque);
+    return snapshot;
+}
+
+void Ut_SnapshotStore::testReleaseReclaimsMemory()
+{
+    SnapshotStore *store = SnapshotStore::instance();
+    for (int i = 0; i < 3; ++i)
+        takeSnapshot(Qt::darkCyan, true);
+    QCOMPARE(store->statistics().residentBytes, 3 * SnapshotBytes);
+
+    foreach (SnapshotTextureProvider *snapshot, m_snapshots)
+        store->release(snapshot);
+
+    const SnapshotStore::Statistics statistics = store->statistics();
+    QCOMPARE(statistics.residentBytes, qint64(0));
+    QCOMPARE(statistics.evictedSnapshots, 3);
+    QVERIFY(statistics.compressedBytes > 0);
+    QVERIFY(statistics.compressedBytes < 3 * SnapshotBytes);
+    foreach (SnapshotTextureProvider *snapshot, m_snapshots) {
+        QVERIFY(snapshot->isEvicted());
+        QVERIFY(!snapshot->texture());
+        QVERIFY(!snapshot->fbo);
+    }
+}
+
+void Ut_SnapshotStore::testReleaseVisibleSnapshot()
+{
+    SnapshotStore *store = SnapshotStore::instance();
+    SnapshotTextureProvider *visible = takeSnapshot(Qt::red, false);
+    SnapshotTextureProvider *other = takeSnapshot(Qt::blue, false);
+    store->setDisplayed(visible, true, false);
+
+    // Shown and within the budget, but released all the same
+    store->release(visible);
+    QVERIFY(visible->isEvicted());
+    QVERIFY(!other->isEvicted());
+    QCOMPARE(store->statistics().residentBytes, SnapshotBytes);
+}
+
+void Ut_SnapshotStore::testRestoreAfterRelease()
+{
+    SnapshotStore *store = SnapshotStore::instance();
+    SnapshotTextureProvider *snapshot = takeSnapshot(Qt::green, true);
+    QSignalSpy spy(snapshot, SIGNAL(textureChanged()));
+
+    store->release(snapshot);
+    QCOMPARE(spy.count(), 1);
+
+    QVERIFY(store->restore(snapshot, m_fixture.window()));
+    QCOMPARE(spy.count(), 2);
+    QVERIFY(!snapshot->isEvicted());
+    QVERIFY(snapshot->texture());
+    QCOMPARE(snapshot->texture()->textureSize(), SnapshotSize);
+    QCOMPARE(store->statistics().residentBytes, SnapshotBytes);
+
+    // Nothing to do once it is back in GPU memory
+    QVERIFY(!store->restore(snapshot, m_fixture.window()));
+}
+
+void Ut_SnapshotStore::testReleaseEvictedSnapshot()
+{
+    SnapshotStore *store = SnapshotStore::instance();
+    SnapshotTextureProvider *snapshot = takeSnapshot(Qt::yellow, true);
+
+    const quint64 evictions = store->statistics().evictions;
+    store->release(snapshot);
+    store->release(snapshot);
+    QCOMPARE(store->statistics().evictions, evictions + 1);
+    QVERIFY(snapshot->isEvicted());
+}
+
+void Ut_SnapshotStore::testBudgetEvictsLeastRecentlyDisplayed()
+{
+    SnapshotStore *store = SnapshotStore::instance();
+    store->setBudget(2 * SnapshotBytes);
+    SnapshotTextureProvider *first = takeSnapshot(Qt::red, true);
+    SnapshotTextureProvider *second = takeSnapshot(Qt::green, true);
+
+    // Showing the first cover makes the second one the least recently displayed
+    store->setDisplayed(first, true, true);
+    store->setDisplayed(first, false, true);
+
+    SnapshotTextureProvider *third = takeSnapshot(Qt::blue, true);
+    QVERIFY(!first->isEvicted());
+    QVERIFY(second->isEvicted());
+    QVERIFY(!third->isEvicted());
+    QCOMPARE(store->statistics().residentBytes, 2 * SnapshotBytes);
+
+    SnapshotTextureProvider *fourth = takeSnapshot(Qt::white, true);
+    QVERIFY(first->isEvicted());
+    QVERIFY(!third->isEvicted());
+    QVERIFY(!fourth->isEvicted());
+    QCOMPARE(store->statistics().residentBytes, 2 * SnapshotBytes);
+}
+
+void Ut_SnapshotStore::testTakenSnapshotIsKept()
+{
+    SnapshotStore *store = SnapshotStore::instance();
+    store->setBudget(SnapshotBytes / 2);
+
+    // The new snapshot alone exceeds the budget but it is not evicted straight away
+    SnapshotTextureProvider *first = takeSnapshot(Qt::red, true);
+    QVERIFY(!first->isEvicted());
+    QCOMPARE(store->statistics().residentBytes, SnapshotBytes);
+
+    SnapshotTextureProvider *second = takeSnapshot(Qt::green, true);
+    QVERIFY(first->isEvicted());
+    QVERIFY(!second->isEvicted());
+    QCOMPARE(store->statistics().residentBytes, SnapshotBytes);
+}
+
+void Ut_SnapshotStore::testVisibleSnapshotIsNeverEvicted()
+{
+    SnapshotStore *store = SnapshotStore::instance();
+    store->setBudget(SnapshotBytes);
+    SnapshotTextureProvider *visible = takeSnapshot(Qt::red, true);
+    store->setDisplayed(visible, true, true);
+
+    SnapshotTextureProvider *hidden = takeSnapshot(Qt::green, true);
+    QVERIFY(!visible->isEvicted());
+    QVERIFY(!hidden->isEvicted());
+    QCOMPARE(store->statistics().residentBytes, 2 * SnapshotBytes);
+
+    // Without a snapshot to keep only the hidden one can go
+    store->enforceBudget(0);
+    QVERIFY(!visible->isEvicted());
+    QVERIFY(hidden->isEvicted());
+
+    store->setBudget(0);
+    store->enforceBudget(0);
+    QVERIFY(!visible->isEvicted());
+    QCOMPARE(store->statistics().residentBytes, SnapshotBytes);
+}
+
+void Ut_SnapshotStore::testRestoreOnShow()
+{
+    SnapshotStore *store = SnapshotStore::instance();
+    store->setBudget(SnapshotBytes);
+    SnapshotTextureProvider *first = takeSnapshot(Qt::red, true);
+    SnapshotTextureProvider *second = takeSnapshot(Qt::green, true);
+    QVERIFY(first->isEvicted());
+
+    // Shown again the way WindowPixmapItem does it when the cover becomes visible
+    store->setDisplayed(first, true, true);
+    QVERIFY(store->restore(first, m_fixture.window()));
+    store->enforceBudget(first);
+
+    QVERIFY(!first->isEvicted());
+    QVERIFY(first->texture());
+    QCOMPARE(first->texture()->textureSize(), SnapshotSize);
+    QVERIFY(second->isEvicted());
+    QCOMPARE(store->statistics().residentBytes, SnapshotBytes);
+}
+
+void Ut_SnapshotStore::benchmarkDisplayOn_data()
+{
+    SnapshotTestFixture::addBenchmarkRows("covers", QStringList() << "time to first frame" << "reclaimed memory");
+}
+
+void Ut_SnapshotStore::benchmarkDisplayOn()
+{
+    QFETCH(int, count);
+    QFETCH(int, metric);
+
+    // The covers are shown, as in the switcher
+    SnapshotStore *store = SnapshotStore::instance();
+    QList<CoverItem *> covers;
+    for (int i = 0; i < count; ++i) {
+        SnapshotTextureProvider *snapshot = takeSnapshot(QColor::fromHsv(i * 36, 255, 255), true);
+        store->setDisplayed(snapshot, true, true);
+        covers.append(new CoverItem(snapshot, m_fixture.window()->contentItem()));
+    }
+    m_fixture.render();
+    const qint64 resident = store->statistics().residentBytes;
+
+    // The display goes off and the scene graph of the hidden window is torn down, which
+    // releases the snapshots as WindowPixmapItem::invalidateSceneGraph() does
+    m_fixture.invalidate();
+    foreach (SnapshotTextureProvider *snapshot, m_snapshots)
+        store->release(snapshot);
+    const SnapshotStore::Statistics released = store->statistics();
+
+    // The display comes back on: the scene graph is rebuilt and the first frame rendered
+    QElapsedTimer timer;
+    timer.start();
+    m_fixture.render();
+    const qint64 elapsed = timer.nsecsElapsed();
+
+    QCOMPARE(store->statistics().residentBytes, resident);
+    qDeleteAll(covers);
+    m_fixture.render();
+
+    SnapshotTestFixture::setBenchmarkResult(metric, QVector<SnapshotTestFixture::BenchmarkResult>()
+            << qMakePair(elapsed / 1000000.0, QTest::WalltimeMilliseconds)
+            << qMakePair(qreal(resident - released.residentBytes - released.compressedBytes), QTest::BytesAllocated));
+}
+
+QTEST_MAIN(Ut_SnapshotStore)
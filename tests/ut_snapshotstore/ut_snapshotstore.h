@@ -0,0 +1,55 @@
+/***************************************************************************
+**
+** Copyright (c) 2021 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#ifndef UT_SNAPSHOTSTORE_H
+#define UT_SNAPSHOTSTORE_H
+
+#include <QObject>
+#include <QList>
+#include "snapshottestfixture.h"
+
+class QColor;
+class SnapshotTextureProvider;
+
+class Ut_SnapshotStore : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void init();
+    void cleanup();
+
+    // Test cases
+    void testReleaseReclaimsMemory();
+    void testReleaseVisibleSnapshot();
+    void testRestoreAfterRelease();
+    void testReleaseEvictedSnapshot();
+    void testBudgetEvictsLeastRecentlyDisplayed();
+    void testTakenSnapshotIsKept();
+    void testVisibleSnapshotIsNeverEvicted();
+    void testRestoreOnShow();
+
+    // Benchmarks of the display going off and coming back on
+    void benchmarkDisplayOn_data();
+    void benchmarkDisplayOn();
+
+private:
+    SnapshotTextureProvider *takeSnapshot(const QColor &color, bool opaque);
+
+    SnapshotTestFixture m_fixture;
+    QList<SnapshotTextureProvider *> m_snapshots;
+};
+
+#endif
@@ -0,0 +1,16 @@
+include(../common.pri)
+TARGET = ut_snapshotstore
+INCLUDEPATH += $$COMPOSITORSRCDIR $$COMMONDIR
+QT += quick
+
+# unit test and unit
+SOURCES += \
+    ut_snapshotstore.cpp \
+    $$COMMONDIR/snapshottestfixture.cpp \
+    $$COMPOSITORSRCDIR/snapshotstore.cpp
+
+# unit test and unit
+HEADERS += \
+    ut_snapshotstore.h \
+    $$COMMONDIR/snapshottestfixture.h \
+    $$COMPOSITORSRCDIR/snapshotstore.h
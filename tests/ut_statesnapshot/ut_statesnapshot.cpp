@@ -0,0 +1,131 @@
+/***************************************************************************
+**
+** Copyright (c) 2021 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include "statesnapshot_p.h"
+#include "ut_statesnapshot.h"
+
+using DeviceState::StateSnapshot;
+
+namespace {
+
+const QByteArray BootId("9f5ca1b3-0d0c-4d5e-8a5c-3cc0b5e7d0a1");
+const QByteArray OtherBootId("1a6c6e5c-81c4-4f0c-b8e4-2d4c1e6a0b7f");
+
+bool writeFile(const QString &path, const QByteArray &data)
+{
+    QFile file(path);
+    return file.open(QIODevice::WriteOnly) && file.write(data) == data.size();
+}
+
+}
+
+void Ut_StateSnapshot::init()
+{
+    m_dir = new QTemporaryDir;
+    QVERIFY(m_dir->isValid());
+    m_path = m_dir->path() + "/lipstick-devicestate";
+}
+
+void Ut_StateSnapshot::cleanup()
+{
+    delete m_dir;
+    m_dir = 0;
+}
+
+void Ut_StateSnapshot::testSaveAndLoad()
+{
+    {
+        StateSnapshot snapshot(m_path, BootId);
+        snapshot.setValue("display", 2);
+        snapshot.setValue("thermal", 1);
+        snapshot.setValue("thermal", 3);
+    }
+
+    StateSnapshot snapshot(m_path, BootId);
+    QCOMPARE(snapshot.value("display", -1), 2);
+    QCOMPARE(snapshot.value("thermal", -1), 3);
+    QCOMPARE(snapshot.value("battery", -1), -1);
+}
+
+void Ut_StateSnapshot::testUnchangedValueIsNotWritten()
+{
+    StateSnapshot snapshot(m_path, BootId);
+    snapshot.setValue("display", 2);
+    QVERIFY(QFile::exists(m_path));
+
+    QVERIFY(QFile::remove(m_path));
+    snapshot.setValue("display", 2);
+    QVERIFY(!QFile::exists(m_path));
+
+    snapshot.setValue("display", 0);
+    QVERIFY(QFile::exists(m_path));
+}
+
+void Ut_StateSnapshot::testOtherBootIsDiscarded()
+{
+    {
+        StateSnapshot snapshot(m_path, OtherBootId);
+        snapshot.setValue("display", 2);
+    }
+
+    StateSnapshot snapshot(m_path, BootId);
+    QCOMPARE(snapshot.value("display", -1), -1);
+
+    // The stale snapshot is replaced on the first change
+    snapshot.setValue("thermal", 1);
+    StateSnapshot reloaded(m_path, BootId);
+    QCOMPARE(reloaded.value("display", -1), -1);
+    QCOMPARE(reloaded.value("thermal", -1), 1);
+}
+
+void Ut_StateSnapshot::testMissingFile()
+{
+    StateSnapshot snapshot(m_path, BootId);
+    QCOMPARE(snapshot.value("display", -1), -1);
+
+    snapshot.setValue("display", 2);
+    QVERIFY(QFile::exists(m_path));
+}
+
+void Ut_StateSnapshot::testCorruptFile_data()
+{
+    QTest::addColumn<QByteArray>("data");
+    QTest::addColumn<int>("display");
+    QTest::addColumn<int>("thermal");
+
+    QTest::newRow("empty") << QByteArray() << -1 << -1;
+    QTest::newRow("no boot id") << QByteArray("display=2\nthermal=1\n") << -1 << -1;
+    QTest::newRow("truncated") << BootId.left(10) << -1 << -1;
+    QTest::newRow("binary") << QByteArray("\x00\xff\x13\n\x01=\x02", 7) << -1 << -1;
+    QTest::newRow("malformed lines")
+            << QByteArray(BootId + "\ngarbage\n=3\ndisplay=on\nthermal=1\n") << -1 << 1;
+    QTest::newRow("no trailing newline")
+            << QByteArray(BootId + "\ndisplay=2\nthermal=1") << 2 << 1;
+}
+
+void Ut_StateSnapshot::testCorruptFile()
+{
+    QFETCH(QByteArray, data);
+    QFETCH(int, display);
+    QFETCH(int, thermal);
+
+    QVERIFY(writeFile(m_path, data));
+
+    StateSnapshot snapshot(m_path, BootId);
+    QCOMPARE(snapshot.value("display", -1), display);
+    QCOMPARE(snapshot.value("thermal", -1), thermal);
+}
+
+QTEST_MAIN(Ut_StateSnapshot)
@@ -0,0 +1,44 @@
+/***************************************************************************
+**
+** Copyright (c) 2021 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#ifndef UT_STATESNAPSHOT_H
+#define UT_STATESNAPSHOT_H
+
+#include <QObject>
+#include <QTemporaryDir>
+
+class Ut_StateSnapshot : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    // Called before each testfunction is executed
+    void init();
+    // Called after every testfunction
+    void cleanup();
+
+    // Test cases
+    void testSaveAndLoad();
+    void testUnchangedValueIsNotWritten();
+    void testOtherBootIsDiscarded();
+    void testMissingFile();
+    void testCorruptFile_data();
+    void testCorruptFile();
+
+private:
+    QString m_path;
+    QTemporaryDir *m_dir;
+};
+
+#endif
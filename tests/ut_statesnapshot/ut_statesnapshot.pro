@@ -0,0 +1,13 @@
+include(../common.pri)
+TARGET = ut_statesnapshot
+INCLUDEPATH += $$DEVICESTATE
+
+# unit test and unit
+SOURCES += \
+    ut_statesnapshot.cpp \
+    $$DEVICESTATE/statesnapshot.cpp
+
+# unit test and unit
+HEADERS += \
+    ut_statesnapshot.h \
+    $$DEVICESTATE/statesnapshot_p.h
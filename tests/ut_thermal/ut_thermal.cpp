@@ -0,0 +1,186 @@
+/***************************************************************************
+**
+** Copyright (c) 2021 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+#include <QtTest/QtTest>
+#include <QDBusConnection>
+#include <dsme/thermalmanager_dbus_if.h>
+#include "thermal.h"
+#include "statesnapshot_p.h"
+#include "thermalnotifier.h"
+#include "homeapplication.h"
+#include "displaystate_stub.h"
+#include "notificationmanager_stub.h"
+#include "lipsticknotification.h"
+#include "ut_thermal.h"
+
+HomeApplication::~HomeApplication()
+{
+}
+
+HomeApplication *HomeApplication::instance()
+{
+    return 0;
+}
+
+void HomeApplication::restoreSignalHandlers()
+{
+}
+
+QString ThermalManagerService::get_thermal_state()
+{
+    ++queryCount;
+    setDelayedReply(true);
+    queries.append(message());
+    return QString();
+}
+
+void ThermalManagerService::replyToQueries(const QString &state)
+{
+    for (const QDBusMessage &query : queries) {
+        QDBusConnection::systemBus().send(query.createReply(state));
+    }
+    queries.clear();
+}
+
+void ThermalManagerService::failQueries()
+{
+    for (const QDBusMessage &query : queries) {
+        QDBusConnection::systemBus().send(query.createErrorReply(QDBusError::Failed, QString()));
+    }
+    queries.clear();
+}
+
+void ThermalManagerService::indicateStateChange(const QString &state)
+{
+    QDBusMessage signal = QDBusMessage::createSignal(thermalmanager_path,
+                                                     thermalmanager_interface,
+                                                     thermalmanager_state_change_ind);
+    signal << state;
+    QDBusConnection::systemBus().send(signal);
+}
+
+void Ut_Thermal::initTestCase()
+{
+    // The fake thermal manager is served on the session bus, and the state
+    // snapshot goes to a directory of its own
+    qputenv("DBUS_SYSTEM_BUS_ADDRESS", qgetenv("DBUS_SESSION_BUS_ADDRESS"));
+    qputenv("XDG_RUNTIME_DIR", QFile::encodeName(m_runtimeDir.path()));
+
+    QDBusConnection bus = QDBusConnection::systemBus();
+    m_busAvailable = bus.isConnected()
+            && bus.registerService(thermalmanager_service)
+            && bus.registerObject(thermalmanager_path, &m_service, QDBusConnection::ExportAllSlots);
+}
+
+void Ut_Thermal::cleanupTestCase()
+{
+    QDBusConnection bus = QDBusConnection::systemBus();
+    bus.unregisterObject(thermalmanager_path);
+    bus.unregisterService(thermalmanager_service);
+}
+
+void Ut_Thermal::init()
+{
+    if (!m_busAvailable) {
+        QSKIP("D-Bus session bus is not available");
+    }
+    m_service.queries.clear();
+    m_service.queryCount = 0;
+    DeviceState::StateSnapshot::instance()->setValue("thermal", DeviceState::Thermal::Unknown);
+    gNotificationManagerStub->stubReset();
+    gNotificationManagerStub->stubSetReturnValue("publishSystemNotification", (uint)1);
+    gDisplayStateMonitorStub->stubReset();
+    gDisplayStateMonitorStub->stubSetReturnValue("get", DeviceState::DisplayStateMonitor::On);
+}
+
+void Ut_Thermal::testGetDoesNotWaitForThermalManager()
+{
+    DeviceState::Thermal thermal;
+    QTRY_COMPARE(m_service.queryCount, 1);
+
+    // The query is not answered, a blocking get() would run into the D-Bus timeout
+    QElapsedTimer timer;
+    timer.start();
+    QCOMPARE(thermal.get(), DeviceState::Thermal::Unknown);
+    QVERIFY(timer.elapsed() < 1000);
+    QCOMPARE(m_service.queryCount, 1);
+
+    m_service.replyToQueries(thermalmanager_thermal_status_warning);
+    QTRY_COMPARE(thermal.get(), DeviceState::Thermal::Warning);
+    QCOMPARE(m_service.queryCount, 1);
+}
+
+void Ut_Thermal::testFailedQueryKeepsSeededState()
+{
+    DeviceState::StateSnapshot::instance()->setValue("thermal", DeviceState::Thermal::Warning);
+    DeviceState::Thermal thermal;
+    QCOMPARE(thermal.get(), DeviceState::Thermal::Warning);
+    QTRY_COMPARE(m_service.queryCount, 1);
+
+    m_service.failQueries();
+    QTest::qWait(100);
+    QCOMPARE(thermal.get(), DeviceState::Thermal::Warning);
+
+    m_service.indicateStateChange(thermalmanager_thermal_status_normal);
+    QTRY_COMPARE(thermal.get(), DeviceState::Thermal::Normal);
+}
+
+void Ut_Thermal::testChangeIndicationUpdatesState()
+{
+    DeviceState::Thermal thermal;
+    QList<DeviceState::Thermal::ThermalState> changes;
+    connect(&thermal, &DeviceState::Thermal::thermalChanged, [&changes](DeviceState::Thermal::ThermalState state) {
+        changes.append(state);
+    });
+    QTRY_COMPARE(m_service.queryCount, 1);
+
+    m_service.indicateStateChange(thermalmanager_thermal_status_alert);
+    QTRY_COMPARE(changes.count(), 1);
+    QCOMPARE(changes.last(), DeviceState::Thermal::Alert);
+    QCOMPARE(thermal.get(), DeviceState::Thermal::Alert);
+
+    // The indication is newer than the pending query
+    m_service.replyToQueries(thermalmanager_thermal_status_normal);
+    QTest::qWait(100);
+    QCOMPARE(thermal.get(), DeviceState::Thermal::Alert);
+    QCOMPARE(changes.count(), 1);
+}
+
+void Ut_Thermal::testDisplayOnDoesNotQueryThermalManager()
+{
+    ThermalNotifier notifier;
+    QTRY_COMPARE(m_service.queryCount, 1);
+
+    // Turning the display on while the initial query is pending neither
+    // waits for the thermal manager nor shows anything
+    QElapsedTimer timer;
+    timer.start();
+    QVERIFY(QMetaObject::invokeMethod(&notifier, "applyDisplayState", Qt::DirectConnection,
+                                      Q_ARG(DeviceState::DisplayStateMonitor::DisplayState, DeviceState::DisplayStateMonitor::On)));
+    QVERIFY(timer.elapsed() < 1000);
+    QCOMPARE(m_service.queryCount, 1);
+    QCOMPARE(gNotificationManagerStub->stubCallCount("publishSystemNotification"), 0);
+
+    m_service.indicateStateChange(thermalmanager_thermal_status_warning);
+    QTRY_COMPARE(gNotificationManagerStub->stubCallCount("publishSystemNotification"), 1);
+
+    // The display on path reads the tracked state
+    timer.restart();
+    QVERIFY(QMetaObject::invokeMethod(&notifier, "applyDisplayState", Qt::DirectConnection,
+                                      Q_ARG(DeviceState::DisplayStateMonitor::DisplayState, DeviceState::DisplayStateMonitor::On)));
+    QVERIFY(timer.elapsed() < 1000);
+    QCOMPARE(m_service.queryCount, 1);
+    QCOMPARE(gNotificationManagerStub->stubCallCount("publishSystemNotification"), 1);
+}
+
+QTEST_MAIN(Ut_Thermal)
@@ -0,0 +1,66 @@
+/***************************************************************************
+**
+** Copyright (c) 2021 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+#ifndef UT_THERMAL_H
+#define UT_THERMAL_H
+
+#include <QObject>
+#include <QDBusContext>
+#include <QDBusMessage>
+#include <QTemporaryDir>
+
+class ThermalNotifier;
+
+// Fake thermal manager which holds the replies to the state queries
+class ThermalManagerService : public QObject, protected QDBusContext
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "com.nokia.thermalmanager")
+
+public:
+    void replyToQueries(const QString &state);
+    void failQueries();
+    void indicateStateChange(const QString &state);
+
+    QList<QDBusMessage> queries;
+    int queryCount = 0;
+
+public slots:
+    QString get_thermal_state();
+};
+
+class Ut_Thermal : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    // Called before the first testfunction is executed
+    void initTestCase();
+    // Called after the last testfunction was executed
+    void cleanupTestCase();
+    // Called before each testfunction is executed
+    void init();
+
+    // Test cases
+    void testGetDoesNotWaitForThermalManager();
+    void testFailedQueryKeepsSeededState();
+    void testChangeIndicationUpdatesState();
+    void testDisplayOnDoesNotQueryThermalManager();
+
+private:
+    QTemporaryDir m_runtimeDir;
+    ThermalManagerService m_service;
+    bool m_busAvailable;
+};
+
+#endif
@@ -0,0 +1,29 @@
+include(../common.pri)
+TARGET = ut_thermal
+CONFIG += link_pkgconfig
+PKGCONFIG += thermalmanager_dbus_if
+INCLUDEPATH += $$SRCDIR $$NOTIFICATIONSRCDIR $$UTILITYSRCDIR $$DEVICESTATE
+QT += qml quick dbus
+
+# unit test and unit
+SOURCES += \
+    ut_thermal.cpp \
+    $$DEVICESTATE/thermal.cpp \
+    $$DEVICESTATE/ipcinterface.cpp \
+    $$DEVICESTATE/statesnapshot.cpp \
+    $$NOTIFICATIONSRCDIR/thermalnotifier.cpp \
+    $$NOTIFICATIONSRCDIR/lipsticknotification.cpp \
+    $$STUBSDIR/stubbase.cpp \
+    $$STUBSDIR/homeapplication.cpp
+
+# unit test and unit
+HEADERS += \
+    ut_thermal.h \
+    $$DEVICESTATE/thermal.h \
+    $$DEVICESTATE/thermal_p.h \
+    $$DEVICESTATE/ipcinterface_p.h \
+    $$DEVICESTATE/displaystate.h \
+    $$NOTIFICATIONSRCDIR/thermalnotifier.h \
+    $$NOTIFICATIONSRCDIR/notificationmanager.h \
+    $$NOTIFICATIONSRCDIR/lipsticknotification.h \
+    $$SRCDIR/homeapplication.h
@@ -51,7 +51,7 @@ void Ut_ThermalNotifier::init()
     thermalNotifier = new ThermalNotifier;
 
     gNotificationManagerStub->stubReset();
-    gNotificationManagerStub->stubSetReturnValue("Notify", (uint)1);
+    gNotificationManagerStub->stubSetReturnValue("publishSystemNotification", (uint)1);
     gThermalStub->stubReset();
 }
 
@@ -70,19 +70,19 @@ void Ut_ThermalNotifier::testConnections()
 void Ut_ThermalNotifier::testThermalState()
 {
     thermalNotifier->applyThermalState(DeviceState::Thermal::Warning);
-    QCOMPARE(gNotificationManagerStub->stubCallCount("Notify"), 1);
-    QCOMPARE(gNotificationManagerStub->stubLastCallTo("Notify").parameter<QString>(4), qtTrId("qtn_shut_high_temp_warning"));
-    QCOMPARE(gNotificationManagerStub->stubLastCallTo("Notify").parameter<QString>(2), QString("icon-system-warning"));
+    QCOMPARE(gNotificationManagerStub->stubCallCount("publishSystemNotification"), 1);
+    QCOMPARE(gNotificationManagerStub->stubLastCallTo("publishSystemNotification").parameter<SystemNotification>(0).body(), qtTrId("qtn_shut_high_temp_warning"));
+    QCOMPARE(gNotificationManagerStub->stubLastCallTo("publishSystemNotification").parameter<SystemNotification>(0).icon(), QString("icon-system-warning"));
 
     thermalNotifier->applyThermalState(DeviceState::Thermal::Alert);
-    QCOMPARE(gNotificationManagerStub->stubCallCount("Notify"), 2);
-    QCOMPARE(gNotificationManagerStub->stubLastCallTo("Notify").parameter<QString>(4), qtTrId("qtn_shut_high_temp_alert"));
-    QCOMPARE(gNotificationManagerStub->stubLastCallTo("Notify").parameter<QString>(2), QString("icon-system-warning"));
+    QCOMPARE(gNotificationManagerStub->stubCallCount("publishSystemNotification"), 2);
+    QCOMPARE(gNotificationManagerStub->stubLastCallTo("publishSystemNotification").parameter<SystemNotification>(0).body(), qtTrId("qtn_shut_high_temp_alert"));
+    QCOMPARE(gNotificationManagerStub->stubLastCallTo("publishSystemNotification").parameter<SystemNotification>(0).icon(), QString("icon-system-warning"));
 
     thermalNotifier->applyThermalState(DeviceState::Thermal::LowTemperatureWarning);
-    QCOMPARE(gNotificationManagerStub->stubCallCount("Notify"), 3);
-    QCOMPARE(gNotificationManagerStub->stubLastCallTo("Notify").parameter<QString>(4), qtTrId("qtn_shut_low_temp_warning"));
-    QCOMPARE(gNotificationManagerStub->stubLastCallTo("Notify").parameter<QString>(2), QString("icon-system-warning"));
+    QCOMPARE(gNotificationManagerStub->stubCallCount("publishSystemNotification"), 3);
+    QCOMPARE(gNotificationManagerStub->stubLastCallTo("publishSystemNotification").parameter<SystemNotification>(0).body(), qtTrId("qtn_shut_low_temp_warning"));
+    QCOMPARE(gNotificationManagerStub->stubLastCallTo("publishSystemNotification").parameter<SystemNotification>(0).icon(), QString("icon-system-warning"));
 }
 
 void Ut_ThermalNotifier::testDisplayStateOffDoesNothing()
@@ -90,13 +90,13 @@ void Ut_ThermalNotifier::testDisplayStateOffDoesNothing()
     gThermalStub->stubSetReturnValue("get", DeviceState::Thermal::Warning);
 
     thermalNotifier->applyDisplayState(DeviceState::DisplayStateMonitor::Off);
-    QCOMPARE(gNotificationManagerStub->stubCallCount("Notify"), 0);
+    QCOMPARE(gNotificationManagerStub->stubCallCount("publishSystemNotification"), 0);
 
     thermalNotifier->applyDisplayState(DeviceState::DisplayStateMonitor::Dimmed);
-    QCOMPARE(gNotificationManagerStub->stubCallCount("Notify"), 0);
+    QCOMPARE(gNotificationManagerStub->stubCallCount("publishSystemNotification"), 0);
 
     thermalNotifier->applyDisplayState(DeviceState::DisplayStateMonitor::Unknown);
-    QCOMPARE(gNotificationManagerStub->stubCallCount("Notify"), 0);
+    QCOMPARE(gNotificationManagerStub->stubCallCount("publishSystemNotification"), 0);
 }
 
 void Ut_ThermalNotifier::testDisplayStateOnAppliesThermalState()
@@ -105,16 +105,33 @@ void Ut_ThermalNotifier::testDisplayStateOnAppliesThermalState()
     gThermalStub->stubSetReturnValue("get", DeviceState::Thermal::Warning);
 
     thermalNotifier->applyDisplayState(DeviceState::DisplayStateMonitor::On);
-    QCOMPARE(gNotificationManagerStub->stubCallCount("Notify"), 1);
+    QCOMPARE(gNotificationManagerStub->stubCallCount("publishSystemNotification"), 1);
 
     // The same thermal state should not get shown again
     thermalNotifier->applyDisplayState(DeviceState::DisplayStateMonitor::On);
-    QCOMPARE(gNotificationManagerStub->stubCallCount("Notify"), 1);
+    QCOMPARE(gNotificationManagerStub->stubCallCount("publishSystemNotification"), 1);
 
     // The different thermal state should get shown
     gThermalStub->stubSetReturnValue("get", DeviceState::Thermal::Alert);
     thermalNotifier->applyDisplayState(DeviceState::DisplayStateMonitor::On);
-    QCOMPARE(gNotificationManagerStub->stubCallCount("Notify"), 2);
+    QCOMPARE(gNotificationManagerStub->stubCallCount("publishSystemNotification"), 2);
+}
+
+void Ut_ThermalNotifier::testDisplayStateOnIgnoresUnresolvedThermalState()
+{
+    gDisplayStateMonitorStub->stubSetReturnValue("get", DeviceState::DisplayStateMonitor::On);
+    gThermalStub->stubSetReturnValue("get", DeviceState::Thermal::Warning);
+    thermalNotifier->applyDisplayState(DeviceState::DisplayStateMonitor::On);
+    QCOMPARE(gNotificationManagerStub->stubCallCount("publishSystemNotification"), 1);
+
+    // A state that is not known yet must not reset the already notified state
+    gThermalStub->stubSetReturnValue("get", DeviceState::Thermal::Unknown);
+    thermalNotifier->applyDisplayState(DeviceState::DisplayStateMonitor::On);
+    gThermalStub->stubSetReturnValue("get", DeviceState::Thermal::Error);
+    thermalNotifier->applyDisplayState(DeviceState::DisplayStateMonitor::On);
+    gThermalStub->stubSetReturnValue("get", DeviceState::Thermal::Warning);
+    thermalNotifier->applyDisplayState(DeviceState::DisplayStateMonitor::On);
+    QCOMPARE(gNotificationManagerStub->stubCallCount("publishSystemNotification"), 1);
 }
 
 QTEST_MAIN (Ut_ThermalNotifier)
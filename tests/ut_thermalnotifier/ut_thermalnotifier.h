@@ -40,6 +40,7 @@ private slots:
     void testThermalState();
     void testDisplayStateOffDoesNothing();
     void testDisplayStateOnAppliesThermalState();
+    void testDisplayStateOnIgnoresUnresolvedThermalState();
 
 private:
     ThermalNotifier *thermalNotifier;
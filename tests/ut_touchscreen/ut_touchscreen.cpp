@@ -178,6 +178,32 @@ void Ut_TouchScreen::testTouchBlocking()
     QCOMPARE(touchScreen->eventFilter(0, &touch), false);
 }
 
+void Ut_TouchScreen::testKnownDisplayStateIsNotReevaluated()
+{
+    // Display state recorded earlier during the same boot
+    delete gTouchScreen;
+    gDisplayStateMonitorStub->stubSetReturnValue("lastKnown", DeviceState::DisplayStateMonitor::On);
+    gTouchScreen = new TouchScreen;
+    gDisplayStateMonitorStub->stubSetReturnValue("lastKnown", DeviceState::DisplayStateMonitor::Unknown);
+
+    QCOMPARE(gTouchScreen->currentDisplayState(), TouchScreen::DisplayOn);
+
+    // mce confirming the state does not trigger a second evaluation
+    QSignalSpy displayStateSpy(gTouchScreen, SIGNAL(displayStateChanged(DisplayState,DisplayState)));
+    emit gDisplayStateMonitorStub->displayState->displayStateChanged(DeviceState::DisplayStateMonitor::On);
+    QCOMPARE(displayStateSpy.count(), 0);
+}
+
+void Ut_TouchScreen::testUnknownDisplayStateIsEvaluated()
+{
+    QCOMPARE(gTouchScreen->currentDisplayState(), TouchScreen::DisplayUnknown);
+
+    QSignalSpy displayStateSpy(gTouchScreen, SIGNAL(displayStateChanged(DisplayState,DisplayState)));
+    emit gDisplayStateMonitorStub->displayState->displayStateChanged(DeviceState::DisplayStateMonitor::On);
+    QCOMPARE(displayStateSpy.count(), 1);
+    QCOMPARE(gTouchScreen->currentDisplayState(), TouchScreen::DisplayOn);
+}
+
 void Ut_TouchScreen::updateDisplayState(DeviceState::DisplayStateMonitor::DisplayState oldState, DeviceState::DisplayStateMonitor::DisplayState newState)
 {
     emit gDisplayStateMonitorStub->displayState->displayStateChanged(oldState);
@@ -33,6 +33,8 @@ private slots:
 
     void testEnabled();
     void testTouchBlocking();
+    void testKnownDisplayStateIsNotReevaluated();
+    void testUnknownDisplayStateIsEvaluated();
 
 private:
     void updateDisplayState(DeviceState::DisplayStateMonitor::DisplayState oldState, DeviceState::DisplayStateMonitor::DisplayState newState);
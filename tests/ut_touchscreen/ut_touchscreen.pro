@@ -9,9 +9,11 @@ INCLUDEPATH += $$TOUCHSCREENSRCDIR $$UTILITYSRCDIR $$SRCDIR/xtools $$DEVICESTATE
 SOURCES += ut_touchscreen.cpp \
     $$TOUCHSCREENSRCDIR/touchscreen.cpp \
     $$STUBSDIR/homeapplication.cpp \
-    $$STUBSDIR/stubbase.cpp
+    $$STUBSDIR/stubbase.cpp \
+    $$SRCDIR/tracing.cpp
 
 HEADERS += ut_touchscreen.h \
     $$TOUCHSCREENSRCDIR/touchscreen.h \
     $$DEVICESTATE/displaystate.h \
-    $$SRCDIR/homeapplication.h
+    $$SRCDIR/homeapplication.h \
+    $$SRCDIR/tracing.h
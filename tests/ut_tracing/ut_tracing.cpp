@@ -0,0 +1,237 @@
+/***************************************************************************
+**
+** Copyright (c) 2021 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QBuffer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include "ut_tracing.h"
+#include "tracing.h"
+
+namespace {
+
+QJsonArray chromeEvents(const char *phase)
+{
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+    Tracing::write(&buffer, Tracing::ChromeJson);
+
+    QJsonParseError error;
+    const QJsonDocument document(QJsonDocument::fromJson(buffer.data(), &error));
+    if (error.error != QJsonParseError::NoError) {
+        qWarning() << "Invalid trace:" << error.errorString();
+    }
+
+    QJsonArray events;
+    foreach (const QJsonValue &event, document.object().value("traceEvents").toArray()) {
+        if (event.toObject().value("ph").toString() == QLatin1String(phase)) {
+            events.append(event);
+        }
+    }
+    return events;
+}
+
+void tracedFunction()
+{
+    LIPSTICK_TRACE_SCOPE("test", "tracedFunction");
+    LIPSTICK_TRACE_INSTANT("test", "instant");
+}
+
+class TracingThread : public QThread
+{
+protected:
+    void run()
+    {
+        tracedFunction();
+    }
+};
+
+class FloodingThread : public QThread
+{
+public:
+    FloodingThread() : stop(false) {}
+
+    std::atomic<bool> stop;
+
+protected:
+    void run()
+    {
+        while (!stop.load()) {
+            LIPSTICK_TRACE_INSTANT("flood", "instant");
+        }
+    }
+};
+
+}
+
+void Ut_Tracing::init()
+{
+    Tracing::clear();
+    Tracing::setEnabled(true);
+}
+
+void Ut_Tracing::cleanup()
+{
+    Tracing::setEnabled(false);
+}
+
+void Ut_Tracing::testNothingRecordedWhenDisabled()
+{
+    Tracing::setEnabled(false);
+    tracedFunction();
+
+    QCOMPARE(chromeEvents("X").count(), 0);
+    QCOMPARE(chromeEvents("i").count(), 0);
+}
+
+void Ut_Tracing::testChromeJson()
+{
+    tracedFunction();
+
+    const QJsonArray scopes(chromeEvents("X"));
+    QCOMPARE(scopes.count(), 1);
+    const QJsonObject scope(scopes.at(0).toObject());
+    QCOMPARE(scope.value("name").toString(), QString("tracedFunction"));
+    QCOMPARE(scope.value("cat").toString(), QString("test"));
+    QVERIFY(scope.value("dur").toDouble() >= 0);
+
+    const QJsonArray instants(chromeEvents("i"));
+    QCOMPARE(instants.count(), 1);
+    const QJsonObject instant(instants.at(0).toObject());
+    QCOMPARE(instant.value("name").toString(), QString("instant"));
+    QVERIFY(instant.value("ts").toDouble() >= scope.value("ts").toDouble());
+    QCOMPARE(instant.value("tid").toInt(), scope.value("tid").toInt());
+
+    // The thread names are reported as metadata
+    QVERIFY(chromeEvents("M").count() > 0);
+}
+
+void Ut_Tracing::testSystrace()
+{
+    tracedFunction();
+
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+    QVERIFY(Tracing::write(&buffer, Tracing::Systrace));
+
+    const QList<QByteArray> lines(buffer.data().split('\n'));
+    QCOMPARE(lines.at(0), QByteArray("# tracer: nop"));
+
+    QStringList markers;
+    foreach (const QByteArray &line, lines) {
+        const int index = line.indexOf("tracing_mark_write: ");
+        if (index >= 0) {
+            markers.append(QString::fromLatin1(line.mid(index + 20)).section('|', 0, 0, QString::SectionSkipEmpty)
+                           + QString::fromLatin1(line.mid(index + 20)).section('|', 2));
+        }
+    }
+
+    // The instant event is nested inside the scope as a slice without a duration
+    QCOMPARE(markers, QStringList() << "BtracedFunction" << "Binstant" << "E" << "E");
+}
+
+void Ut_Tracing::testThreadsRecordSeparately()
+{
+    tracedFunction();
+
+    TracingThread thread;
+    thread.start();
+    QVERIFY(thread.wait(5000));
+
+    const QJsonArray scopes(chromeEvents("X"));
+    QCOMPARE(scopes.count(), 2);
+    QVERIFY(scopes.at(0).toObject().value("tid").toInt() != scopes.at(1).toObject().value("tid").toInt());
+}
+
+void Ut_Tracing::testOldestEventsAreOverwritten()
+{
+    for (int i = 0; i < 20000; ++i) {
+        LIPSTICK_TRACE_INSTANT("test", "instant");
+    }
+    tracedFunction();
+
+    const QJsonArray instants(chromeEvents("i"));
+    QCOMPARE(instants.count(), 16383);
+    QCOMPARE(chromeEvents("X").count(), 1);
+}
+
+void Ut_Tracing::testClear()
+{
+    tracedFunction();
+    Tracing::clear();
+
+    QCOMPARE(chromeEvents("X").count(), 0);
+}
+
+void Ut_Tracing::testRecordingContinuesAfterClear()
+{
+    tracedFunction();
+    Tracing::clear();
+    tracedFunction();
+
+    QCOMPARE(chromeEvents("X").count(), 1);
+    QCOMPARE(chromeEvents("i").count(), 1);
+}
+
+void Ut_Tracing::testScopeEndingAfterDisableIsDropped()
+{
+    {
+        LIPSTICK_TRACE_SCOPE("test", "disabledScope");
+        Tracing::setEnabled(false);
+    }
+
+    QCOMPARE(chromeEvents("X").count(), 0);
+}
+
+void Ut_Tracing::testWriteWhileRecording()
+{
+    FloodingThread thread;
+    thread.start();
+    QList<QJsonArray> traces;
+    for (int i = 0; i < 20; ++i) {
+        traces.append(chromeEvents("i"));
+    }
+    thread.stop.store(true);
+    QVERIFY(thread.wait(5000));
+
+    // Every event written out is one that was recorded, even though the
+    // thread kept overwriting its buffer while it was being read
+    foreach (const QJsonArray &instants, traces) {
+        QVERIFY(instants.count() <= 16384);
+        foreach (const QJsonValue &value, instants) {
+            const QJsonObject instant(value.toObject());
+            QCOMPARE(instant.value("cat").toString(), QString("flood"));
+            QCOMPARE(instant.value("name").toString(), QString("instant"));
+        }
+    }
+}
+
+void Ut_Tracing::benchmarkDisabledScope()
+{
+    Tracing::setEnabled(false);
+
+    QBENCHMARK {
+        tracedFunction();
+    }
+}
+
+void Ut_Tracing::benchmarkEnabledScope()
+{
+    QBENCHMARK {
+        tracedFunction();
+    }
+}
+
+QTEST_MAIN(Ut_Tracing)
@@ -0,0 +1,41 @@
+/***************************************************************************
+**
+** Copyright (c) 2021 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+#ifndef UT_TRACING_H
+#define UT_TRACING_H
+
+#include <QObject>
+
+class Ut_Tracing : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    // Test cases
+    void testNothingRecordedWhenDisabled();
+    void testChromeJson();
+    void testSystrace();
+    void testThreadsRecordSeparately();
+    void testOldestEventsAreOverwritten();
+    void testClear();
+    void testRecordingContinuesAfterClear();
+    void testScopeEndingAfterDisableIsDropped();
+    void testWriteWhileRecording();
+    void benchmarkDisabledScope();
+    void benchmarkEnabledScope();
+};
+
+#endif
@@ -0,0 +1,12 @@
+include(../common.pri)
+TARGET = ut_tracing
+
+# unit test and unit
+SOURCES += \
+    ut_tracing.cpp \
+    $$SRCDIR/tracing.cpp
+
+# unit test and unit
+HEADERS += \
+    ut_tracing.h \
+    $$SRCDIR/tracing.h
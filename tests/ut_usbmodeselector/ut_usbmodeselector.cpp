@@ -20,7 +20,6 @@
 
 #include "ut_usbmodeselector.h"
 #include "lipsticknotification.h"
-#include "closeeventeater_stub.h"
 #include "lipstickqmlpath_stub.h"
 
 #include <nemo-devicelock/devicelock.h>
@@ -63,8 +62,8 @@ void Ut_USBModeSelector::testShowDialog()
     QSignalSpy spy(usbModeSelector, SIGNAL(dialogShown()));
     usbModeSelector->setMode(mode);
 
-    // Check that the window was shown
-    QCOMPARE(usbModeSelector->windowVisible(), true);
+    // Check that the window was shown once the state settled
+    QTRY_COMPARE(usbModeSelector->windowVisible(), true);
     QCOMPARE(spy.count(), 1);
 }
 
@@ -127,10 +126,78 @@ void Ut_USBModeSelector::testUSBNotifications()
 
     usbModeSelector->setMode(mode);
 
-    QCOMPARE(spy.count(), 1);
+    QTRY_COMPARE(spy.count(), 1);
     QCOMPARE(spy.last().at(0).value<USBModeSelector::Notification>(), notification);
 }
 
+void Ut_USBModeSelector::testRapidConnectDisconnect()
+{
+    QSignalSpy notificationSpy(usbModeSelector, SIGNAL(showNotification(USBModeSelector::Notification)));
+    QSignalSpy windowSpy(usbModeSelector, SIGNAL(windowVisibleChanged()));
+
+    // Replay a few quick plug and unplug cycles ending up connected in MTP mode
+    const QStringList trace = QStringList()
+            << QUsbModed::Mode::Busy << QUsbModed::Mode::MTP << QUsbModed::Mode::Undefined
+            << QUsbModed::Mode::Busy << QUsbModed::Mode::Ask << QUsbModed::Mode::Undefined
+            << QUsbModed::Mode::Busy << QUsbModed::Mode::MTP << QUsbModed::Mode::Undefined
+            << QUsbModed::Mode::Busy << QUsbModed::Mode::MTP;
+    for (const QString &mode : trace)
+        usbModeSelector->setMode(mode);
+
+    // Only the settled state is handled
+    QTRY_COMPARE(notificationSpy.count(), 1);
+    QCOMPARE(notificationSpy.last().at(0).value<USBModeSelector::Notification>(), USBModeSelector::MTP);
+    QCOMPARE(windowSpy.count(), 0);
+
+    // Handling the same state again does not repeat the notification
+    usbModeSelector->handleUSBState();
+    QCOMPARE(notificationSpy.count(), 1);
+
+    // Entering the mode again after a mode switch is notified about
+    usbModeSelector->setMode(QUsbModed::Mode::Busy);
+    usbModeSelector->setMode(QUsbModed::Mode::MTP);
+    QTRY_COMPARE(notificationSpy.count(), 2);
+    QCOMPARE(notificationSpy.last().at(0).value<USBModeSelector::Notification>(), USBModeSelector::MTP);
+}
+
+void Ut_USBModeSelector::testDisconnectResetsNotifiedState()
+{
+    usbModeSelector->m_usbMode->setCurrentMode(QUsbModed::Mode::MTP);
+    usbModeSelector->handleUSBState();
+
+    QSignalSpy spy(usbModeSelector, SIGNAL(showNotification(USBModeSelector::Notification)));
+    usbModeSelector->handleUSBState();
+    QCOMPARE(spy.count(), 0);
+
+    // Reconnecting in the same mode is notified about
+    usbModeSelector->handleUSBEvent(QUsbModed::Mode::Disconnected);
+    usbModeSelector->handleUSBState();
+    QCOMPARE(spy.count(), 1);
+    QCOMPARE(spy.last().at(0).value<USBModeSelector::Notification>(), USBModeSelector::MTP);
+}
+
+void Ut_USBModeSelector::testModeRequestIsDebounced()
+{
+    QSignalSpy windowSpy(usbModeSelector, SIGNAL(windowVisibleChanged()));
+
+    // The dialog is shown once the state has settled
+    usbModeSelector->handleUSBEvent(QUsbModed::Mode::ModeRequest);
+    QCOMPARE(usbModeSelector->windowVisible(), false);
+    QTRY_COMPARE(usbModeSelector->windowVisible(), true);
+    QCOMPARE(windowSpy.count(), 1);
+
+    usbModeSelector->setWindowVisible(false);
+    windowSpy.clear();
+
+    // A mode selected before the state settles does not map the dialog at all
+    usbModeSelector->handleUSBEvent(QUsbModed::Mode::ModeRequest);
+    usbModeSelector->setMode(QUsbModed::Mode::Busy);
+    usbModeSelector->setMode(QUsbModed::Mode::MTP);
+    QTest::qWait(500);
+    QCOMPARE(usbModeSelector->windowVisible(), false);
+    QCOMPARE(windowSpy.count(), 0);
+}
+
 void Ut_USBModeSelector::testConnectingUSBWhenDeviceIsLockedEmitsDialogShown_data()
 {
     QTest::addColumn<NemoDeviceLock::DeviceLock::LockState>("deviceLocked");
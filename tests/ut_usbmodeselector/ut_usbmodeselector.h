@@ -47,6 +47,9 @@ private slots:
     void testHideDialog();
     void testUSBNotifications_data();
     void testUSBNotifications();
+    void testRapidConnectDisconnect();
+    void testDisconnectResetsNotifiedState();
+    void testModeRequestIsDebounced();
     void testConnectingUSBWhenDeviceIsLockedEmitsDialogShown_data();
     void testConnectingUSBWhenDeviceIsLockedEmitsDialogShown();
     void testSetUSBMode();
@@ -14,7 +14,6 @@ SOURCES += \
 
 HEADERS += \
     $$SRCDIR/usbmodeselector.h \
-    $$UTILITYSRCDIR/closeeventeater.h \
     $$USBMODEDQTINCLUDEDIR/qusbmoded.h \
     $$USBMODEDQTINCLUDEDIR/qusbmode.h \
     $$STUBSDIR/nemo-devicelock/devicelock.h \
@@ -18,7 +18,6 @@
 #include "ut_volumecontrol.h"
 #include "volumecontrol.h"
 #include "pulseaudiocontrol_stub.h"
-#include "closeeventeater_stub.h"
 #include "mgconfitem_stub.h"
 #include "lipstickqmlpath_stub.h"
 
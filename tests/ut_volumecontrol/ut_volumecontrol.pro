@@ -11,7 +11,6 @@ HEADERS += \
     $$3RDPARTYSRCDIR/dbus-gmain/dbus-gmain.h \
     $$VOLUMESRCDIR/volumecontrol.h \
     $$VOLUMESRCDIR/pulseaudiocontrol.h \
-    $$UTILITYSRCDIR/closeeventeater.h \
     $$SRCDIR/homewindow.h \
     $$STUBSDIR/nemo-devicelock/devicelock.h \
     /usr/include/mlite5/mgconfitem.h \
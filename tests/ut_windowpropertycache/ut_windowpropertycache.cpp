@@ -0,0 +1,146 @@
+/***************************************************************************
+**
+** Copyright (c) 2021 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include "ut_windowpropertycache.h"
+#include "windowpropertycache.h"
+
+namespace {
+
+struct Window
+{
+    int id;
+};
+
+typedef WindowPropertyCache<Window> Cache;
+typedef QList<Window *> Windows;
+
+const qint64 Process = 1000;
+const qint64 OtherProcess = 1001;
+
+}
+
+void Ut_WindowPropertyCache::testLinkedWindow()
+{
+    Cache cache;
+    Window window = { 1 };
+    cache.setLink(&window, Process, 42);
+
+    QCOMPARE(cache.linkedWindows(Process, 42), Windows() << &window);
+    QCOMPARE(cache.linkedWindows(Process, 43), Windows());
+
+    // 0 is not a link
+    Window unlinked = { 2 };
+    cache.setLink(&unlinked, Process, 0);
+    QCOMPARE(cache.linkedWindows(Process, 0), Windows());
+}
+
+void Ut_WindowPropertyCache::testLinksAreKeptPerProcess()
+{
+    Cache cache;
+    Window first = { 1 };
+    Window second = { 2 };
+    cache.setLink(&first, Process, 42);
+    cache.setLink(&second, OtherProcess, 42);
+
+    QCOMPARE(cache.linkedWindows(Process, 42), Windows() << &first);
+    QCOMPARE(cache.linkedWindows(OtherProcess, 42), Windows() << &second);
+}
+
+void Ut_WindowPropertyCache::testChangingLink()
+{
+    Cache cache;
+    Window window = { 1 };
+    cache.setLink(&window, Process, 42);
+    cache.setLink(&window, Process, 43);
+
+    QCOMPARE(cache.linkedWindows(Process, 42), Windows());
+    QCOMPARE(cache.linkedWindows(Process, 43), Windows() << &window);
+
+    cache.setLink(&window, Process, 0);
+    QCOMPARE(cache.linkedWindows(Process, 43), Windows());
+}
+
+void Ut_WindowPropertyCache::testDuplicateLinks()
+{
+    Cache cache;
+    Window first = { 1 };
+    Window second = { 2 };
+    cache.setLink(&first, Process, 42);
+    cache.setLink(&second, Process, 42);
+
+    // The most recently linked window first
+    QCOMPARE(cache.linkedWindows(Process, 42), Windows() << &second << &first);
+
+    // Either window is still found after the other one goes away
+    cache.removeWindow(&second);
+    QCOMPARE(cache.linkedWindows(Process, 42), Windows() << &first);
+
+    cache.setLink(&second, Process, 42);
+    cache.removeWindow(&first);
+    QCOMPARE(cache.linkedWindows(Process, 42), Windows() << &second);
+}
+
+void Ut_WindowPropertyCache::testRemoveWindow()
+{
+    Cache cache;
+    Window window = { 1 };
+    cache.setLink(&window, Process, 42);
+    cache.setNotificationPreviewsDisabled(&window, 2);
+    cache.removeWindow(&window);
+
+    QCOMPARE(cache.linkedWindows(Process, 42), Windows());
+    QCOMPARE(cache.notificationPreviewsDisabled(&window, 0), uint(0));
+
+    // Removing an unknown window is harmless
+    cache.removeWindow(&window);
+}
+
+void Ut_WindowPropertyCache::testNotificationPreviewsDisabled_data()
+{
+    QTest::addColumn<QVariant>("value");
+    QTest::addColumn<uint>("mode");
+
+    QTest::newRow("not set") << QVariant() << uint(7);
+    QTest::newRow("enabled") << QVariant(0) << uint(0);
+    QTest::newRow("previews disabled") << QVariant(1) << uint(1);
+    QTest::newRow("all disabled") << QVariant(3) << uint(3);
+    QTest::newRow("string") << QVariant(QString("2")) << uint(2);
+    QTest::newRow("negative") << QVariant(-1) << uint(7);
+    QTest::newRow("not a number") << QVariant(QString("all")) << uint(7);
+}
+
+void Ut_WindowPropertyCache::testNotificationPreviewsDisabled()
+{
+    QFETCH(QVariant, value);
+    QFETCH(uint, mode);
+
+    Cache cache;
+    Window window = { 1 };
+    cache.setNotificationPreviewsDisabled(&window, 1);
+    cache.setNotificationPreviewsDisabled(&window, value);
+
+    QCOMPARE(cache.notificationPreviewsDisabled(&window, 7), mode);
+}
+
+void Ut_WindowPropertyCache::testNotificationPreviewsDisabledUnknownWindow()
+{
+    Cache cache;
+    Window window = { 1 };
+
+    QCOMPARE(cache.notificationPreviewsDisabled(&window, 7), uint(7));
+    QCOMPARE(cache.notificationPreviewsDisabled(0, 7), uint(7));
+}
+
+QTEST_MAIN(Ut_WindowPropertyCache)
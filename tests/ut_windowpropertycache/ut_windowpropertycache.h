@@ -0,0 +1,36 @@
+/***************************************************************************
+**
+** Copyright (c) 2021 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#ifndef UT_WINDOWPROPERTYCACHE_H
+#define UT_WINDOWPROPERTYCACHE_H
+
+#include <QObject>
+
+class Ut_WindowPropertyCache : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    // Test cases
+    void testLinkedWindow();
+    void testLinksAreKeptPerProcess();
+    void testChangingLink();
+    void testDuplicateLinks();
+    void testRemoveWindow();
+    void testNotificationPreviewsDisabled_data();
+    void testNotificationPreviewsDisabled();
+    void testNotificationPreviewsDisabledUnknownWindow();
+};
+
+#endif
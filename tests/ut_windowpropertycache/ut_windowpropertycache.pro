@@ -0,0 +1,12 @@
+include(../common.pri)
+TARGET = ut_windowpropertycache
+INCLUDEPATH += $$COMPOSITORSRCDIR
+
+# unit test
+SOURCES += \
+    ut_windowpropertycache.cpp
+
+# unit test and unit
+HEADERS += \
+    ut_windowpropertycache.h \
+    $$COMPOSITORSRCDIR/windowpropertycache.h
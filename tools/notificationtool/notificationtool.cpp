@@ -15,6 +15,7 @@
 #include "notificationmanager.h"
 #include "notificationmanagerproxy.h"
 #include "lipsticknotification.h"
+#include "stresstest.h"
 
 #include <QPair>
 
@@ -33,7 +34,19 @@ enum ToolOperation {
     Add,
     Update,
     Remove,
-    Purge
+    Purge,
+    Stress
+};
+
+// Long options without a short counterpart
+enum LongOption {
+    RateOption = 256,
+    DurationOption,
+    ClientsOption,
+    MixOption,
+    ImageSizeOption,
+    BodySizeOption,
+    BusOption
 };
 
 // The operation to perform
@@ -73,6 +86,9 @@ QList<QPair<QString, QString> > hints;
 // AppName for the notification
 QString appName;
 
+// Configuration of the stress operation
+StressOptions stressOptions;
+
 // Prints usage information
 int usage(const char *program)
 {
@@ -86,6 +102,7 @@ int usage(const char *program)
     std::cerr << "                             remove - Removes an existing notification." << std::endl;
     std::cerr << "                             list - Print a summary of existing notifications." << std::endl;
     std::cerr << "                             purge - Remove all existing notifications." << std::endl;
+    std::cerr << "                             stress - Generate notification load and report latencies." << std::endl;
     std::cerr << "  -i, --id=ID                The notification ID to use when updating or removing a notification." << std::endl;
     std::cerr << "  -u, --urgency=NUMBER       The urgency to assign to the notification." << std::endl;
     std::cerr << "  -p, --priority=NUMBER      The priority to assign to the notification." << std::endl;
@@ -99,6 +116,17 @@ int usage(const char *program)
     std::cerr << "  -A, --application=NAME     The name to use as identifying the application that owns the notification." << std::endl;
     std::cerr << "      --help                 display this help and exit" << std::endl;
     std::cerr << std::endl;
+    std::cerr << "Options for the 'stress' operation:" << std::endl;
+    std::cerr << "      --rate=NUMBER          Operations per second per client (default 50)." << std::endl;
+    std::cerr << "      --duration=SECONDS     Length of the run (default 10)." << std::endl;
+    std::cerr << "      --clients=NUMBER       Number of concurrent clients, each with its own connection (default 1)." << std::endl;
+    std::cerr << "      --mix=N:R:P:C:A        Relative weights of new, replace, progress update, close and" << std::endl;
+    std::cerr << "                             action-bearing notifications (default 50:20:15:10:5)." << std::endl;
+    std::cerr << "      --image-size=PIXELS    Send image data of PIXELSxPIXELS with new notifications (default none)." << std::endl;
+    std::cerr << "      --body-size=NUMBER     Length of the notification bodies (default 200)." << std::endl;
+    std::cerr << "      --bus=ADDRESS          Use the bus at ADDRESS instead of the session bus, for example a" << std::endl;
+    std::cerr << "                             private bus started with dbus-daemon --session --print-address." << std::endl;
+    std::cerr << std::endl;
     std::cerr << "A notification ID is mandatory when the operation is 'update' or 'remove'." << std::endl;
     std::cerr << "All options other than -o and -i are ignored when the operation is 'remove' or 'purge'." << std::endl;
     return -1;
@@ -123,6 +151,13 @@ int parseArguments(int argc, char *argv[])
             { "hint", required_argument, NULL, 'h' },
             { "application", required_argument, NULL, 'A' },
             { "help", no_argument, NULL, 'H' },
+            { "rate", required_argument, NULL, RateOption },
+            { "duration", required_argument, NULL, DurationOption },
+            { "clients", required_argument, NULL, ClientsOption },
+            { "mix", required_argument, NULL, MixOption },
+            { "image-size", required_argument, NULL, ImageSizeOption },
+            { "body-size", required_argument, NULL, BodySizeOption },
+            { "bus", required_argument, NULL, BusOption },
             { 0, 0, 0, 0 }
         };
 
@@ -143,6 +178,8 @@ int parseArguments(int argc, char *argv[])
                 toolOperation = Remove;
             } else if (strcmp(optarg, "purge") == 0) {
                 toolOperation = Purge;
+            } else if (strcmp(optarg, "stress") == 0) {
+                toolOperation = Stress;
             }
             break;
         case 'i':
@@ -222,6 +259,29 @@ int parseArguments(int argc, char *argv[])
         case 'H':
             return usage(argv[0]);
             break;
+        case RateOption:
+            stressOptions.rate = atoi(optarg);
+            break;
+        case DurationOption:
+            stressOptions.duration = atoi(optarg);
+            break;
+        case ClientsOption:
+            stressOptions.clients = atoi(optarg);
+            break;
+        case MixOption:
+            if (!stressOptions.parseMix(QString::fromUtf8(optarg))) {
+                toolOperation = Undefined;
+            }
+            break;
+        case ImageSizeOption:
+            stressOptions.imageSize = atoi(optarg);
+            break;
+        case BodySizeOption:
+            stressOptions.bodySize = atoi(optarg);
+            break;
+        case BusOption:
+            stressOptions.busAddress = QString::fromUtf8(optarg);
+            break;
         default:
             break;
         }
@@ -233,7 +293,8 @@ int parseArguments(int argc, char *argv[])
             (toolOperation == Update && argc < optind) ||
             (toolOperation == Update && id == 0) ||
             (toolOperation == Remove && id == 0) ||
-            (toolOperation == Purge && id != 0)) {
+            (toolOperation == Purge && id != 0) ||
+            (toolOperation == Stress && (stressOptions.rate <= 0 || stressOptions.duration <= 0 || stressOptions.clients <= 0))) {
         return usage(argv[0]);
     }
     return 0;
@@ -340,6 +401,13 @@ int main(int argc, char *argv[])
             proxy.CloseNotification(id);
         }
         break;
+    case Stress: {
+        StressTest stressTest(stressOptions);
+        QObject::connect(&stressTest, &StressTest::finished, &application, &QCoreApplication::quit);
+        stressTest.start();
+        result = application.exec();
+        break;
+        }
     default:
         break;
     }
@@ -16,10 +16,12 @@ QMAKE_LIBDIR = ../../src
 LIBS = -llipstick-qt5
 
 HEADERS += \
-     notificationmanagerproxy.h
+     notificationmanagerproxy.h \
+     stresstest.h
 SOURCES += \
      notificationtool.cpp \
-     notificationmanagerproxy.cpp
+     notificationmanagerproxy.cpp \
+     stresstest.cpp
 
 QMAKE_CXXFLAGS += \
     -Werror \
@@ -0,0 +1,395 @@
+/***************************************************************************
+**
+** Copyright (c) 2021 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#include "stresstest.h"
+#include "lipsticknotification.h"
+
+#include <QDBusArgument>
+#include <QDBusMessage>
+#include <QDBusPendingCallWatcher>
+#include <QDBusPendingReply>
+#include <QDateTime>
+#include <QStringList>
+
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+
+namespace {
+
+const char * const NotificationsService = "org.freedesktop.Notifications";
+const char * const NotificationsPath = "/org/freedesktop/Notifications";
+const char * const NotificationsInterface = "org.freedesktop.Notifications";
+
+// How often each client lists its notifications
+const int ListInterval = 1000;
+// How long to wait for outstanding replies once the run is over
+const int DrainTimeout = 5000;
+
+const char * const OperationNames[StressOperationCount] = {
+    "new", "replace", "progress", "close", "action", "list"
+};
+
+QVariant createImageData(int size)
+{
+    const int stride = size * 4;
+    QByteArray data(stride * size, '\0');
+    for (int i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<char>(qrand());
+    }
+
+    // Desktop notifications image-data: (iiibiiay)
+    QDBusArgument argument;
+    argument.beginStructure();
+    argument << size << size << stride << true << 8 << 4 << data;
+    argument.endStructure();
+    return QVariant::fromValue(argument);
+}
+
+}
+
+StressOptions::StressOptions()
+    : rate(50)
+    , duration(10)
+    , clients(1)
+    , imageSize(0)
+    , bodySize(200)
+{
+    weights[StressNew] = 50;
+    weights[StressReplace] = 20;
+    weights[StressProgress] = 15;
+    weights[StressClose] = 10;
+    weights[StressAction] = 5;
+}
+
+bool StressOptions::parseMix(const QString &mix)
+{
+    const QStringList parts = mix.split(':');
+    if (parts.count() != StressList) {
+        return false;
+    }
+
+    for (int i = 0; i < StressList; ++i) {
+        bool ok = false;
+        weights[i] = parts.at(i).toInt(&ok);
+        if (!ok || weights[i] < 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void StressStatistics::addSample(StressOperation operation, qint64 nsecs)
+{
+    m_samples[operation].append(nsecs);
+}
+
+void StressStatistics::addError(StressOperation operation)
+{
+    ++m_errors[operation];
+}
+
+void StressStatistics::print() const
+{
+    std::cout << std::left << std::setw(10) << "operation"
+              << std::right << std::setw(8) << "count" << std::setw(8) << "errors"
+              << std::setw(10) << "p50 ms" << std::setw(10) << "p90 ms"
+              << std::setw(10) << "p99 ms" << std::setw(10) << "max ms" << std::endl;
+
+    for (int i = 0; i < StressOperationCount; ++i) {
+        QVector<qint64> samples(m_samples[i]);
+        std::sort(samples.begin(), samples.end());
+
+        std::cout << std::left << std::setw(10) << OperationNames[i]
+                  << std::right << std::setw(8) << samples.count() << std::setw(8) << m_errors[i]
+                  << std::fixed << std::setprecision(2);
+        const double percentiles[] = { 0.5, 0.9, 0.99, 1.0 };
+        for (double percentile : percentiles) {
+            if (samples.isEmpty()) {
+                std::cout << std::setw(10) << "-";
+            } else {
+                const int index = qMin(samples.count() - 1, static_cast<int>(percentile * samples.count()));
+                std::cout << std::setw(10) << samples.at(index) / 1000000.0;
+            }
+        }
+        std::cout << std::endl;
+    }
+}
+
+StressClient::StressClient(int index, const StressOptions &options, StressStatistics *statistics, QObject *parent)
+    : QObject(parent)
+    , m_options(options)
+    , m_statistics(statistics)
+    , m_connection(options.busAddress.isEmpty()
+                   ? QDBusConnection::connectToBus(QDBusConnection::SessionBus, QString("notificationtool-stress-%1").arg(index))
+                   : QDBusConnection::connectToBus(options.busAddress, QString("notificationtool-stress-%1").arg(index)))
+    , m_appName(QString("notificationtool-stress-%1").arg(index))
+    , m_sequence(0)
+    , m_pendingCalls(0)
+{
+    m_generateTimer.setInterval(qMax(1, 1000 / qMax(1, options.rate)));
+    connect(&m_generateTimer, &QTimer::timeout, this, &StressClient::generate);
+    m_listTimer.setInterval(ListInterval);
+    connect(&m_listTimer, &QTimer::timeout, this, &StressClient::list);
+
+    m_connection.connect(NotificationsService, NotificationsPath, NotificationsInterface, "NotificationClosed",
+                         this, SLOT(notificationClosed(uint,uint)));
+
+    if (options.imageSize > 0) {
+        m_imageData = createImageData(options.imageSize);
+    }
+    m_clock.start();
+}
+
+void StressClient::start()
+{
+    if (!m_connection.isConnected()) {
+        std::cerr << "Client " << qPrintable(m_appName) << " could not connect: "
+                  << qPrintable(m_connection.lastError().message()) << std::endl;
+        return;
+    }
+
+    m_generateTimer.start();
+    m_listTimer.start();
+}
+
+void StressClient::stop()
+{
+    m_generateTimer.stop();
+    m_listTimer.stop();
+
+    // Clean up whatever is left without measuring it
+    foreach (uint id, m_liveIds) {
+        QDBusMessage message = QDBusMessage::createMethodCall(NotificationsService, NotificationsPath, NotificationsInterface, "CloseNotification");
+        message << id;
+        m_connection.call(message, QDBus::NoBlock);
+    }
+    m_liveIds.clear();
+
+    if (isIdle()) {
+        emit idle();
+    }
+}
+
+bool StressClient::isIdle() const
+{
+    return m_pendingCalls == 0 && m_closeRequests.isEmpty();
+}
+
+StressOperation StressClient::pickOperation() const
+{
+    int total = 0;
+    for (int i = 0; i < StressList; ++i) {
+        total += m_options.weights[i];
+    }
+    if (total <= 0) {
+        return StressNew;
+    }
+
+    int value = qrand() % total;
+    for (int i = 0; i < StressList; ++i) {
+        if (value < m_options.weights[i]) {
+            return static_cast<StressOperation>(i);
+        }
+        value -= m_options.weights[i];
+    }
+    return StressNew;
+}
+
+void StressClient::generate()
+{
+    StressOperation operation = pickOperation();
+    if (m_liveIds.isEmpty() && (operation == StressReplace || operation == StressProgress || operation == StressClose)) {
+        // Nothing to operate on yet
+        operation = StressNew;
+    }
+
+    switch (operation) {
+    case StressReplace:
+    case StressProgress:
+        notify(operation, m_liveIds.at(qrand() % m_liveIds.count()));
+        break;
+    case StressClose:
+        close(m_liveIds.takeAt(qrand() % m_liveIds.count()));
+        break;
+    default:
+        notify(operation, 0);
+        break;
+    }
+}
+
+void StressClient::notify(StressOperation operation, uint replacesId)
+{
+    const int sequence = ++m_sequence;
+    const QString summary = QString("Stress %1 #%2").arg(m_appName).arg(sequence);
+    QString body = QString("Notification %1 ").arg(sequence);
+    body = body.leftJustified(m_options.bodySize, QChar('x'), true);
+
+    QStringList actions;
+    QVariantHash hints;
+    hints.insert(LipstickNotification::HINT_TIMESTAMP, QDateTime::currentDateTimeUtc().toString(Qt::ISODate));
+    hints.insert(LipstickNotification::HINT_PREVIEW_SUMMARY, summary);
+    hints.insert(LipstickNotification::HINT_PREVIEW_BODY, body.left(80));
+    hints.insert(LipstickNotification::HINT_CATEGORY, QStringLiteral("x-nemo.example"));
+
+    if (operation == StressProgress) {
+        hints.insert(LipstickNotification::HINT_PROGRESS, (sequence % 100) / 100.0);
+    } else if (operation == StressAction) {
+        actions << QStringLiteral("default") << QStringLiteral("Open");
+        hints.insert(QString(LipstickNotification::HINT_REMOTE_ACTION_PREFIX) + QStringLiteral("default"),
+                     QStringLiteral("org.example.Stress / org.example.Stress open"));
+    }
+    if (operation == StressNew && m_imageData.isValid()) {
+        hints.insert(LipstickNotification::HINT_IMAGE_DATA, m_imageData);
+    }
+
+    QDBusMessage message = QDBusMessage::createMethodCall(NotificationsService, NotificationsPath, NotificationsInterface, "Notify");
+    message << m_appName << replacesId << QString() << summary << body << actions << QVariant::fromValue(hints) << -1;
+
+    const qint64 started = m_clock.nsecsElapsed();
+    QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(m_connection.asyncCall(message), this);
+    ++m_pendingCalls;
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, [this, operation, replacesId, started](QDBusPendingCallWatcher *call) {
+        QDBusPendingReply<uint> reply = *call;
+        if (reply.isError()) {
+            m_statistics->addError(operation);
+        } else {
+            m_statistics->addSample(operation, m_clock.nsecsElapsed() - started);
+            if (replacesId == 0 && m_generateTimer.isActive()) {
+                m_liveIds.append(reply.value());
+            }
+        }
+        finishCall(call);
+    });
+}
+
+void StressClient::close(uint id)
+{
+    QDBusMessage message = QDBusMessage::createMethodCall(NotificationsService, NotificationsPath, NotificationsInterface, "CloseNotification");
+    message << id;
+
+    // Latency is measured until the NotificationClosed signal arrives
+    m_closeRequests.insert(id, m_clock.nsecsElapsed());
+    QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(m_connection.asyncCall(message), this);
+    ++m_pendingCalls;
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, [this, id](QDBusPendingCallWatcher *call) {
+        if (call->isError()) {
+            m_statistics->addError(StressClose);
+            m_closeRequests.remove(id);
+        }
+        finishCall(call);
+    });
+}
+
+void StressClient::list()
+{
+    QDBusMessage message = QDBusMessage::createMethodCall(NotificationsService, NotificationsPath, NotificationsInterface, "GetNotifications");
+    message << m_appName;
+
+    const qint64 started = m_clock.nsecsElapsed();
+    QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(m_connection.asyncCall(message), this);
+    ++m_pendingCalls;
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, [this, started](QDBusPendingCallWatcher *call) {
+        if (call->isError()) {
+            m_statistics->addError(StressList);
+        } else {
+            m_statistics->addSample(StressList, m_clock.nsecsElapsed() - started);
+        }
+        finishCall(call);
+    });
+}
+
+void StressClient::notificationClosed(uint id, uint reason)
+{
+    Q_UNUSED(reason)
+
+    QHash<uint, qint64>::iterator it = m_closeRequests.find(id);
+    if (it != m_closeRequests.end()) {
+        m_statistics->addSample(StressClose, m_clock.nsecsElapsed() - it.value());
+        m_closeRequests.erase(it);
+        if (!m_generateTimer.isActive() && isIdle()) {
+            emit idle();
+        }
+    } else {
+        m_liveIds.removeOne(id);
+    }
+}
+
+void StressClient::finishCall(QDBusPendingCallWatcher *watcher)
+{
+    watcher->deleteLater();
+    --m_pendingCalls;
+    if (!m_generateTimer.isActive() && isIdle()) {
+        emit idle();
+    }
+}
+
+StressTest::StressTest(const StressOptions &options, QObject *parent)
+    : QObject(parent)
+    , m_options(options)
+    , m_stopped(false)
+    , m_finished(false)
+{
+}
+
+void StressTest::start()
+{
+    std::cout << "Running " << m_options.clients << " client(s) at " << m_options.rate
+              << " operations/s for " << m_options.duration << " s" << std::endl;
+
+    for (int i = 0; i < m_options.clients; ++i) {
+        StressClient *client = new StressClient(i, m_options, &m_statistics, this);
+        connect(client, &StressClient::idle, this, &StressTest::clientIdle);
+        m_clients.append(client);
+        client->start();
+    }
+
+    QTimer::singleShot(m_options.duration * 1000, this, SLOT(stop()));
+}
+
+void StressTest::stop()
+{
+    if (m_stopped) {
+        std::cerr << "Some replies did not arrive in time" << std::endl;
+        finish();
+        return;
+    }
+
+    m_stopped = true;
+    foreach (StressClient *client, m_clients) {
+        client->stop();
+    }
+    QTimer::singleShot(DrainTimeout, this, SLOT(stop()));
+}
+
+void StressTest::clientIdle()
+{
+    foreach (StressClient *client, m_clients) {
+        if (!client->isIdle()) {
+            return;
+        }
+    }
+    finish();
+}
+
+void StressTest::finish()
+{
+    if (m_finished) {
+        return;
+    }
+
+    m_finished = true;
+    m_statistics.print();
+    emit finished();
+}
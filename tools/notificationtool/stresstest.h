@@ -0,0 +1,141 @@
+/***************************************************************************
+**
+** Copyright (c) 2021 Jolla Ltd.
+**
+** This file is part of lipstick.
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation
+** and appearing in the file LICENSE.LGPL included in the packaging
+** of this file.
+**
+****************************************************************************/
+
+#ifndef STRESSTEST_H
+#define STRESSTEST_H
+
+#include <QDBusConnection>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QObject>
+#include <QTimer>
+#include <QVector>
+
+class QDBusPendingCallWatcher;
+
+// The kinds of operations generated by the stress test
+enum StressOperation {
+    StressNew,
+    StressReplace,
+    StressProgress,
+    StressClose,
+    StressAction,
+    StressList,
+    StressOperationCount
+};
+
+// Configuration of a stress test run
+struct StressOptions
+{
+    StressOptions();
+
+    // Operations per second generated by each client
+    int rate;
+    // Length of the run in seconds
+    int duration;
+    // Number of concurrent clients, each with a connection of its own
+    int clients;
+    // Relative weights of new, replace, progress, close and action operations
+    int weights[StressList];
+    // Width and height of the image data sent with new notifications, 0 for none
+    int imageSize;
+    // Length of the notification bodies in characters
+    int bodySize;
+    // Address of the bus to use, the session bus if empty
+    QString busAddress;
+
+    bool parseMix(const QString &mix);
+};
+
+// Latency samples of the operations, in nanoseconds
+class StressStatistics
+{
+public:
+    void addSample(StressOperation operation, qint64 nsecs);
+    void addError(StressOperation operation);
+    void print() const;
+
+private:
+    QVector<qint64> m_samples[StressOperationCount];
+    int m_errors[StressOperationCount] = {};
+};
+
+// A single notification client generating load
+class StressClient : public QObject
+{
+    Q_OBJECT
+
+public:
+    StressClient(int index, const StressOptions &options, StressStatistics *statistics, QObject *parent = 0);
+
+    void start();
+    void stop();
+    bool isIdle() const;
+
+signals:
+    void idle();
+
+private slots:
+    void generate();
+    void list();
+    void notificationClosed(uint id, uint reason);
+
+private:
+    StressOperation pickOperation() const;
+    void notify(StressOperation operation, uint replacesId);
+    void close(uint id);
+    void finishCall(QDBusPendingCallWatcher *watcher);
+
+    const StressOptions &m_options;
+    StressStatistics *m_statistics;
+    QDBusConnection m_connection;
+    QString m_appName;
+    QTimer m_generateTimer;
+    QTimer m_listTimer;
+    QList<uint> m_liveIds;
+    QHash<uint, qint64> m_closeRequests;
+    QElapsedTimer m_clock;
+    QVariant m_imageData;
+    int m_sequence;
+    int m_pendingCalls;
+};
+
+// Runs the configured number of clients for the configured duration
+class StressTest : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit StressTest(const StressOptions &options, QObject *parent = 0);
+
+    void start();
+
+signals:
+    void finished();
+
+private slots:
+    void stop();
+    void clientIdle();
+
+private:
+    void finish();
+
+    StressOptions m_options;
+    StressStatistics m_statistics;
+    QList<StressClient *> m_clients;
+    bool m_stopped;
+    bool m_finished;
+};
+
+#endif // STRESSTEST_H